@@ -19,6 +19,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "crc.h"
+#include "dma.h"
 #include "usart.h"
 #include "gpio.h"
 
@@ -81,15 +82,37 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
+	/* Entry window to the application starts at reset */
+	BL_VidBootEntryStart();
 
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_USART2_UART_Init();
   MX_USART6_UART_Init();
   MX_CRC_Init();
   /* USER CODE BEGIN 2 */
+	/* Vectors in RAM : interrupts are taken while the flash erases */
+	BL_FLASH_VidInit();
+	/* Memory to CRC DMA for check sums */
+	BL_CRC_VidInit();
+	/* Start background reception of host commands (UART : host baud rate detected from its sync byte) */
+	if(BL_TRANSPORT_LINK_OK != BL_HOST_LINK->Init()){
+#if BL_DEBUG_INFO == DEBUG_INFO_ENABLE
+		Bl_Print_Msg("Host link failed to start \r\n");
+#endif
+	}
+#if BL_CRC_CYCLE_REPORT == BL_CRC_CYCLE_REPORT_ENABLE
+	/* Compare HAL per byte CRC against the direct register paths on start of flash */
+	{
+		Bl_Crc_Cycles loc_crc_cycles;
+		BL_CRC_VidMeasureCycles((const uint8 *)FLASH_BASE , BL_CRC_CYCLE_REPORT_LEN , &loc_crc_cycles);
+		Bl_Print_Msg("CRC cycles for %d bytes : HAL per byte %u , legacy %u , standard %u , dma %u \r\n" , BL_CRC_CYCLE_REPORT_LEN ,
+								 loc_crc_cycles.HalPerByte , loc_crc_cycles.Legacy , loc_crc_cycles.Standard , loc_crc_cycles.Dma);
+	}
+#endif
 
   /* USER CODE END 2 */
 
@@ -0,0 +1,126 @@
+/// \file bl_aes.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief AES-128 CTR on the CRYP processor (direct register access) , data moved by DMA
+/// The processor needs 14 cycles per 16 byte block for AES-128 , a full 4 KB
+/// payload is decrypted in a few microseconds , far below the time the flash
+/// takes to program it. Streams 5 and 6 have no interrupt enabled : completion
+/// is polled from the DMA flags of the output stream.
+
+
+/************Global Includes*************/
+#include "bl_aes.h"
+
+/*********** Macro declerations**********/
+// CRYP control : AES CTR , 128 bit key , 8 bit data (bytes swapped by the processor)
+#define BL_AES_CR_CTR																(CRYP_CR_ALGOMODE_AES_CTR | CRYP_CR_DATATYPE_1)
+
+// DMA2 stream 6 : memory to CRYP , stream 5 : CRYP to memory , word to word , memory increment
+#define BL_AES_DMA_IN_CR														(BL_AES_DMA_CHANNEL | DMA_SxCR_DIR_0 | DMA_SxCR_MINC | DMA_SxCR_PSIZE_1 | DMA_SxCR_MSIZE_1)
+#define BL_AES_DMA_OUT_CR														(BL_AES_DMA_CHANNEL | DMA_SxCR_MINC | DMA_SxCR_PSIZE_1 | DMA_SxCR_MSIZE_1)
+#define BL_AES_DMA_FLAGS														(DMA_HIFCR_CFEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTCIF5 | \
+																							 DMA_HIFCR_CFEIF6 | DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CTEIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTCIF6)
+
+/********* Static Function Prototypes************/
+/*****BL_AES_uint32BigEndian
+**@param[in] data 4 bytes
+**@return word with data[0] in the upper byte (key and IV register order)
+**/
+static uint32 BL_AES_uint32BigEndian(const uint8 *data);
+
+/********* Global Variables Declerations************/
+static const uint8 BL_Aes_Key[BL_AES_KEY_LEN] = BL_AES_KEY;
+static uint8 BL_Aes_Nonce[BL_AES_NONCE_LEN] = {0U};
+static uint32 BL_Aes_Last_Cycles = 0U;								// cycles of last payload
+
+/********* Software Function Definition *******/
+/*****BL_AES_VidSetNonce
+**@param[in] nonce BL_AES_NONCE_LEN bytes
+**/
+void BL_AES_VidSetNonce(const uint8 *nonce)
+{
+	uint8 loc_count = 0U;
+
+	for(loc_count = 0U ; loc_count < BL_AES_NONCE_LEN ; loc_count++)
+	{
+		BL_Aes_Nonce[loc_count] = nonce[loc_count];
+	}
+}
+
+/*****BL_AES_VidCtrCrypt
+**@param[in,out] data word aligned buffer
+**@param[in] blocks number of BL_AES_BLOCK_LEN blocks
+**@param[in] counter block counter of the first block
+**/
+void BL_AES_VidCtrCrypt(uint8 *data , uint32 blocks , uint32 counter)
+{
+	uint32 loc_start = 0U;
+	uint32 loc_words = blocks << 2U;
+
+	/****** cycle counter : trace enable , unlock (Cortex-M7) , start ****/
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->LAR = 0xC5ACCE55U;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	loc_start = DWT->CYCCNT;
+
+	if(0U != loc_words){
+		__HAL_RCC_CRYP_CLK_ENABLE();
+		/****** key , nonce | counter , empty FIFOs. CTR needs no key preparation ****/
+		CRYP->CR = BL_AES_CR_CTR;
+		CRYP->K2LR = BL_AES_uint32BigEndian(&BL_Aes_Key[0U]);
+		CRYP->K2RR = BL_AES_uint32BigEndian(&BL_Aes_Key[4U]);
+		CRYP->K3LR = BL_AES_uint32BigEndian(&BL_Aes_Key[8U]);
+		CRYP->K3RR = BL_AES_uint32BigEndian(&BL_Aes_Key[12U]);
+		CRYP->IV0LR = BL_AES_uint32BigEndian(&BL_Aes_Nonce[0U]);
+		CRYP->IV0RR = BL_AES_uint32BigEndian(&BL_Aes_Nonce[4U]);
+		CRYP->IV1LR = BL_AES_uint32BigEndian(&BL_Aes_Nonce[8U]);
+		CRYP->IV1RR = counter;
+		CRYP->CR |= CRYP_CR_FFLUSH;
+		CRYP->DMACR = CRYP_DMACR_DIEN | CRYP_DMACR_DOEN;
+
+		/****** output stream first , it must be ready for the first block ****/
+		BL_AES_DMA_OUT_STREAM->CR = 0U;
+		BL_AES_DMA_IN_STREAM->CR = 0U;
+		while(0U != ((BL_AES_DMA_OUT_STREAM->CR | BL_AES_DMA_IN_STREAM->CR) & DMA_SxCR_EN))
+		{
+			/****** previous transfer still stopping ****/
+		}
+		DMA2->HIFCR = BL_AES_DMA_FLAGS;
+		BL_AES_DMA_OUT_STREAM->PAR = (uint32)&CRYP->DOUT;
+		BL_AES_DMA_OUT_STREAM->M0AR = (uint32)data;
+		BL_AES_DMA_OUT_STREAM->NDTR = loc_words;
+		BL_AES_DMA_OUT_STREAM->FCR = 0U;
+		BL_AES_DMA_OUT_STREAM->CR = BL_AES_DMA_OUT_CR | DMA_SxCR_EN;
+		BL_AES_DMA_IN_STREAM->PAR = (uint32)&CRYP->DIN;
+		BL_AES_DMA_IN_STREAM->M0AR = (uint32)data;
+		BL_AES_DMA_IN_STREAM->NDTR = loc_words;
+		BL_AES_DMA_IN_STREAM->FCR = 0U;
+		BL_AES_DMA_IN_STREAM->CR = BL_AES_DMA_IN_CR | DMA_SxCR_EN;
+		CRYP->CR |= CRYP_CR_CRYPEN;
+		while(0U == (DMA2->HISR & (DMA_HISR_TCIF5 | DMA_HISR_TEIF5)))
+		{
+			/****** last block leaves the output FIFO ****/
+		}
+		CRYP->CR &= ~CRYP_CR_CRYPEN;
+		CRYP->DMACR = 0U;
+		DMA2->HIFCR = BL_AES_DMA_FLAGS;
+	}
+	BL_Aes_Last_Cycles = DWT->CYCCNT - loc_start;
+}
+
+/*****BL_AES_uint32LastCycles
+**@return DWT cycles of the last BL_AES_VidCtrCrypt call
+**/
+uint32 BL_AES_uint32LastCycles(void)
+{
+	return BL_Aes_Last_Cycles;
+}
+
+/********* Static Function Definitions************/
+/*****BL_AES_uint32BigEndian
+**@param[in] data 4 bytes
+**/
+static uint32 BL_AES_uint32BigEndian(const uint8 *data)
+{
+	return ((uint32)data[0U] << 24U) | ((uint32)data[1U] << 16U) | ((uint32)data[2U] << 8U) | (uint32)data[3U];
+}
@@ -0,0 +1,56 @@
+/// \file bl_aes.h
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief AES-128 CTR on the CRYP processor fed by DMA (DMA2 stream 6 in , stream 5 out) , used to
+///        decrypt write payloads of an encrypted write session before they are programmed.
+
+#ifndef BL_AES_H
+#define BL_AES_H
+/************** Global Includes**************/
+#include "LSTD_TYPES.h"
+#include "main.h"
+
+/*********** Macro declerations**********/
+#define BL_AES_BLOCK_LEN														16U				/* bytes per counter block */
+#define BL_AES_NONCE_LEN														12U				/* IV bytes before the 32 bit block counter */
+#define BL_AES_KEY_LEN															16U
+
+// Image key : product keys come from the file named by BL_KEYS_FILE , kept out of version control
+// (format in bl_keys_template.h)
+#if defined(BL_KEYS_FILE)
+#include BL_KEYS_FILE
+#endif
+#if !defined(BL_AES_KEY)
+#error "BL_AES_KEY missing : define BL_KEYS_FILE , see bl_keys_template.h"
+#endif
+
+// Memory to CRYP and back : CRYP_IN and CRYP_OUT requests of DMA2 , channel 2 , unused by the HAL handles
+#define BL_AES_DMA_IN_STREAM												DMA2_Stream6
+#define BL_AES_DMA_OUT_STREAM												DMA2_Stream5
+#define BL_AES_DMA_CHANNEL													(2U << DMA_SxCR_CHSEL_Pos)
+
+/********* Software Function Prototype*******/
+/*****BL_AES_VidSetNonce
+**@description nonce of the write session , the block counter follows it in the IV
+**@param[in] nonce BL_AES_NONCE_LEN bytes
+**/
+void BL_AES_VidSetNonce(const uint8 *nonce);
+
+/*****BL_AES_VidCtrCrypt
+**@description
+	AES-128 CTR in place (encryption and decryption are the same). Both DMA streams run at once ,
+	the output trails the input by the CRYP FIFO so the buffer can be overwritten. The counter
+	of a block is its flash address / BL_AES_BLOCK_LEN : frames decrypt in any order and a
+	resent frame gets the same key stream.
+**@param[in,out] data word aligned buffer
+**@param[in] blocks number of BL_AES_BLOCK_LEN blocks
+**@param[in] counter block counter of the first block
+**/
+void BL_AES_VidCtrCrypt(uint8 *data , uint32 blocks , uint32 counter);
+
+/*****BL_AES_uint32LastCycles
+**@return DWT cycles of the last BL_AES_VidCtrCrypt call
+**/
+uint32 BL_AES_uint32LastCycles(void);
+
+#endif /*BL_AES_H*/
@@ -0,0 +1,360 @@
+/// \file bl_crc.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Bulk CRC engine on the CRC unit (direct register access)
+/// The unit needs 4 AHB cycles per 32 bit write and stalls the next write
+/// meanwhile , so the legacy convention (one write per byte) costs about
+/// 4-5 cycles per byte and the standard one about 1-2 cycles per byte ,
+/// against roughly 50 cycles per byte for one HAL_CRC_Accumulate call per
+/// byte. BL_CRC_VidMeasureCycles reports the real numbers.
+/// Long ranges run memory to memory on DMA2 stream 0 into the data
+/// register (word writes , standard mode only) : the unit still sets the pace
+/// (about 4 cycles per word , 1 MB in about 5 ms) while the CPU sleeps.
+
+
+/************Global Includes*************/
+#include "bl_crc.h"
+#include "crc.h"
+
+/*********** Macro declerations**********/
+// Control register values : 32 bit polynomial , default polynomial and init value (kept from MX_CRC_Init)
+#define BL_CRC_CR_LEGACY														(0U)
+#define BL_CRC_CR_STANDARD_WORD											(CRC_CR_REV_IN_0 | CRC_CR_REV_IN_1 | CRC_CR_REV_OUT)	/* bit reversal by word */
+#define BL_CRC_CR_STANDARD_BYTE											(CRC_CR_REV_IN_0 | CRC_CR_REV_OUT)										/* bit reversal by byte */
+#define BL_CRC_STANDARD_XOR_OUT											0xFFFFFFFFU
+#define BL_CRC_INIT_VALUE														0xFFFFFFFFU
+
+// DMA2 stream 0 : channel 0 , memory to memory (source on the peripheral port) , word to word , source increment
+#define BL_CRC_DMA_CR																(DMA_SxCR_DIR_1 | DMA_SxCR_PINC | DMA_SxCR_PSIZE_1 | DMA_SxCR_MSIZE_1 | \
+																						 DMA_SxCR_TCIE | DMA_SxCR_TEIE)
+#define BL_CRC_DMA_FCR															(DMA_SxFCR_DMDIS | DMA_SxFCR_FTH_0 | DMA_SxFCR_FTH_1)		/* FIFO , full threshold */
+#define BL_CRC_DMA_FLAGS														(DMA_LIFCR_CFEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CTEIF0 | \
+																						 DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTCIF0)
+
+/********* Static Function Prototypes************/
+/*****BL_CRC_VidAccumulateBytes
+**@description standard convention , one 8 bit write per byte (head and tail of a buffer)
+**@param[in] data pointer to data
+**@param[in] len number of bytes
+**/
+static void BL_CRC_VidAccumulateBytes(const uint8 *data , uint32 len);
+
+/*****BL_CRC_VidDmaStartBlock
+**@description streams the next block (up to BL_CRC_DMA_MAX_WORDS words) of the running range
+**/
+static void BL_CRC_VidDmaStartBlock(void);
+
+/*****BL_CRC_VidDmaFinish
+**@description ends the running range and stores its result
+**@param[in] crc CRC of the whole range
+**/
+static void BL_CRC_VidDmaFinish(uint32 crc);
+
+/*****BL_CRC_VidWaitIdle
+**@description sleeps until a running DMA range is done (SysTick bounds each sleep)
+**/
+static void BL_CRC_VidWaitIdle(void);
+
+/********* Global Variables Declerations************/
+static uint8 BL_Crc_Mode = BL_CRC_MODE_LEGACY;					// negotiated convention
+static volatile uint8 BL_Crc_Dma_Busy = 0U;						// range running on DMA
+static const uint8 *BL_Crc_Dma_Data = NULL;						// whole range , kept for the CPU fallback
+static uint32 BL_Crc_Dma_Len = 0U;
+static const uint8 *BL_Crc_Dma_Next = NULL;						// next word aligned block
+static uint32 BL_Crc_Dma_Words_Left = 0U;						// words not yet handed to the DMA
+static uint32 BL_Crc_Dma_Tail_Len = 0U;							// bytes after the last word
+static volatile uint32 BL_Crc_Range_Result = 0U;			// result of BL_CRC_uint32CalculateRange
+
+/********* Software Function Definition *******/
+/*****BL_CRC_VidInit
+**@description enables the memory to CRC DMA and its interrupt (after MX_CRC_Init)
+**/
+void BL_CRC_VidInit(void)
+{
+	__HAL_RCC_DMA2_CLK_ENABLE();
+	HAL_NVIC_SetPriority(BL_CRC_DMA_IRQ , 0 , 0);
+	HAL_NVIC_EnableIRQ(BL_CRC_DMA_IRQ);
+}
+
+/*****BL_CRC_VidSetMode
+**@param[in] crc_mode BL_CRC_MODE_LEGACY or BL_CRC_MODE_STANDARD
+**/
+void BL_CRC_VidSetMode(uint8 crc_mode)
+{
+	BL_CRC_VidWaitIdle();
+	BL_Crc_Mode = (BL_CRC_MODE_STANDARD == crc_mode) ? BL_CRC_MODE_STANDARD : BL_CRC_MODE_LEGACY;
+}
+
+/*****BL_CRC_uint8GetMode
+**@return BL_CRC_MODE_xx in use
+**/
+uint8 BL_CRC_uint8GetMode(void)
+{
+	return BL_Crc_Mode;
+}
+
+/*****BL_CRC_VidStart
+**@description resets the CRC unit and configures it for the selected convention
+**/
+void BL_CRC_VidStart(void)
+{
+	BL_CRC_VidWaitIdle();
+	CRC->CR = (BL_CRC_MODE_STANDARD == BL_Crc_Mode) ? BL_CRC_CR_STANDARD_WORD : BL_CRC_CR_LEGACY;
+	CRC->CR |= CRC_CR_RESET;
+}
+
+/*****BL_CRC_VidResume
+**@param[in] crc result of BL_CRC_uint32Finish of the previous part (same convention)
+**/
+void BL_CRC_VidResume(uint32 crc)
+{
+	BL_CRC_VidWaitIdle();
+	/****** reset loads INIT : the unit register holds the output before reversal and final xor ****/
+	if(BL_CRC_MODE_STANDARD == BL_Crc_Mode){
+		CRC->CR = BL_CRC_CR_STANDARD_WORD;
+		CRC->INIT = __RBIT(crc ^ BL_CRC_STANDARD_XOR_OUT);
+	}else{
+		CRC->CR = BL_CRC_CR_LEGACY;
+		CRC->INIT = crc;
+	}
+	CRC->CR |= CRC_CR_RESET;
+	CRC->INIT = BL_CRC_INIT_VALUE;
+}
+
+/*****BL_CRC_VidAccumulate
+**@param[in] data pointer to data (any alignment)
+**@param[in] len number of bytes
+**/
+void BL_CRC_VidAccumulate(const uint8 *data , uint32 len)
+{
+	uint32 loc_head = 0U;
+	uint32 loc_words = 0U;
+	const uint32 *loc_word_ptr = NULL;
+
+	if(BL_CRC_MODE_LEGACY == BL_Crc_Mode){
+		/****** host convention : every byte is a whole word for the unit ****/
+		while(len >= 4U)
+		{
+			CRC->DR = (uint32)data[0U];
+			CRC->DR = (uint32)data[1U];
+			CRC->DR = (uint32)data[2U];
+			CRC->DR = (uint32)data[3U];
+			data = &data[4U];
+			len -= 4U;
+		}
+		while(len > 0U)
+		{
+			CRC->DR = (uint32)*data;
+			data++;
+			len--;
+		}
+	}else{
+		/****** bytes up to a word boundary , then words , then the tail ****/
+		loc_head = (4U - ((uint32)data & 3U)) & 3U;
+		if(loc_head > len){
+			loc_head = len;
+		}
+		BL_CRC_VidAccumulateBytes(data , loc_head);
+		data = &data[loc_head];
+		len -= loc_head;
+		loc_word_ptr = (const uint32 *)data;
+		for(loc_words = len >> 2U ; loc_words > 0U ; loc_words--)
+		{
+			CRC->DR = *loc_word_ptr;
+			loc_word_ptr++;
+		}
+		BL_CRC_VidAccumulateBytes((const uint8 *)loc_word_ptr , len & 3U);
+	}
+}
+
+/*****BL_CRC_uint32Finish
+**@return CRC of everything accumulated since BL_CRC_VidStart
+**/
+uint32 BL_CRC_uint32Finish(void)
+{
+	uint32 loc_crc = CRC->DR;
+	if(BL_CRC_MODE_STANDARD == BL_Crc_Mode){
+		loc_crc ^= BL_CRC_STANDARD_XOR_OUT;
+	}
+	return loc_crc;
+}
+
+/*****BL_CRC_uint32Calculate
+**@param[in] data pointer to data (any alignment)
+**@param[in] len number of bytes
+**@return CRC of data
+**/
+uint32 BL_CRC_uint32Calculate(const uint8 *data , uint32 len)
+{
+	BL_CRC_VidStart();
+	BL_CRC_VidAccumulate(data , len);
+	return BL_CRC_uint32Finish();
+}
+
+/*****BL_CRC_uint32CalculateRange
+**@param[in] address start address
+**@param[in] len number of bytes
+**@return CRC of range
+**/
+uint32 BL_CRC_uint32CalculateRange(uint32 address , uint32 len)
+{
+	const uint8 *loc_data = (const uint8 *)address;
+	uint32 loc_head = 0U;
+
+	BL_CRC_VidWaitIdle();
+	if((BL_CRC_MODE_LEGACY == BL_Crc_Mode) || (len < BL_CRC_DMA_MIN_LEN)){
+		/****** the DMA can't zero extend bytes to words , short ranges don't pay the set up ****/
+		BL_Crc_Range_Result = BL_CRC_uint32Calculate(loc_data , len);
+	}else{
+		loc_head = (4U - (address & 3U)) & 3U;
+		BL_Crc_Dma_Data = loc_data;
+		BL_Crc_Dma_Len = len;
+		BL_Crc_Dma_Next = &loc_data[loc_head];
+		BL_Crc_Dma_Words_Left = (len - loc_head) >> 2U;
+		BL_Crc_Dma_Tail_Len = (len - loc_head) & 3U;
+		BL_Crc_Dma_Busy = 1U;
+		/****** unaligned head on the CPU , words by DMA , tail in the interrupt ****/
+		CRC->CR = BL_CRC_CR_STANDARD_WORD;
+		CRC->CR |= CRC_CR_RESET;
+		BL_CRC_VidAccumulateBytes(loc_data , loc_head);
+		BL_CRC_VidDmaStartBlock();
+		BL_CRC_VidWaitIdle();
+	}
+	return BL_Crc_Range_Result;
+}
+
+/*****BL_CRC_VidDmaIRQ
+**@description DMA2 stream 0 interrupt : chains next block or finishes the calculation
+**/
+void BL_CRC_VidDmaIRQ(void)
+{
+	uint32 loc_flags = DMA2->LISR;
+
+	DMA2->LIFCR = BL_CRC_DMA_FLAGS;
+	if(0U != (loc_flags & DMA_LISR_TEIF0)){
+		/****** bus error : whole range again on the CPU ****/
+		CRC->CR = BL_CRC_CR_STANDARD_WORD;
+		CRC->CR |= CRC_CR_RESET;
+		BL_CRC_VidAccumulate(BL_Crc_Dma_Data , BL_Crc_Dma_Len);
+		BL_CRC_VidDmaFinish(BL_CRC_uint32Finish());
+	}else if(0U != (loc_flags & DMA_LISR_TCIF0)){
+		if(BL_Crc_Dma_Words_Left > 0U){
+			BL_CRC_VidDmaStartBlock();
+		}else{
+			BL_CRC_VidAccumulateBytes(BL_Crc_Dma_Next , BL_Crc_Dma_Tail_Len);
+			BL_CRC_VidDmaFinish(BL_CRC_uint32Finish());
+		}
+	}else{
+		/****** nothing of ours ****/
+	}
+}
+
+/*****BL_CRC_VidMeasureCycles
+**@param[in] data pointer to data
+**@param[in] len number of bytes
+**@param[out] cycles measured cycles
+**/
+void BL_CRC_VidMeasureCycles(const uint8 *data , uint32 len , Bl_Crc_Cycles *cycles)
+{
+	uint8 loc_mode = BL_Crc_Mode;
+	uint32 loc_data = 0U;
+	uint32 loc_count = 0U;
+	uint32 loc_start = 0U;
+
+	/****** cycle counter : trace enable , unlock (Cortex-M7) , start ****/
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->LAR = 0xC5ACCE55U;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	/****** previous implementation : one HAL call per byte ****/
+	loc_start = DWT->CYCCNT;
+	for(loc_count = 0U ; loc_count < len ; loc_count++)
+	{
+		loc_data = (uint32)data[loc_count];
+		(void)HAL_CRC_Accumulate(&hcrc , &loc_data , 1U);
+	}
+	__HAL_CRC_DR_RESET(&hcrc);
+	cycles->HalPerByte = DWT->CYCCNT - loc_start;
+
+	BL_Crc_Mode = BL_CRC_MODE_LEGACY;
+	loc_start = DWT->CYCCNT;
+	(void)BL_CRC_uint32Calculate(data , len);
+	cycles->Legacy = DWT->CYCCNT - loc_start;
+
+	BL_Crc_Mode = BL_CRC_MODE_STANDARD;
+	loc_start = DWT->CYCCNT;
+	(void)BL_CRC_uint32Calculate(data , len);
+	cycles->Standard = DWT->CYCCNT - loc_start;
+
+	loc_start = DWT->CYCCNT;
+	(void)BL_CRC_uint32CalculateRange((uint32)data , len);
+	cycles->Dma = DWT->CYCCNT - loc_start;
+
+	/****** HAL handle expects the reset configuration ****/
+	BL_Crc_Mode = loc_mode;
+	CRC->CR = BL_CRC_CR_LEGACY | CRC_CR_RESET;
+}
+
+/********* Static Function Definitions************/
+/*****BL_CRC_VidAccumulateBytes
+**@param[in] data pointer to data
+**@param[in] len number of bytes
+**/
+static void BL_CRC_VidAccumulateBytes(const uint8 *data , uint32 len)
+{
+	if(len > 0U){
+		CRC->CR = BL_CRC_CR_STANDARD_BYTE;
+		while(len > 0U)
+		{
+			*((volatile uint8 *)&CRC->DR) = *data;
+			data++;
+			len--;
+		}
+		/****** back to word reversal , CR write keeps the running value ****/
+		CRC->CR = BL_CRC_CR_STANDARD_WORD;
+	}
+}
+
+/*****BL_CRC_VidDmaStartBlock
+**@description streams the next block (up to BL_CRC_DMA_MAX_WORDS words) of the running range
+**/
+static void BL_CRC_VidDmaStartBlock(void)
+{
+	uint32 loc_words = (BL_Crc_Dma_Words_Left > BL_CRC_DMA_MAX_WORDS) ? BL_CRC_DMA_MAX_WORDS : BL_Crc_Dma_Words_Left;
+
+	BL_CRC_DMA_STREAM->CR = 0U;
+	while(0U != (BL_CRC_DMA_STREAM->CR & DMA_SxCR_EN))
+	{
+		/****** stream disables after the last transfer ****/
+	}
+	DMA2->LIFCR = BL_CRC_DMA_FLAGS;
+	BL_CRC_DMA_STREAM->PAR = (uint32)BL_Crc_Dma_Next;
+	BL_CRC_DMA_STREAM->M0AR = (uint32)&CRC->DR;
+	BL_CRC_DMA_STREAM->NDTR = loc_words;
+	BL_CRC_DMA_STREAM->FCR = BL_CRC_DMA_FCR;
+	BL_Crc_Dma_Next = &BL_Crc_Dma_Next[loc_words << 2U];
+	BL_Crc_Dma_Words_Left -= loc_words;
+	BL_CRC_DMA_STREAM->CR = BL_CRC_DMA_CR | DMA_SxCR_EN;
+}
+
+/*****BL_CRC_VidDmaFinish
+**@param[in] crc CRC of the whole range
+**/
+static void BL_CRC_VidDmaFinish(uint32 crc)
+{
+	BL_CRC_DMA_STREAM->CR = 0U;
+	BL_Crc_Range_Result = crc;
+	BL_Crc_Dma_Busy = 0U;
+}
+
+/*****BL_CRC_VidWaitIdle
+**@description sleeps until a running DMA range is done (SysTick bounds each sleep)
+**/
+static void BL_CRC_VidWaitIdle(void)
+{
+	while(0U != BL_Crc_Dma_Busy)
+	{
+		__WFI();
+	}
+}
+
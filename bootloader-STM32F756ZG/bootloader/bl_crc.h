@@ -0,0 +1,120 @@
+/// \file bl_crc.h
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Bulk CRC engine : feeds the CRC unit through its data register instead of one HAL call
+///        per byte. Two conventions , the legacy one of the host script and standard CRC-32
+///        (IEEE 802.3 , same as zlib) which the host may negotiate for word wide computation.
+///        Long standard mode ranges are streamed by DMA into the CRC unit while the CPU sleeps.
+
+#ifndef BL_CRC_H
+#define BL_CRC_H
+/************** Global Includes**************/
+#include "LSTD_TYPES.h"
+#include "main.h"
+
+/*********** Macro declerations**********/
+// CRC conventions (poly 0x04C11DB7 , init 0xFFFFFFFF for both)
+#define BL_CRC_MODE_LEGACY													0x00			/* every byte fed as one 32 bit word , no reflection , no final xor */
+#define BL_CRC_MODE_STANDARD												0x01			/* byte stream , reflected in/out , final xor 0xFFFFFFFF */
+
+// Memory to CRC transfer : DMA2 (only DMA2 does memory to memory) , one word per transfer
+#define BL_CRC_DMA_STREAM														DMA2_Stream0
+#define BL_CRC_DMA_IRQ															DMA2_Stream0_IRQn
+#define BL_CRC_DMA_MAX_WORDS												65535U		/* NDTR limit , longer ranges are chained in the interrupt */
+#define BL_CRC_DMA_MIN_LEN													256U			/* shorter ranges are faster on the CPU */
+
+// Cycle report at start up (debug UART) : HAL per byte loop against both direct paths
+#define BL_CRC_CYCLE_REPORT_DISABLE									0
+#define BL_CRC_CYCLE_REPORT_ENABLE									1
+#define BL_CRC_CYCLE_REPORT													(BL_CRC_CYCLE_REPORT_DISABLE)
+#define BL_CRC_CYCLE_REPORT_LEN											4096U			/* bytes of flash measured */
+
+/*********** Data Type Declerations*****/
+/* DWT cycles of one CRC computation over the same data */
+typedef struct tagS__Bl_Crc_Cycles{
+	uint32	HalPerByte;					// HAL_CRC_Accumulate called once per byte (previous implementation)
+	uint32	Legacy;							// BL_CRC_MODE_LEGACY , direct data register writes
+	uint32	Standard;						// BL_CRC_MODE_STANDARD , one write per word
+	uint32	Dma;								// BL_CRC_MODE_STANDARD , DMA into the data register (BL_CRC_uint32CalculateRange)
+}Bl_Crc_Cycles;
+
+/********* Software Function Prototype*******/
+/*****BL_CRC_VidInit
+**@description enables the memory to CRC DMA and its interrupt (after MX_CRC_Init)
+**/
+void BL_CRC_VidInit(void);
+
+/*****BL_CRC_VidSetMode
+**@description
+	Selects the convention of all following computations (frame check , check sums).
+**@param[in] crc_mode BL_CRC_MODE_LEGACY or BL_CRC_MODE_STANDARD
+**/
+void BL_CRC_VidSetMode(uint8 crc_mode);
+
+/*****BL_CRC_uint8GetMode
+**@return BL_CRC_MODE_xx in use
+**/
+uint8 BL_CRC_uint8GetMode(void);
+
+/*****BL_CRC_VidStart
+**@description
+	Resets the CRC unit and configures it for the selected convention , waits for a running
+	DMA calculation first (the unit is shared).
+**/
+void BL_CRC_VidStart(void);
+
+/*****BL_CRC_VidResume
+**@description
+	Like BL_CRC_VidStart , but continues a computation whose result is known : accumulating
+	more data then gives the CRC of the concatenation (running digests across frames).
+**@param[in] crc result of BL_CRC_uint32Finish of the previous part (same convention)
+**/
+void BL_CRC_VidResume(uint32 crc);
+
+/*****BL_CRC_VidAccumulate
+**@param[in] data pointer to data (any alignment)
+**@param[in] len number of bytes
+**/
+void BL_CRC_VidAccumulate(const uint8 *data , uint32 len);
+
+/*****BL_CRC_uint32Finish
+**@return CRC of everything accumulated since BL_CRC_VidStart
+**/
+uint32 BL_CRC_uint32Finish(void);
+
+/*****BL_CRC_uint32Calculate
+**@description start , accumulate and finish in one call
+**@param[in] data pointer to data (any alignment)
+**@param[in] len number of bytes
+**@return CRC of data
+**/
+uint32 BL_CRC_uint32Calculate(const uint8 *data , uint32 len);
+
+/*****BL_CRC_uint32CalculateRange
+**@description
+	CRC of a memory range , sleeps until it is done. Backend of the check sum commands.
+	Standard mode ranges are streamed by DMA , unaligned head and tail bytes are fed by the CPU.
+	Legacy mode (one word per byte can't be produced by DMA) and short ranges are calculated
+	on the CPU.
+**@param[in] address start address
+**@param[in] len number of bytes
+**@return CRC of range
+**/
+uint32 BL_CRC_uint32CalculateRange(uint32 address , uint32 len);
+
+/*****BL_CRC_VidDmaIRQ
+**@description DMA2 stream 0 interrupt : chains next block or finishes the calculation
+**/
+void BL_CRC_VidDmaIRQ(void);
+
+/*****BL_CRC_VidMeasureCycles
+**@description
+	Measures the cycles of the previous HAL per byte loop , of both direct paths and of the DMA
+	path with the DWT cycle counter. Leaves the selected mode unchanged.
+**@param[in] data pointer to data
+**@param[in] len number of bytes
+**@param[out] cycles measured cycles
+**/
+void BL_CRC_VidMeasureCycles(const uint8 *data , uint32 len , Bl_Crc_Cycles *cycles);
+
+#endif /*BL_CRC_H*/
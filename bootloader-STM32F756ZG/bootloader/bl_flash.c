@@ -0,0 +1,463 @@
+/// \file bl_flash.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Flash programming with selectable parallelism
+/// A program operation takes about the same time for every PSIZE , so a word costs
+/// what a byte costs : range 3 writes four times the data per operation. Head and
+/// tail of an unaligned range fall back to bytes. HAL_FLASH_Program takes the HAL
+/// lock , checks its parameters , waits for the last operation and sets PG and PSIZE
+/// again for every unit : the stream path sets them once and writes the units from
+/// a register loop. Time is taken from the DWT cycle counter per path and program type.
+/// Reflashing a mostly unchanged image , or the 0xFF padding of an image over erased
+/// flash , leaves most units as they are : a unit is compared before it is programmed.
+/// A read of the flash stalls while it erases or programs. This file is linked into ITCM
+/// and the vector table is copied to RAM , so the core and the interrupts keep running
+/// during an erase and the caller's idle work (host reception) goes on.
+
+
+/************Global Includes*************/
+#include <string.h>
+#include "bl_flash.h"
+
+/*********** Macro declerations**********/
+#define BL_FLASH_SR_ERRORS													(FLASH_SR_OPERR | FLASH_SR_WRPERR | FLASH_SR_PGAERR | FLASH_SR_PGPERR | FLASH_SR_ERSERR)
+#define BL_FLASH_CR_PSIZE(type)											((uint32)(type) << FLASH_CR_PSIZE_Pos)
+#define BL_FLASH_CR_OPERATIONS											(FLASH_CR_PG | FLASH_CR_SER | FLASH_CR_MER | FLASH_CR_SNB)
+
+// Vector table copy : system exceptions + device interrupts , VTOR alignment is the next power of two
+#define BL_FLASH_VECTOR_COUNT												(16U + (uint32)SPDIF_RX_IRQn + 1U)
+#define BL_FLASH_VECTOR_ALIGN												512U
+
+/********* Static Function Prototypes************/
+/*****BL_FLASH_uint8ProgramUnits
+**@param[in] type program type of every unit
+**@param[in] address destination (aligned to the unit)
+**@param[in] data source bytes
+**@param[in] count number of units
+**/
+static uint8 BL_FLASH_uint8ProgramUnits(uint8 type , uint32 address , const uint8 *data , uint32 count);
+
+/*****BL_FLASH_uint8StreamUnits
+**@param[in] type program type of every unit
+**@param[in] address destination (aligned to the unit)
+**@param[in] data source bytes
+**@param[in] count number of units
+**/
+static uint8 BL_FLASH_uint8StreamUnits(uint8 type , uint32 address , const uint8 *data , uint32 count);
+
+/*****BL_FLASH_uint8Split
+**@param[in] path BL_FLASH_PATH_xx
+**@param[in] address destination
+**@param[in] data source bytes
+**@param[in] len number of bytes
+**/
+static uint8 BL_FLASH_uint8Split(uint8 path , uint32 address , const uint8 *data , uint32 len);
+
+/*****BL_FLASH_uint8Matches
+**@param[in] address destination
+**@param[in] data source bytes
+**@param[in] width unit bytes
+**@return 1 when compare before program is enabled and flash already holds the unit
+**/
+static uint8 BL_FLASH_uint8Matches(uint32 address , const uint8 *data , uint32 width);
+
+/*****BL_FLASH_uint8EraseStep
+**@param[in] operation FLASH_CR_MER , or FLASH_CR_SER with the sector number
+**@param[in] idle work done while the flash is busy (NULL -> wait)
+**@return HAL_OK or HAL_ERROR
+**/
+static uint8 BL_FLASH_uint8EraseStep(uint32 operation , Bl_Flash_Idle idle);
+
+/*****BL_FLASH_uint32Idle
+**@return flash status register once the last operation is done
+**/
+static uint32 BL_FLASH_uint32Idle(void);
+
+/*****BL_FLASH_VidCycleCounter
+**@description trace enable , unlock (Cortex-M7) , start of the DWT cycle counter
+**/
+static void BL_FLASH_VidCycleCounter(void);
+
+/********* Global Variables Declerations************/
+static uint32 BL_Flash_Bytes[BL_FLASH_PATHS][BL_FLASH_PROGRAM_TYPES];
+static uint64 BL_Flash_Cycles[BL_FLASH_PATHS][BL_FLASH_PROGRAM_TYPES];
+static uint32 BL_Flash_Skipped = 0U;									// bytes not programmed , already in flash
+static uint32 BL_Flash_Last_Programmed = 0U;					// bytes programmed by last range
+static uint32 BL_Flash_Vectors[BL_FLASH_VECTOR_COUNT] __attribute__((aligned(BL_FLASH_VECTOR_ALIGN)));
+static uint32 BL_Flash_Boot_Vtor = 0U;								// VTOR before BL_FLASH_VidInit
+
+/********* Software Function Definition *******/
+/*****BL_FLASH_VidInit
+**/
+void BL_FLASH_VidInit(void)
+{
+	const uint32 *loc_vectors = (const uint32 *)SCB->VTOR;
+	uint32 loc_index = 0U;
+
+	for(loc_index = 0U ; loc_index < BL_FLASH_VECTOR_COUNT ; loc_index++)
+	{
+		BL_Flash_Vectors[loc_index] = loc_vectors[loc_index];
+	}
+	BL_Flash_Boot_Vtor = SCB->VTOR;
+	__DSB();
+	SCB->VTOR = (uint32)BL_Flash_Vectors;
+	__DSB();
+	__ISB();
+	BL_FLASH_VidCycleCounter();
+}
+
+/*****BL_FLASH_VidDeInit
+**/
+void BL_FLASH_VidDeInit(void)
+{
+	if((uint32)BL_Flash_Vectors == SCB->VTOR){
+		SCB->VTOR = BL_Flash_Boot_Vtor;
+		__DSB();
+		__ISB();
+	}
+}
+
+/*****BL_FLASH_uint8Program
+**@param[in] address destination
+**@param[in] data source bytes
+**@param[in] len number of bytes
+**/
+uint8 BL_FLASH_uint8Program(uint32 address , const uint8 *data , uint32 len)
+{
+	BL_FLASH_VidCycleCounter();
+	return BL_FLASH_uint8Split(BL_FLASH_PATH_HAL , address , data , len);
+}
+
+/*****BL_FLASH_uint8Begin
+**/
+uint8 BL_FLASH_uint8Begin(void)
+{
+	uint8 loc_status = HAL_OK;
+
+	if(FLASH_CR_PG != (FLASH->CR & (FLASH_CR_LOCK | FLASH_CR_PG))){
+		loc_status = HAL_FLASH_Unlock();
+		if(HAL_OK == loc_status){
+			(void)BL_FLASH_uint32Idle();
+			FLASH->SR = BL_FLASH_SR_ERRORS | FLASH_SR_EOP;
+			FLASH->CR = (FLASH->CR & ~(FLASH_CR_PSIZE | FLASH_CR_SER | FLASH_CR_MER | FLASH_CR_SNB)) |
+				BL_FLASH_CR_PSIZE(BL_FLASH_PROGRAM_TYPE) | FLASH_CR_PG;
+		}
+	}
+	return loc_status;
+}
+
+/*****BL_FLASH_uint8ProgramBuffer
+**@param[in] address destination
+**@param[in] data source bytes
+**@param[in] len number of bytes
+**/
+uint8 BL_FLASH_uint8ProgramBuffer(uint32 address , const uint8 *data , uint32 len)
+{
+	uint8 loc_status = HAL_ERROR;
+
+	if(FLASH_CR_PG == (FLASH->CR & (FLASH_CR_LOCK | FLASH_CR_PG))){
+		BL_FLASH_VidCycleCounter();
+		loc_status = BL_FLASH_uint8Split(BL_FLASH_PATH_STREAM , address , data , len);
+	}
+	return loc_status;
+}
+
+/*****BL_FLASH_uint8End
+**/
+uint8 BL_FLASH_uint8End(void)
+{
+	uint8 loc_status = HAL_OK;
+
+	if(0U != (BL_FLASH_uint32Idle() & BL_FLASH_SR_ERRORS)){
+		loc_status = HAL_ERROR;
+	}
+	FLASH->SR = BL_FLASH_SR_ERRORS | FLASH_SR_EOP;
+	FLASH->CR &= ~FLASH_CR_PG;
+	(void)HAL_FLASH_Lock();
+	return loc_status;
+}
+
+/*****BL_FLASH_uint8Erase
+**@param[in] sector first sector or BL_FLASH_ERASE_MASS
+**@param[in] count number of sectors
+**@param[in] idle work done while the flash is busy
+**/
+uint8 BL_FLASH_uint8Erase(uint8 sector , uint8 count , Bl_Flash_Idle idle)
+{
+	uint8 loc_status = HAL_OK;
+	uint8 loc_count = 0U;
+
+	/****** PG of an open write stream must not stay set with SER ****/
+	(void)BL_FLASH_uint8End();
+	if(HAL_OK != HAL_FLASH_Unlock()){
+		loc_status = HAL_ERROR;
+	}else if(BL_FLASH_ERASE_MASS == sector){
+		loc_status = BL_FLASH_uint8EraseStep(FLASH_CR_MER , idle);
+	}else{
+		for(loc_count = 0U ; (loc_count < count) && (HAL_OK == loc_status) ; loc_count++)
+		{
+			loc_status = BL_FLASH_uint8EraseStep(FLASH_CR_SER | ((uint32)(sector + loc_count) << FLASH_CR_SNB_Pos) , idle);
+		}
+	}
+	(void)HAL_FLASH_Lock();
+	return loc_status;
+}
+
+/*****BL_FLASH_uint32LastProgrammed
+**/
+uint32 BL_FLASH_uint32LastProgrammed(void)
+{
+	return BL_Flash_Last_Programmed;
+}
+
+/*****BL_FLASH_uint32Skipped
+**/
+uint32 BL_FLASH_uint32Skipped(void)
+{
+	return BL_Flash_Skipped;
+}
+
+/*****BL_FLASH_uint32Bytes
+**@param[in] path program path
+**@param[in] type program type
+**/
+uint32 BL_FLASH_uint32Bytes(uint8 path , uint8 type)
+{
+	return ((path < BL_FLASH_PATHS) && (type < BL_FLASH_PROGRAM_TYPES)) ? BL_Flash_Bytes[path][type] : 0U;
+}
+
+/*****BL_FLASH_uint32BytesPerSecond
+**@param[in] path program path
+**@param[in] type program type
+**/
+uint32 BL_FLASH_uint32BytesPerSecond(uint8 path , uint8 type)
+{
+	uint32 loc_rate = 0U;
+
+	if((path < BL_FLASH_PATHS) && (type < BL_FLASH_PROGRAM_TYPES) && (0U != BL_Flash_Cycles[path][type])){
+		loc_rate = (uint32)(((uint64)BL_Flash_Bytes[path][type] * SystemCoreClock) / BL_Flash_Cycles[path][type]);
+	}
+	return loc_rate;
+}
+
+/*****BL_FLASH_uint32UnitCycles
+**@param[in] path program path
+**@param[in] type program type
+**/
+uint32 BL_FLASH_uint32UnitCycles(uint8 path , uint8 type)
+{
+	uint32 loc_cycles = 0U;
+
+	if((path < BL_FLASH_PATHS) && (type < BL_FLASH_PROGRAM_TYPES) && (0U != BL_Flash_Bytes[path][type])){
+		loc_cycles = (uint32)(BL_Flash_Cycles[path][type] / (BL_Flash_Bytes[path][type] >> type));
+	}
+	return loc_cycles;
+}
+
+/*****BL_FLASH_VidStatsReset
+**/
+void BL_FLASH_VidStatsReset(void)
+{
+	memset(BL_Flash_Bytes , 0 , sizeof(BL_Flash_Bytes));
+	memset(BL_Flash_Cycles , 0 , sizeof(BL_Flash_Cycles));
+	BL_Flash_Skipped = 0U;
+}
+
+/********* Static Function Definitions************/
+/*****BL_FLASH_uint8Split
+**@param[in] path BL_FLASH_PATH_xx
+**@param[in] address destination
+**@param[in] data source bytes
+**@param[in] len number of bytes
+**/
+static uint8 BL_FLASH_uint8Split(uint8 path , uint32 address , const uint8 *data , uint32 len)
+{
+	uint8 (*loc_units)(uint8 type , uint32 address , const uint8 *data , uint32 count) =
+		(BL_FLASH_PATH_STREAM == path) ? BL_FLASH_uint8StreamUnits : BL_FLASH_uint8ProgramUnits;
+	uint8 loc_status = HAL_OK;
+	uint32 loc_head = (BL_FLASH_PROGRAM_UNIT - (address & (BL_FLASH_PROGRAM_UNIT - 1UL))) & (BL_FLASH_PROGRAM_UNIT - 1UL);
+	uint32 loc_count = 0U;
+
+	BL_Flash_Last_Programmed = 0U;
+	if(loc_head > len){
+		loc_head = len;
+	}
+	loc_count = (len - loc_head) / BL_FLASH_PROGRAM_UNIT;
+	/****** head bytes up to the unit boundary ****/
+	loc_status = loc_units(FLASH_TYPEPROGRAM_BYTE , address , data , loc_head);
+	if(HAL_OK == loc_status){
+		loc_status = loc_units(BL_FLASH_PROGRAM_TYPE , address + loc_head , &data[loc_head] , loc_count);
+	}
+	if(HAL_OK == loc_status){
+		/****** tail bytes after the last whole unit ****/
+		loc_head += loc_count * BL_FLASH_PROGRAM_UNIT;
+		loc_status = loc_units(FLASH_TYPEPROGRAM_BYTE , address + loc_head , &data[loc_head] , len - loc_head);
+	}
+	return loc_status;
+}
+
+/*****BL_FLASH_uint8ProgramUnits
+**@param[in] type program type of every unit
+**@param[in] address destination (aligned to the unit)
+**@param[in] data source bytes
+**@param[in] count number of units
+**/
+static uint8 BL_FLASH_uint8ProgramUnits(uint8 type , uint32 address , const uint8 *data , uint32 count)
+{
+	uint8 loc_status = HAL_OK;
+	uint32 loc_width = 1UL << type;
+	uint32 loc_count = 0U;
+	uint32 loc_programmed = 0U;
+	uint32 loc_start = DWT->CYCCNT;
+	uint64 loc_unit = 0U;
+
+	for(loc_count = 0U ; loc_count < count ; loc_count++)
+	{
+		if(1U == BL_FLASH_uint8Matches(address + (loc_count * loc_width) , &data[loc_count * loc_width] , loc_width)){
+			continue;
+		}
+		/****** source may be unaligned , little endian like the flash ****/
+		loc_unit = 0U;
+		memcpy(&loc_unit , &data[loc_count * loc_width] , loc_width);
+		loc_status = HAL_FLASH_Program(type , address + (loc_count * loc_width) , loc_unit);
+		if(HAL_OK != loc_status){
+			break;
+		}
+		loc_programmed += loc_width;
+	}
+	if(0U != count){
+		BL_Flash_Cycles[BL_FLASH_PATH_HAL][type] += DWT->CYCCNT - loc_start;
+		BL_Flash_Bytes[BL_FLASH_PATH_HAL][type] += loc_programmed;
+		BL_Flash_Skipped += (loc_count * loc_width) - loc_programmed;
+		BL_Flash_Last_Programmed += loc_programmed;
+	}
+	return loc_status;
+}
+
+/*****BL_FLASH_uint8StreamUnits
+**@param[in] type program type of every unit
+**@param[in] address destination (aligned to the unit)
+**@param[in] data source bytes
+**@param[in] count number of units
+**/
+static uint8 BL_FLASH_uint8StreamUnits(uint8 type , uint32 address , const uint8 *data , uint32 count)
+{
+	uint8 loc_status = HAL_OK;
+	uint32 loc_width = 1UL << type;
+	uint32 loc_count = 0U;
+	uint32 loc_start = DWT->CYCCNT;
+	uint32 loc_destination = address;
+	uint32 loc_programmed = 0U;
+	uint64 loc_unit = 0U;
+
+	if(0U != count){
+		/****** parallelism only changes around head and tail bytes ****/
+		if(BL_FLASH_CR_PSIZE(type) != (FLASH->CR & FLASH_CR_PSIZE)){
+			(void)BL_FLASH_uint32Idle();
+			FLASH->CR = (FLASH->CR & ~FLASH_CR_PSIZE) | BL_FLASH_CR_PSIZE(type);
+		}
+		for(loc_count = 0U ; loc_count < count ; loc_count++)
+		{
+			if(1U == BL_FLASH_uint8Matches(loc_destination , &data[loc_count * loc_width] , loc_width)){
+				loc_destination += loc_width;
+				continue;
+			}
+			loc_unit = 0U;
+			memcpy(&loc_unit , &data[loc_count * loc_width] , loc_width);
+			/****** previous unit still programming ****/
+			if(0U != (BL_FLASH_uint32Idle() & BL_FLASH_SR_ERRORS)){
+				loc_status = HAL_ERROR;
+				break;
+			}
+			if(FLASH_TYPEPROGRAM_DOUBLEWORD == type){
+				*(__IO uint32 *)loc_destination = (uint32)loc_unit;
+				__ISB();
+				*(__IO uint32 *)(loc_destination + 4U) = (uint32)(loc_unit >> 32U);
+			}else if(FLASH_TYPEPROGRAM_WORD == type){
+				*(__IO uint32 *)loc_destination = (uint32)loc_unit;
+			}else if(FLASH_TYPEPROGRAM_HALFWORD == type){
+				*(__IO uint16 *)loc_destination = (uint16)loc_unit;
+			}else{
+				*(__IO uint8 *)loc_destination = (uint8)loc_unit;
+			}
+			__DSB();
+			loc_destination += loc_width;
+			loc_programmed += loc_width;
+		}
+		/****** last unit done before the range is read back ****/
+		if(0U != (BL_FLASH_uint32Idle() & BL_FLASH_SR_ERRORS)){
+			loc_status = HAL_ERROR;
+		}
+		BL_Flash_Cycles[BL_FLASH_PATH_STREAM][type] += DWT->CYCCNT - loc_start;
+		BL_Flash_Bytes[BL_FLASH_PATH_STREAM][type] += loc_programmed;
+		BL_Flash_Skipped += (loc_count * loc_width) - loc_programmed;
+		BL_Flash_Last_Programmed += loc_programmed;
+	}
+	return loc_status;
+}
+
+/*****BL_FLASH_uint8Matches
+**@param[in] address destination
+**@param[in] data source bytes
+**@param[in] width unit bytes
+**/
+static uint8 BL_FLASH_uint8Matches(uint32 address , const uint8 *data , uint32 width)
+{
+	uint8 loc_matches = 0U;
+
+	if(BL_FLASH_SKIP_ENABLE == BL_FLASH_SKIP_MATCHING){
+		/****** read waits for a program operation still running ****/
+		loc_matches = (0 == memcmp((const void *)address , data , width)) ? 1U : 0U;
+	}
+	return loc_matches;
+}
+
+/*****BL_FLASH_uint8EraseStep
+**@param[in] operation erase bits of CR
+**@param[in] idle work done while the flash is busy
+**/
+static uint8 BL_FLASH_uint8EraseStep(uint32 operation , Bl_Flash_Idle idle)
+{
+	uint8 loc_status = HAL_OK;
+
+	(void)BL_FLASH_uint32Idle();
+	FLASH->SR = BL_FLASH_SR_ERRORS | FLASH_SR_EOP;
+	/****** erase parallelism follows the voltage range like the program unit ****/
+	FLASH->CR = (FLASH->CR & ~(BL_FLASH_CR_OPERATIONS | FLASH_CR_PSIZE)) | BL_FLASH_CR_PSIZE(BL_FLASH_PROGRAM_TYPE) | operation;
+	FLASH->CR |= FLASH_CR_STRT;
+	__DSB();
+	while(0U != (FLASH->SR & FLASH_SR_BSY))
+	{
+		if(NULL != idle){
+			idle();
+		}
+	}
+	if(0U != (FLASH->SR & BL_FLASH_SR_ERRORS)){
+		loc_status = HAL_ERROR;
+	}
+	FLASH->SR = BL_FLASH_SR_ERRORS | FLASH_SR_EOP;
+	FLASH->CR &= ~BL_FLASH_CR_OPERATIONS;
+	return loc_status;
+}
+
+/*****BL_FLASH_uint32Idle
+**/
+static uint32 BL_FLASH_uint32Idle(void)
+{
+	uint32 loc_status = FLASH->SR;
+
+	while(0U != (loc_status & FLASH_SR_BSY))
+	{
+		loc_status = FLASH->SR;
+	}
+	return loc_status;
+}
+
+/*****BL_FLASH_VidCycleCounter
+**/
+static void BL_FLASH_VidCycleCounter(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->LAR = 0xC5ACCE55U;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
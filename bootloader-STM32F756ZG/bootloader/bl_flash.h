@@ -0,0 +1,147 @@
+/// \file bl_flash.h
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Flash programming with the widest parallelism the supply allows , bytes only for
+///        the unaligned head and tail of a range. A streaming path programs whole buffers
+///        on the registers , the HAL path is kept for comparison. Keeps per mode throughput figures.
+///        Erase runs on the registers too , from ITCM like the stream path (see the scatter file) ,
+///        so the core keeps working while the flash is busy.
+
+#ifndef BL_FLASH_H
+#define BL_FLASH_H
+/************** Global Includes**************/
+#include "LSTD_TYPES.h"
+#include "main.h"
+
+/*********** Macro declerations**********/
+// Device operating range , shared by erase and program (RANGE_4 needs the external Vpp)
+#define BL_FLASH_VOLTAGE_RANGE											FLASH_VOLTAGE_RANGE_3
+
+// Widest program type of the range (PSIZE x8 / x16 / x32 / x64)
+#define BL_FLASH_PROGRAM_TYPE												((FLASH_VOLTAGE_RANGE_4 == BL_FLASH_VOLTAGE_RANGE) ? FLASH_TYPEPROGRAM_DOUBLEWORD : \
+																						 (FLASH_VOLTAGE_RANGE_3 == BL_FLASH_VOLTAGE_RANGE) ? FLASH_TYPEPROGRAM_WORD : \
+																						 (FLASH_VOLTAGE_RANGE_2 == BL_FLASH_VOLTAGE_RANGE) ? FLASH_TYPEPROGRAM_HALFWORD : \
+																						 FLASH_TYPEPROGRAM_BYTE)
+#define BL_FLASH_PROGRAM_UNIT												(1UL << BL_FLASH_PROGRAM_TYPE)	/* bytes per program operation */
+#define BL_FLASH_PROGRAM_TYPES											4U				/* byte , half word , word , double word */
+
+// Program paths : HAL_FLASH_Program per unit , or register level stream (BL_FLASH_uint8Begin)
+#define BL_FLASH_PATH_HAL														0U
+#define BL_FLASH_PATH_STREAM												1U
+#define BL_FLASH_PATHS															2U
+
+// Path of write payloads (BL_FLASH_PATH_HAL to measure the HAL overhead)
+#define BL_FLASH_WRITE_PATH													BL_FLASH_PATH_STREAM
+
+// Compare before program : units already holding the data (0xFF over erased flash included) are skipped
+#define BL_FLASH_SKIP_DISABLE												0U
+#define BL_FLASH_SKIP_ENABLE												1U
+#define BL_FLASH_SKIP_MATCHING											BL_FLASH_SKIP_ENABLE
+
+// Sector argument of BL_FLASH_uint8Erase for a mass erase
+#define BL_FLASH_ERASE_MASS													0xFFU
+
+/*********** Data Type Declerations*****/
+/* called over and over while an erase keeps the flash busy , must not touch the flash */
+typedef void (*Bl_Flash_Idle)(void);
+
+/********* Software Function Prototype*******/
+/*****BL_FLASH_VidInit
+**@description
+	Copies the vector table to RAM and points VTOR to the copy , an interrupt taken while the
+	flash is busy then needs no flash read to find its handler. Starts the DWT cycle counter.
+**/
+void BL_FLASH_VidInit(void);
+
+/*****BL_FLASH_VidDeInit
+**@description gives VTOR back its value from before BL_FLASH_VidInit (before leaving the bootloader)
+**/
+void BL_FLASH_VidDeInit(void);
+
+/*****BL_FLASH_uint8Program
+**@description
+	Programs a range with HAL_FLASH_Program : bytes up to the first BL_FLASH_PROGRAM_UNIT boundary ,
+	whole units , then the remaining bytes. The source may be unaligned. The flash is unlocked
+	by the caller. With BL_FLASH_SKIP_MATCHING units that already hold their data are skipped.
+**@param[in] address destination
+**@param[in] data source bytes
+**@param[in] len number of bytes
+**@return HAL_OK , or the status of the program operation that failed
+**/
+uint8 BL_FLASH_uint8Program(uint32 address , const uint8 *data , uint32 len);
+
+/*****BL_FLASH_uint8Begin
+**@description
+	Opens a program stream : unlocks the flash , clears old error flags and sets PG and the
+	parallelism once. Does nothing while the stream is open , so it may be called per buffer.
+	An erase or a HAL lock closes the stream , the next call opens it again.
+**@return HAL_OK or HAL_ERROR (flash stays locked)
+**/
+uint8 BL_FLASH_uint8Begin(void);
+
+/*****BL_FLASH_uint8ProgramBuffer
+**@description
+	Programs a range on an open stream in a register loop : same split as BL_FLASH_uint8Program ,
+	BSY is only polled before the next unit is written and once at the end of the range.
+**@param[in] address destination
+**@param[in] data source bytes
+**@param[in] len number of bytes
+**@return HAL_OK , or HAL_ERROR when an error flag is set (the stream stays open)
+**/
+uint8 BL_FLASH_uint8ProgramBuffer(uint32 address , const uint8 *data , uint32 len);
+
+/*****BL_FLASH_uint8End
+**@description closes the stream : waits for the last operation , clears PG and locks the flash
+**@return HAL_OK , or HAL_ERROR when an error flag was left set
+**/
+uint8 BL_FLASH_uint8End(void);
+
+/*****BL_FLASH_uint8Erase
+**@description
+	Erases sectors on the registers , closes an open program stream first. While a sector is
+	being erased idle is called again and again , the flash must not be read from it.
+**@param[in] sector first sector , or BL_FLASH_ERASE_MASS
+**@param[in] count number of sectors (not used for a mass erase)
+**@param[in] idle work done while the flash is busy (NULL -> wait)
+**@return HAL_OK , or HAL_ERROR when the flash can't be unlocked or an error flag is set
+**/
+uint8 BL_FLASH_uint8Erase(uint8 sector , uint8 count , Bl_Flash_Idle idle);
+
+/*****BL_FLASH_uint32LastProgrammed
+**@return bytes the last BL_FLASH_uint8Program or BL_FLASH_uint8ProgramBuffer call really programmed ,
+	units that already matched are not counted
+**/
+uint32 BL_FLASH_uint32LastProgrammed(void);
+
+/*****BL_FLASH_uint32Skipped
+**@return bytes left untouched because flash already held them , since BL_FLASH_VidStatsReset
+**/
+uint32 BL_FLASH_uint32Skipped(void);
+
+/*****BL_FLASH_uint32Bytes
+**@param[in] path BL_FLASH_PATH_xx
+**@param[in] type FLASH_TYPEPROGRAM_BYTE .. FLASH_TYPEPROGRAM_DOUBLEWORD
+**@return bytes programmed with this type since BL_FLASH_VidStatsReset (skipped units not counted)
+**/
+uint32 BL_FLASH_uint32Bytes(uint8 path , uint8 type);
+
+/*****BL_FLASH_uint32BytesPerSecond
+**@param[in] path BL_FLASH_PATH_xx
+**@param[in] type FLASH_TYPEPROGRAM_BYTE .. FLASH_TYPEPROGRAM_DOUBLEWORD
+**@return measured throughput of this type (0 when unused)
+**/
+uint32 BL_FLASH_uint32BytesPerSecond(uint8 path , uint8 type);
+
+/*****BL_FLASH_uint32UnitCycles
+**@param[in] path BL_FLASH_PATH_xx
+**@param[in] type FLASH_TYPEPROGRAM_BYTE .. FLASH_TYPEPROGRAM_DOUBLEWORD
+**@return average DWT cycles per program operation of this type , flash time and overhead (0 when unused)
+**/
+uint32 BL_FLASH_uint32UnitCycles(uint8 path , uint8 type);
+
+/*****BL_FLASH_VidStatsReset
+**@description clears the byte and time counters of all paths and types
+**/
+void BL_FLASH_VidStatsReset(void);
+
+#endif /*BL_FLASH_H*/
@@ -0,0 +1,211 @@
+/// \file bl_hash.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief SHA-256 on the HASH processor (direct register access) , data moved by DMA
+/// The processor needs 66 cycles per 64 byte block for SHA-256 , the DMA keeps
+/// its input FIFO full , so a 1 MB image takes about 1.1 M cycles (5 ms at
+/// 216 MHz). Stream 7 has no interrupt enabled here , its vector belongs to the
+/// USART6 TX handle : completion is polled from the DMA and HASH flags.
+
+
+/************Global Includes*************/
+#include <string.h>
+#include "bl_hash.h"
+
+/*********** Macro declerations**********/
+// HASH control : SHA-256 , 8 bit data (bytes swapped by the processor) , DMA input
+#define BL_HASH_CR_SHA256														(HASH_CR_ALGO_1 | HASH_CR_ALGO_0 | HASH_CR_DATATYPE_1 | HASH_CR_DMAE)
+#define BL_HASH_DIGEST_WORDS												8U
+#define BL_HASH_HMAC_IPAD														0x36U
+#define BL_HASH_HMAC_OPAD														0x5CU
+
+// DMA2 stream 7 : channel 2 (HASH_IN) , memory to peripheral , word to word , memory increment
+#define BL_HASH_DMA_CR															(BL_HASH_DMA_CHANNEL | DMA_SxCR_DIR_0 | DMA_SxCR_MINC | DMA_SxCR_PSIZE_1 | DMA_SxCR_MSIZE_1)
+#define BL_HASH_DMA_FLAGS														(DMA_HIFCR_CFEIF7 | DMA_HIFCR_CDMEIF7 | DMA_HIFCR_CTEIF7 | \
+																						 DMA_HIFCR_CHTIF7 | DMA_HIFCR_CTCIF7)
+
+/********* Static Function Prototypes************/
+/*****BL_HASH_uint8DmaTransfer
+**@description hands one block of words to the HASH processor and waits for the DMA
+**@param[in] data word aligned source
+**@param[in] words number of words (up to BL_HASH_DMA_MAX_WORDS)
+**@return BL_HASH_OK , BL_HASH_FAILED on a transfer error or after BL_HASH_TIMEOUT_MS
+**/
+static uint8 BL_HASH_uint8DmaTransfer(const uint8 *data , uint32 words);
+
+/********* Global Variables Declerations************/
+static uint32 BL_Hash_Last_Cycles = 0U;								// cycles of last digest
+static uint32 BL_Hash_Hmac_Block[(BL_HASH_BLOCK_LEN + BL_HASH_HMAC_MAX_DATA) / 4U];	// padded key | message , word aligned for DMA
+
+/********* Software Function Definition *******/
+/*****BL_HASH_uint8Sha256
+**@param[in] data start of range (word aligned)
+**@param[in] len number of bytes
+**@param[out] digest BL_HASH_SHA256_LEN bytes (zero when failed)
+**@return BL_HASH_OK or BL_HASH_FAILED
+**/
+uint8 BL_HASH_uint8Sha256(const uint8 *data , uint32 len , uint8 *digest)
+{
+	uint8 loc_status = BL_HASH_OK;
+	uint32 loc_tick = 0U;
+	uint32 loc_start = 0U;
+	uint32 loc_words = (len + 3U) >> 2U;
+	uint32 loc_block = 0U;
+	uint32 loc_digest_word = 0U;
+	uint8 loc_count = 0U;
+	uint32 loc_saved_cr = 0U;
+	uint32 loc_saved_fcr = 0U;
+	uint32 loc_saved_par = 0U;
+
+	/****** cycle counter : trace enable , unlock (Cortex-M7) , start ****/
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->LAR = 0xC5ACCE55U;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	loc_start = DWT->CYCCNT;
+
+	__HAL_RCC_HASH_CLK_ENABLE();
+	/****** borrow stream 7 from USART6 TX , keep its configuration ****/
+	loc_tick = HAL_GetTick();
+	while((0U != (BL_HASH_DMA_STREAM->CR & DMA_SxCR_EN)) && (BL_HASH_OK == loc_status))
+	{
+		/****** transmission still running ****/
+		if((HAL_GetTick() - loc_tick) > BL_HASH_TIMEOUT_MS){
+			loc_status = BL_HASH_FAILED;
+		}
+	}
+	if(BL_HASH_OK == loc_status){
+		loc_saved_cr = BL_HASH_DMA_STREAM->CR;
+		loc_saved_fcr = BL_HASH_DMA_STREAM->FCR;
+		loc_saved_par = BL_HASH_DMA_STREAM->PAR;
+
+		/****** new digest , several DMA blocks until the last one (MDMAT) , valid bits of last word ****/
+		HASH->CR = BL_HASH_CR_SHA256 | HASH_CR_MDMAT | HASH_CR_INIT;
+		HASH->STR = (len & 3U) << 3U;
+		if(0U == loc_words){
+			HASH->STR |= HASH_STR_DCAL;
+		}
+		while((loc_words > 0U) && (BL_HASH_OK == loc_status))
+		{
+			loc_block = (loc_words > BL_HASH_DMA_MAX_WORDS) ? BL_HASH_DMA_MAX_WORDS : loc_words;
+			loc_words -= loc_block;
+			if(0U == loc_words){
+				/****** digest calculation starts by itself after the last block ****/
+				HASH->CR &= ~HASH_CR_MDMAT;
+			}
+			loc_status = BL_HASH_uint8DmaTransfer(data , loc_block);
+			data = &data[loc_block << 2U];
+		}
+		loc_tick = HAL_GetTick();
+		while((0U == (HASH->SR & HASH_SR_DCIS)) && (BL_HASH_OK == loc_status))
+		{
+			/****** last block being processed ****/
+			if((HAL_GetTick() - loc_tick) > BL_HASH_TIMEOUT_MS){
+				loc_status = BL_HASH_FAILED;
+			}
+		}
+		for(loc_count = 0U ; (loc_count < BL_HASH_DIGEST_WORDS) && (BL_HASH_OK == loc_status) ; loc_count++)
+		{
+			loc_digest_word = HASH_DIGEST->HR[loc_count];
+			digest[(loc_count << 2U) + 0U] = (uint8)(loc_digest_word >> 24U);
+			digest[(loc_count << 2U) + 1U] = (uint8)(loc_digest_word >> 16U);
+			digest[(loc_count << 2U) + 2U] = (uint8)(loc_digest_word >> 8U);
+			digest[(loc_count << 2U) + 3U] = (uint8)loc_digest_word;
+		}
+
+		/****** stream back to USART6 TX ****/
+		BL_HASH_DMA_STREAM->CR = loc_saved_cr & ~DMA_SxCR_EN;
+		BL_HASH_DMA_STREAM->FCR = loc_saved_fcr;
+		BL_HASH_DMA_STREAM->PAR = loc_saved_par;
+		DMA2->HIFCR = BL_HASH_DMA_FLAGS;
+	}
+	if(BL_HASH_OK != loc_status){
+		memset(digest , 0 , BL_HASH_SHA256_LEN);
+	}
+	BL_Hash_Last_Cycles = DWT->CYCCNT - loc_start;
+	return loc_status;
+}
+
+/*****BL_HASH_uint8HmacSha256
+**@param[in] key BL_HASH_HMAC_KEY_LEN bytes
+**@param[in] data message
+**@param[in] len message bytes (up to BL_HASH_HMAC_MAX_DATA)
+**@param[out] mac BL_HASH_SHA256_LEN bytes (zero when failed)
+**@return BL_HASH_OK or BL_HASH_FAILED
+**/
+uint8 BL_HASH_uint8HmacSha256(const uint8 *key , const uint8 *data , uint32 len , uint8 *mac)
+{
+	uint8 *loc_block = (uint8 *)BL_Hash_Hmac_Block;
+	uint8 loc_inner[BL_HASH_SHA256_LEN];
+	uint8 loc_count = 0U;
+	uint8 loc_status = BL_HASH_OK;
+
+	/****** inner digest : (key ^ ipad) | message ****/
+	memset(loc_block , BL_HASH_HMAC_IPAD , BL_HASH_BLOCK_LEN);
+	for(loc_count = 0U ; loc_count < BL_HASH_HMAC_KEY_LEN ; loc_count++)
+	{
+		loc_block[loc_count] ^= key[loc_count];
+	}
+	memcpy(&loc_block[BL_HASH_BLOCK_LEN] , data , len);
+	loc_status = BL_HASH_uint8Sha256(loc_block , BL_HASH_BLOCK_LEN + len , loc_inner);
+	/****** outer digest : (key ^ opad) | inner digest ****/
+	memset(loc_block , BL_HASH_HMAC_OPAD , BL_HASH_BLOCK_LEN);
+	for(loc_count = 0U ; loc_count < BL_HASH_HMAC_KEY_LEN ; loc_count++)
+	{
+		loc_block[loc_count] ^= key[loc_count];
+	}
+	memcpy(&loc_block[BL_HASH_BLOCK_LEN] , loc_inner , BL_HASH_SHA256_LEN);
+	if(BL_HASH_OK == loc_status){
+		loc_status = BL_HASH_uint8Sha256(loc_block , BL_HASH_BLOCK_LEN + BL_HASH_SHA256_LEN , mac);
+	}else{
+		memset(mac , 0 , BL_HASH_SHA256_LEN);
+	}
+	return loc_status;
+}
+
+/*****BL_HASH_uint32LastCycles
+**@return DWT cycles of the last BL_HASH_uint8Sha256 call (boot time overhead)
+**/
+uint32 BL_HASH_uint32LastCycles(void)
+{
+	return BL_Hash_Last_Cycles;
+}
+
+/********* Static Function Definitions************/
+/*****BL_HASH_uint8DmaTransfer
+**@param[in] data word aligned source
+**@param[in] words number of words (up to BL_HASH_DMA_MAX_WORDS)
+**@return BL_HASH_OK , BL_HASH_FAILED on a transfer error or after BL_HASH_TIMEOUT_MS
+**/
+static uint8 BL_HASH_uint8DmaTransfer(const uint8 *data , uint32 words)
+{
+	uint8 loc_status = BL_HASH_OK;
+	uint32 loc_tick = 0U;
+
+	BL_HASH_DMA_STREAM->CR = 0U;
+	while(0U != (BL_HASH_DMA_STREAM->CR & DMA_SxCR_EN))
+	{
+		/****** stream disables after the last transfer ****/
+	}
+	DMA2->HIFCR = BL_HASH_DMA_FLAGS;
+	BL_HASH_DMA_STREAM->PAR = (uint32)&HASH->DIN;
+	BL_HASH_DMA_STREAM->M0AR = (uint32)data;
+	BL_HASH_DMA_STREAM->NDTR = words;
+	BL_HASH_DMA_STREAM->FCR = 0U;
+	BL_HASH_DMA_STREAM->CR = BL_HASH_DMA_CR | DMA_SxCR_EN;
+	loc_tick = HAL_GetTick();
+	while((0U == (DMA2->HISR & (DMA_HISR_TCIF7 | DMA_HISR_TEIF7))) && (BL_HASH_OK == loc_status))
+	{
+		/****** HASH FIFO paces the transfer ****/
+		if((HAL_GetTick() - loc_tick) > BL_HASH_TIMEOUT_MS){
+			loc_status = BL_HASH_FAILED;
+		}
+	}
+	/****** bus error : the processor got only part of the data , its digest would never come ****/
+	if(0U != (DMA2->HISR & DMA_HISR_TEIF7)){
+		loc_status = BL_HASH_FAILED;
+	}
+	if(BL_HASH_OK != loc_status){
+		BL_HASH_DMA_STREAM->CR = 0U;
+	}
+	return loc_status;
+}
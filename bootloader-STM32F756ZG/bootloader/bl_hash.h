@@ -0,0 +1,57 @@
+/// \file bl_hash.h
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief SHA-256 on the HASH processor fed by DMA (DMA2 stream 7 channel 2) , used to verify
+///        the application image before it is started.
+
+#ifndef BL_HASH_H
+#define BL_HASH_H
+/************** Global Includes**************/
+#include "LSTD_TYPES.h"
+#include "main.h"
+
+/*********** Macro declerations**********/
+#define BL_HASH_SHA256_LEN													32U				/* digest bytes */
+#define BL_HASH_BLOCK_LEN														64U				/* SHA-256 block , HMAC key pad */
+#define BL_HASH_HMAC_KEY_LEN												32U
+#define BL_HASH_HMAC_MAX_DATA												64U				/* message bytes of BL_HASH_uint8HmacSha256 */
+
+// Digest status , a failed digest is zeroed and must be treated as a mismatch
+#define BL_HASH_OK																	0x00
+#define BL_HASH_FAILED															0x01			/* DMA transfer error or timeout */
+#define BL_HASH_TIMEOUT_MS													20U				/* per wait , one DMA block (256 KB) takes about 1.3 ms */
+
+// Memory to HASH transfer : HASH_IN request of DMA2 , shared with USART6 TX
+#define BL_HASH_DMA_STREAM													DMA2_Stream7
+#define BL_HASH_DMA_CHANNEL													(2U << DMA_SxCR_CHSEL_Pos)
+#define BL_HASH_DMA_MAX_WORDS												65520U		/* NDTR limit rounded down to whole 64 byte blocks */
+
+/********* Software Function Prototype*******/
+/*****BL_HASH_uint8Sha256
+**@description
+	SHA-256 of a memory range. The HASH processor takes the words by DMA and swaps the bytes
+	itself , the CPU only waits for the digest. Stream 7 is borrowed from USART6 TX : the
+	caller keeps the host link transmitter idle , its stream configuration is restored.
+**@param[in] data start of range (word aligned)
+**@param[in] len number of bytes
+**@param[out] digest BL_HASH_SHA256_LEN bytes (zero when failed)
+**@return BL_HASH_OK or BL_HASH_FAILED
+**/
+uint8 BL_HASH_uint8Sha256(const uint8 *data , uint32 len , uint8 *digest);
+
+/*****BL_HASH_uint8HmacSha256
+**@description HMAC-SHA256 (RFC 2104) of a short message , two digests on the HASH processor
+**@param[in] key BL_HASH_HMAC_KEY_LEN bytes
+**@param[in] data message
+**@param[in] len message bytes (up to BL_HASH_HMAC_MAX_DATA)
+**@param[out] mac BL_HASH_SHA256_LEN bytes (zero when failed)
+**@return BL_HASH_OK or BL_HASH_FAILED
+**/
+uint8 BL_HASH_uint8HmacSha256(const uint8 *key , const uint8 *data , uint32 len , uint8 *mac);
+
+/*****BL_HASH_uint32LastCycles
+**@return DWT cycles of the last BL_HASH_uint8Sha256 call (boot time overhead)
+**/
+uint32 BL_HASH_uint32LastCycles(void);
+
+#endif /*BL_HASH_H*/
@@ -0,0 +1,24 @@
+/// \file bl_keys_template.h
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Format of the product key file. Copy it to bl_keys.h (ignored by git) , fill in random
+///        bytes (e.g. python -c "import os;print(os.urandom(32).hex())" , 16 bytes for AES) , delete the #error line
+///        and add BL_KEYS_FILE="bl_keys.h" to the preprocessor symbols. Host.py reads the same
+///        file (python script/Host.py --keys <file>).
+
+#ifndef BL_KEYS_H
+#define BL_KEYS_H
+
+#error "template keys : fill in the product keys and delete this line"
+
+// Image key of encrypted write sessions (BL_AES_KEY_LEN bytes)
+#define BL_AES_KEY																	{0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , \
+																						 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U}
+
+// Image header MAC key (BL_HASH_HMAC_KEY_LEN bytes)
+#define BL_MERKLE_MAC_KEY													{0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , \
+																						 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , \
+																						 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , \
+																						 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U , 0x00U}
+
+#endif /*BL_KEYS_H*/
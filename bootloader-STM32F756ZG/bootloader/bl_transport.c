@@ -0,0 +1,272 @@
+/// \file bl_transport.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host link abstraction : frame parser shared by all ring based backends
+/// A backend only has to fill a ring and tell when the line went silent,
+/// marker hunting , header decoding and resync are the same for every link.
+/// A frame still arriving is copied to the frame buffer and run through the
+/// CRC unit on every poll, the bytes stay in the ring until the frame is
+/// complete so a dropped frame resyncs exactly as before. When the last byte
+/// lands only the crc word is left to check and the header is decoded once.
+
+
+/************Global Includes*************/
+#include "bl_transport.h"
+#include "bl_crc.h"
+#include "main.h"
+
+/********* Static Function Prototypes************/
+/*****BL_Transport_VidRxCopy
+**@param[in] ring receive ring
+**@param[in] offset offset from the read index
+**@param[in] dest destination buffer
+**@param[in] len number of bytes to copy (not consumed)
+**/
+static void BL_Transport_VidRxCopy(const Bl_Rx_Ring *ring , uint16 offset , uint8 *dest , uint16 len);
+
+/*****BL_Transport_VidFrameProgress
+**@description copies newly arrived bytes of the current frame and feeds its CRC
+**@param[in] ring receive ring , read index on the marker
+**@param[in] frame_buf destination buffer
+**@param[in] frame_len header + packet
+**@param[in] received bytes of the frame in the ring
+**/
+static void BL_Transport_VidFrameProgress(const Bl_Rx_Ring *ring , uint8 *frame_buf , uint16 frame_len , uint16 received);
+
+/*****BL_Transport_VidFrameDecode
+**@description fills the header fields of the complete frame
+**@param[in] frame_len header + packet
+**@param[in] header_len BL_TRANSPORT_FRAME_HEADER_LEN or BL_TRANSPORT_FRAME_EXT_HEADER_LEN
+**/
+static void BL_Transport_VidFrameDecode(uint16 frame_len , uint16 header_len);
+
+/********* Global Variables Declerations************/
+static uint8 BL_Rx_Extended_Frames = 0U;						// extended frame header negotiated
+static Bl_Frame BL_Rx_Frame;														// last complete frame , then frame in progress
+static const Bl_Rx_Ring *BL_Rx_Frame_Ring = NULL;			// ring and marker index of frame in progress
+static uint16 BL_Rx_Frame_Start = 0U;
+static uint16 BL_Rx_Frame_Copied = 0U;								// bytes already in the frame buffer and CRC
+
+/********* Software Function Definition *******/
+/*****BL_Transport_VidSetExtendedFrames
+**@param[in] enable 0 -> legacy frames only , else legacy and extended frames
+**/
+void BL_Transport_VidSetExtendedFrames(uint8 enable)
+{
+	BL_Rx_Extended_Frames = enable;
+}
+
+/*****BL_Transport_uint16RxAvailable
+**@param[in] ring receive ring
+**@return number of received bytes not yet consumed
+**/
+uint16 BL_Transport_uint16RxAvailable(const Bl_Rx_Ring *ring)
+{
+	return (uint16)((ring->Head + ring->Length - ring->Tail) % ring->Length);
+}
+
+/*****BL_Transport_uint8RxPeek
+**@param[in] ring receive ring
+**@param[in] offset offset from the read index
+**@return byte at read index + offset (not consumed)
+**/
+uint8 BL_Transport_uint8RxPeek(const Bl_Rx_Ring *ring , uint16 offset)
+{
+	return ring->Buffer[(ring->Tail + offset) % ring->Length];
+}
+
+/*****BL_Transport_VidRxRead
+**@param[in] ring receive ring
+**@param[in] dest destination buffer (NULL to drop data)
+**@param[in] len number of bytes to consume
+**/
+void BL_Transport_VidRxRead(Bl_Rx_Ring *ring , uint8 *dest , uint16 len)
+{
+	if(NULL != dest){
+		BL_Transport_VidRxCopy(ring , 0U , dest , len);
+	}
+	ring->Tail = (uint16)((ring->Tail + len) % ring->Length);
+}
+
+/*****BL_Transport_uint8FetchFrame
+**@param[in] ring receive ring (Head already refreshed)
+**@param[in] frame_buf destination buffer
+**@param[in] buf_len destination buffer size
+**@param[in] line_silent 1 if nothing arrived for BL_TRANSPORT_INTER_BYTE_TIMEOUT_MS
+**@return BL_TRANSPORT_FRAME_READY , BL_TRANSPORT_FRAME_NOT_READY , BL_TRANSPORT_FRAME_TOO_LONG or BL_TRANSPORT_FRAME_DROPPED
+**/
+uint8 BL_Transport_uint8FetchFrame(Bl_Rx_Ring *ring , uint8 *frame_buf , uint16 buf_len , uint8 line_silent)
+{
+	uint8 loc_frame_status = BL_TRANSPORT_FRAME_NOT_READY;
+	uint16 loc_available = BL_Transport_uint16RxAvailable(ring);
+	uint32 loc_frame_len = 0U;			// header + packet , 0 -> header not complete yet
+	uint32 loc_min_len = BL_TRANSPORT_FRAME_HEADER_LEN + BL_TRANSPORT_FRAME_MIN_PACKET_LEN;
+	uint16 loc_header_len = BL_TRANSPORT_FRAME_HEADER_LEN;
+
+	/******* hunt : anything before the marker is noise or rest of a broken frame *****/
+	while((loc_available > 0U) && (BL_TRANSPORT_FRAME_SOF != BL_Transport_uint8RxPeek(ring , 0U)))
+	{
+		BL_Transport_VidRxRead(ring , NULL , 1U);
+		loc_available--;
+	}
+	if(loc_available > BL_TRANSPORT_FRAME_SOF_LEN){
+		if((BL_TRANSPORT_FRAME_EXTENDED_MARK == BL_Transport_uint8RxPeek(ring , 1U)) && (0U != BL_Rx_Extended_Frames)){
+			/******* extended header , 16 bit packet length follows the mark ****/
+			loc_min_len = BL_TRANSPORT_FRAME_EXT_HEADER_LEN + BL_TRANSPORT_FRAME_MIN_PACKET_LEN;
+			loc_header_len = BL_TRANSPORT_FRAME_EXT_HEADER_LEN;
+			if(loc_available >= (BL_TRANSPORT_FRAME_SOF_LEN + BL_TRANSPORT_FRAME_EXT_HEADER_LEN)){
+				loc_frame_len = (uint32)BL_Transport_uint8RxPeek(ring , 2U) | ((uint32)BL_Transport_uint8RxPeek(ring , 3U) << 8U);
+				loc_frame_len += BL_TRANSPORT_FRAME_EXT_HEADER_LEN;
+			}
+		}else{
+			/******* first byte of header is packet length "cmd code + (optional)info + crc" ****/
+			loc_frame_len = (uint32)BL_Transport_uint8RxPeek(ring , 1U) + BL_TRANSPORT_FRAME_HEADER_LEN;
+		}
+	}
+	if(0U != loc_frame_len){
+		if(loc_frame_len < loc_min_len){
+			/******** corrupted length or false marker , search again behind it *****/
+			BL_Transport_VidRxRead(ring , NULL , BL_TRANSPORT_FRAME_SOF_LEN);
+			loc_frame_status = BL_TRANSPORT_FRAME_DROPPED;
+		}else if(loc_frame_len > buf_len){
+			/******** can never fit host buffer (nor the ring) , search again behind marker *****/
+			BL_Transport_VidRxRead(ring , NULL , BL_TRANSPORT_FRAME_SOF_LEN);
+			loc_frame_status = BL_TRANSPORT_FRAME_TOO_LONG;
+		}else{
+			/******** take what arrived so far , CRC runs while the rest is on the line ****/
+			BL_Transport_VidFrameProgress(ring , frame_buf , (uint16)loc_frame_len , (uint16)(loc_available - BL_TRANSPORT_FRAME_SOF_LEN));
+			if(BL_Rx_Frame_Copied == loc_frame_len){
+				BL_Transport_VidRxRead(ring , NULL , (uint16)(loc_frame_len + BL_TRANSPORT_FRAME_SOF_LEN));
+				BL_Transport_VidFrameDecode((uint16)loc_frame_len , loc_header_len);
+				loc_frame_status = BL_TRANSPORT_FRAME_READY;
+			}else{
+				/******** incomplete frame , keep waiting unless the line went silent ****/
+			}
+		}
+	}
+	if((BL_TRANSPORT_FRAME_NOT_READY == loc_frame_status) && (loc_available > 0U) && (0U != line_silent)){
+		BL_Transport_VidRxRead(ring , NULL , BL_TRANSPORT_FRAME_SOF_LEN);
+		loc_frame_status = BL_TRANSPORT_FRAME_DROPPED;
+	}
+	return loc_frame_status;
+}
+
+/*****BL_Transport_pGetFrame
+**@return decoded frame
+**/
+const Bl_Frame *BL_Transport_pGetFrame(void)
+{
+	return &BL_Rx_Frame;
+}
+
+/*****BL_Transport_uint32GetLE
+**@param[in] data 4 bytes , any alignment
+**@return little endian word
+**/
+uint32 BL_Transport_uint32GetLE(const uint8 *data)
+{
+	return (uint32)data[0U] | ((uint32)data[1U] << 8U) | ((uint32)data[2U] << 16U) | ((uint32)data[3U] << 24U);
+}
+
+/*****BL_Transport_uint8ReceiveTimeout
+**@param[in] link host link
+**@param[in] frame_buf destination buffer
+**@param[in] buf_len destination buffer size
+**@param[in] timeout_ms max. waiting time
+**@return BL_TRANSPORT_FRAME_READY , BL_TRANSPORT_FRAME_NOT_READY (timeout) , BL_TRANSPORT_FRAME_TOO_LONG or BL_TRANSPORT_FRAME_DROPPED
+**/
+uint8 BL_Transport_uint8ReceiveTimeout(const Bl_Transport *link , uint8 *frame_buf , uint16 buf_len , uint32 timeout_ms)
+{
+	uint32 loc_start_tick = HAL_GetTick();
+	uint8 loc_frame_status = link->Receive(frame_buf , buf_len);
+
+	while((BL_TRANSPORT_FRAME_NOT_READY == loc_frame_status) && ((HAL_GetTick() - loc_start_tick) < timeout_ms))
+	{
+		/****** every backend returns from Poll after ~1 ms at latest *****/
+		link->Poll();
+		loc_frame_status = link->Receive(frame_buf , buf_len);
+	}
+	return loc_frame_status;
+}
+
+/********* Static Function Definitions************/
+/*****BL_Transport_VidRxCopy
+**@param[in] ring receive ring
+**@param[in] offset offset from the read index
+**@param[in] dest destination buffer
+**@param[in] len number of bytes to copy (not consumed)
+**/
+static void BL_Transport_VidRxCopy(const Bl_Rx_Ring *ring , uint16 offset , uint8 *dest , uint16 len)
+{
+	uint16 loc_start = (uint16)((ring->Tail + offset) % ring->Length);
+	uint16 loc_first_part = ring->Length - loc_start;
+
+	/****** copy in max two parts (ring wrap) ****/
+	if(len <= loc_first_part){
+		memcpy(dest , &ring->Buffer[loc_start] , len);
+	}else{
+		memcpy(dest , &ring->Buffer[loc_start] , loc_first_part);
+		memcpy(&dest[loc_first_part] , &ring->Buffer[0U] , len - loc_first_part);
+	}
+}
+
+/*****BL_Transport_VidFrameProgress
+**@param[in] ring receive ring , read index on the marker
+**@param[in] frame_buf destination buffer
+**@param[in] frame_len header + packet
+**@param[in] received bytes of the frame in the ring
+**/
+static void BL_Transport_VidFrameProgress(const Bl_Rx_Ring *ring , uint8 *frame_buf , uint16 frame_len , uint16 received)
+{
+	uint16 loc_crc_end = frame_len - BL_TRANSPORT_FRAME_CRC_LEN;
+	uint16 loc_crc_len = 0U;
+
+	/****** another frame (or a restarted ring / other buffer) : begin from its first byte ****/
+	if((ring != BL_Rx_Frame_Ring) || (ring->Tail != BL_Rx_Frame_Start) || (frame_buf != BL_Rx_Frame.Buffer) ||
+		(received < BL_Rx_Frame_Copied)){
+		BL_Rx_Frame_Ring = ring;
+		BL_Rx_Frame_Start = ring->Tail;
+		BL_Rx_Frame.Buffer = frame_buf;
+		BL_Rx_Frame_Copied = 0U;
+	}
+	if(received > frame_len){
+		received = frame_len;
+	}
+	if(received > BL_Rx_Frame_Copied){
+		BL_Transport_VidRxCopy(ring , (uint16)(BL_TRANSPORT_FRAME_SOF_LEN + BL_Rx_Frame_Copied) , &frame_buf[BL_Rx_Frame_Copied] ,
+													 (uint16)(received - BL_Rx_Frame_Copied));
+		if(BL_Rx_Frame_Copied < loc_crc_end){
+			loc_crc_len = (uint16)(((received < loc_crc_end) ? received : loc_crc_end) - BL_Rx_Frame_Copied);
+			/****** running value kept here , the CRC unit is free for commands between two polls ****/
+			if(0U == BL_Rx_Frame_Copied){
+				BL_Rx_Frame.Crc_Mode = BL_CRC_uint8GetMode();
+				BL_CRC_VidStart();
+			}else{
+				BL_CRC_VidResume(BL_Rx_Frame.Crc);
+			}
+			BL_CRC_VidAccumulate(&frame_buf[BL_Rx_Frame_Copied] , loc_crc_len);
+			BL_Rx_Frame.Crc = BL_CRC_uint32Finish();
+		}
+		BL_Rx_Frame_Copied = received;
+	}
+}
+
+/*****BL_Transport_VidFrameDecode
+**@param[in] frame_len header + packet
+**@param[in] header_len BL_TRANSPORT_FRAME_HEADER_LEN or BL_TRANSPORT_FRAME_EXT_HEADER_LEN
+**/
+static void BL_Transport_VidFrameDecode(uint16 frame_len , uint16 header_len)
+{
+	uint8 *loc_frame = BL_Rx_Frame.Buffer;
+
+	BL_Rx_Frame.Len = frame_len;
+	BL_Rx_Frame.Header_Len = header_len;
+	BL_Rx_Frame.Cmd = loc_frame[header_len];
+	BL_Rx_Frame.Info = &loc_frame[header_len + 1U];
+	BL_Rx_Frame.Info_Len = (uint16)(frame_len - header_len - 1U - BL_TRANSPORT_FRAME_CRC_LEN);
+	BL_Rx_Frame.Address = (BL_Rx_Frame.Info_Len >= 4U) ? BL_Transport_uint32GetLE(BL_Rx_Frame.Info) : 0U;
+	BL_Rx_Frame.Host_Crc = BL_Transport_uint32GetLE(&loc_frame[frame_len - BL_TRANSPORT_FRAME_CRC_LEN]);
+	/****** next frame starts from scratch even if it lands on the same ring index ****/
+	BL_Rx_Frame_Ring = NULL;
+	BL_Rx_Frame_Copied = 0U;
+}
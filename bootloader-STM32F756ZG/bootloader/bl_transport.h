@@ -0,0 +1,176 @@
+/// \file bl_transport.h
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host link abstraction : the command engine only talks to a Bl_Transport , the
+///        backend (UART or Ethernet on target , PTY or loopback UDP on a Linux host build) is selected
+///        at compile time.
+///        Also holds the frame parser shared by all ring based backends , it copies and CRCs a
+///        frame while its bytes arrive and hands the decoded header to the command engine.
+
+#ifndef BL_TRANSPORT_H
+#define BL_TRANSPORT_H
+/************** Global Includes**************/
+#include "LSTD_TYPES.h"
+#include <string.h>
+
+/*********** Macro declerations**********/
+// Available host links
+#define BL_TRANSPORT_UART														0x00			/* USART6 + DMA (target) */
+#define BL_TRANSPORT_SIM														0x01			/* Linux PTY (host build , see bootloader/sim) */
+#define BL_TRANSPORT_UDP														0x02			/* Ethernet MAC , UDP datagrams (target) */
+#define BL_TRANSPORT_SIM_UDP												0x03			/* Linux loopback UDP socket (host build) */
+
+#ifndef BL_HOST_TRANSPORT
+#define BL_HOST_TRANSPORT														(BL_TRANSPORT_UART)
+#endif
+
+// Every frame starts with a marker , bytes before it are dropped while hunting for next frame
+#define BL_TRANSPORT_FRAME_SOF											0xA5U
+#define BL_TRANSPORT_FRAME_SOF_LEN									1U
+
+// Frame header : legacy "len(1)" or extended "0x00 | len(2 , LE)" , len counts bytes after header
+#define BL_TRANSPORT_FRAME_EXTENDED_MARK						0x00U
+#define BL_TRANSPORT_FRAME_HEADER_LEN								1U
+#define BL_TRANSPORT_FRAME_EXT_HEADER_LEN						3U
+#define BL_TRANSPORT_FRAME_MIN_PACKET_LEN						5U				/* cmd code + crc */
+#define BL_TRANSPORT_FRAME_CRC_LEN									4U				/* crc32 (LE) ends every frame */
+
+// Line silent for this time inside a frame -> frame is dropped and receiver resyncs on next marker
+#define BL_TRANSPORT_INTER_BYTE_TIMEOUT_MS					20U
+
+// Frame fetch status
+#define BL_TRANSPORT_FRAME_NOT_READY								0x00
+#define BL_TRANSPORT_FRAME_READY										0x01
+#define BL_TRANSPORT_FRAME_TOO_LONG									0x02
+#define BL_TRANSPORT_FRAME_DROPPED									0x03			/* incomplete or corrupted header , resynced */
+
+// UDP links : one datagram carries whole frames (marker included) , replies go to the last sender
+#define BL_TRANSPORT_UDP_PORT												6000U
+#define BL_TRANSPORT_UDP_MAX_PAYLOAD								1472U			/* Ethernet MTU - IPv4 - UDP header , no fragments */
+
+// Flush mode
+#define BL_TRANSPORT_FLUSH_NO_WAIT									0x00			/* start transmission and return */
+#define BL_TRANSPORT_FLUSH_WAIT											0x01			/* return after last byte left the link */
+
+// Link start status
+#define BL_TRANSPORT_LINK_OK												0x00
+#define BL_TRANSPORT_LINK_FAILED										0x01			/* hardware did not come up , link stays silent */
+
+/*********** Data Type Declerations*****/
+/* receive ring of a backend , Head is refreshed by the backend before parsing */
+typedef struct tagS__Bl_Rx_Ring{
+	uint8		*Buffer;
+	uint16	Length;
+	uint16	Head;						// next write index
+	uint16	Tail;						// read index of command loop
+}Bl_Rx_Ring;
+
+/* last frame of the parser , decoded in place : all pointers point into the frame buffer */
+typedef struct tagS__Bl_Frame{
+	uint8		*Buffer;				// header | cmd code | info | crc
+	uint8		*Info;					// bytes after the cmd code
+	uint16	Len;						// header + packet
+	uint16	Header_Len;			// BL_TRANSPORT_FRAME_HEADER_LEN or BL_TRANSPORT_FRAME_EXT_HEADER_LEN
+	uint16	Info_Len;				// bytes between cmd code and crc
+	uint8		Cmd;
+	uint8		Crc_Mode;				// BL_CRC_MODE_xx Crc was calculated with
+	uint32	Address;				// first info word (LE) , commands with an address carry it first
+	uint32	Host_Crc;				// crc sent by host
+	uint32	Crc;						// CRC of header + cmd code + info , updated as the bytes arrived
+}Bl_Frame;
+
+/* operations every host link provides */
+typedef struct tagS__Bl_Transport{
+	uint8		(*Init)(void);																		// start reception , BL_TRANSPORT_LINK_xx
+	uint8		(*Receive)(uint8 *frame_buf , uint16 buf_len);					// BL_TRANSPORT_FRAME_xx , never blocks
+	void		(*Transmit)(const uint8 *data , uint16 len);						// gather reply bytes
+	void		(*Flush)(uint8 flush_mode);														// send gathered bytes
+	void		(*Poll)(void);																		// wait for next link event (max. ~1 ms)
+	uint16	(*MaxFrameSize)(void);																// biggest frame the link can buffer
+	void		(*DeInit)(void);																	// flush and stop link before leaving bootloader
+}Bl_Transport;
+
+/*********** Host link selection*****/
+#if BL_HOST_TRANSPORT == BL_TRANSPORT_SIM
+extern const Bl_Transport BL_Sim_Transport;
+#define BL_HOST_LINK																(&BL_Sim_Transport)
+#elif BL_HOST_TRANSPORT == BL_TRANSPORT_UDP
+extern const Bl_Transport BL_UDP_Transport;
+#define BL_HOST_LINK																(&BL_UDP_Transport)
+#elif BL_HOST_TRANSPORT == BL_TRANSPORT_SIM_UDP
+extern const Bl_Transport BL_Sim_UDP_Transport;
+#define BL_HOST_LINK																(&BL_Sim_UDP_Transport)
+#else
+extern const Bl_Transport BL_UART_Transport;
+#define BL_HOST_LINK																(&BL_UART_Transport)
+#endif
+
+/********* Software Function Prototype*******/
+/*****BL_Transport_VidSetExtendedFrames
+**@description
+	Enables parsing of extended (16 bit length) frames , legacy frames are always accepted.
+**@param[in] enable 0 -> legacy frames only , else legacy and extended frames
+**/
+void BL_Transport_VidSetExtendedFrames(uint8 enable);
+
+/*****BL_Transport_uint16RxAvailable
+**@param[in] ring receive ring
+**@return number of received bytes not yet consumed
+**/
+uint16 BL_Transport_uint16RxAvailable(const Bl_Rx_Ring *ring);
+
+/*****BL_Transport_uint8RxPeek
+**@param[in] ring receive ring
+**@param[in] offset offset from the read index
+**@return byte at read index + offset (not consumed)
+**/
+uint8 BL_Transport_uint8RxPeek(const Bl_Rx_Ring *ring , uint16 offset);
+
+/*****BL_Transport_VidRxRead
+**@param[in] ring receive ring
+**@param[in] dest destination buffer (NULL to drop data)
+**@param[in] len number of bytes to consume
+**/
+void BL_Transport_VidRxRead(Bl_Rx_Ring *ring , uint8 *dest , uint16 len);
+
+/*****BL_Transport_uint8FetchFrame
+**@description
+	Moves one complete "header + packet" frame (without marker) from the ring to frame_buf.
+	Bytes of a frame are copied and fed to the CRC unit on every call as they arrive , so the
+	frame CRC is known when the last byte lands (see BL_Transport_pGetFrame).
+	Resync : bytes up to the marker are skipped , a marker followed by an implausible length
+	or by a line silence is dropped and the search restarts behind it.
+**@param[in] ring receive ring (Head already refreshed)
+**@param[in] frame_buf destination buffer
+**@param[in] buf_len destination buffer size
+**@param[in] line_silent 1 if nothing arrived for BL_TRANSPORT_INTER_BYTE_TIMEOUT_MS
+**@return BL_TRANSPORT_FRAME_READY , BL_TRANSPORT_FRAME_NOT_READY , BL_TRANSPORT_FRAME_TOO_LONG or BL_TRANSPORT_FRAME_DROPPED
+**/
+uint8 BL_Transport_uint8FetchFrame(Bl_Rx_Ring *ring , uint8 *frame_buf , uint16 buf_len , uint8 line_silent);
+
+/*****BL_Transport_pGetFrame
+**@description
+	Header of the last BL_TRANSPORT_FRAME_READY frame , valid until the next frame is fetched
+	into the same buffer.
+**@return decoded frame
+**/
+const Bl_Frame *BL_Transport_pGetFrame(void);
+
+/*****BL_Transport_uint32GetLE
+**@param[in] data 4 bytes , any alignment
+**@return little endian word
+**/
+uint32 BL_Transport_uint32GetLE(const uint8 *data);
+
+/*****BL_Transport_uint8ReceiveTimeout
+**@description
+	Same as link->Receive but waits up to timeout_ms for the frame.
+**@param[in] link host link
+**@param[in] frame_buf destination buffer
+**@param[in] buf_len destination buffer size
+**@param[in] timeout_ms max. waiting time
+**@return BL_TRANSPORT_FRAME_READY , BL_TRANSPORT_FRAME_NOT_READY (timeout) , BL_TRANSPORT_FRAME_TOO_LONG or BL_TRANSPORT_FRAME_DROPPED
+**/
+uint8 BL_Transport_uint8ReceiveTimeout(const Bl_Transport *link , uint8 *frame_buf , uint16 buf_len , uint32 timeout_ms);
+
+#endif /*BL_TRANSPORT_H*/
@@ -0,0 +1,411 @@
+/// \file bl_uart.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host channel engine : circular DMA reception with idle line detection , gathered DMA
+///        transmission and baud rate control
+/// USART6 RX is served by DMA2 stream1 in circular mode, so the ring keeps
+/// filling while the command loop checks CRC or programs flash. Idle line,
+/// half and full transfer events only wake the CPU, the write position is
+/// always read back from the DMA counter.
+/// Replies are gathered (ACK + payload) and sent in one DMA2 stream7 transfer,
+/// completion is signalled by the transfer complete callback.
+/// Frame parsing is done by the shared transport parser on top of the DMA ring.
+/// Auto baud is armed with the ring and finished by the receive operation , the
+/// command loop (and the entry timeout to the application) never waits for it.
+
+
+/************Global Includes*************/
+#include "bl_uart.h"
+
+/********* Static Function Prototypes************/
+/*****BL_UART_uint16RxHead
+**@return ring index of the next byte written by DMA
+**/
+static uint16 BL_UART_uint16RxHead(void);
+
+/*****BL_UART_uint8Init
+**@description Init operation : starts reception , USART6 is already configured by CubeMX
+**@return BL_TRANSPORT_LINK_OK
+**/
+static uint8 BL_UART_uint8Init(void);
+
+/*****BL_UART_uint8Receive
+**@description Receive operation : refresh ring head and parse next frame
+**@param[in] frame_buf destination buffer
+**@param[in] buf_len destination buffer size
+**@return BL_TRANSPORT_FRAME_xx
+**/
+static uint8 BL_UART_uint8Receive(uint8 *frame_buf , uint16 buf_len);
+
+/*****BL_UART_VidFlush
+**@description Flush operation
+**@param[in] flush_mode BL_TRANSPORT_FLUSH_NO_WAIT or BL_TRANSPORT_FLUSH_WAIT
+**/
+static void BL_UART_VidFlush(uint8 flush_mode);
+
+/*****BL_UART_uint16MaxFrameSize
+**@return biggest frame the ring can hold
+**/
+static uint16 BL_UART_uint16MaxFrameSize(void);
+
+/*****BL_UART_VidDeInit
+**@description DeInit operation : last reply out , both DMA streams stopped
+**/
+static void BL_UART_VidDeInit(void);
+
+/*****BL_UART_VidRxTimeoutInit
+**@description arm receiver timeout for current baud rate
+**/
+static void BL_UART_VidRxTimeoutInit(void);
+
+/*****BL_UART_VidAutoBaudStep
+**@description
+	Finishes an armed auto baud once the hardware measured the first byte : a sync byte is
+	acknowledged at the detected rate , a measurement error , another byte or no byte within
+	BL_UART_AUTO_BAUD_TIMEOUT_MS fix the rate to BL_UART_DEFAULT_BAUD_RATE. Never waits.
+**/
+static void BL_UART_VidAutoBaudStep(void);
+
+/********* Global Variables Declerations************/
+static uint8 BL_Rx_Buf[BL_UART_RX_RING_LENGTH];			// written by DMA only
+static Bl_Rx_Ring BL_Rx_Ring = {BL_Rx_Buf , BL_UART_RX_RING_LENGTH , 0U , 0U};
+static volatile uint8 BL_Rx_Timeout = 0U;					// receiver timeout seen
+static volatile uint16 BL_Rx_Timeout_Head = 0U;			// ring head at receiver timeout
+static uint8 BL_Tx_Buf[BL_UART_TX_BUFFER_COUNT][BL_UART_TX_BUFFER_LENGTH];	// gather buffers
+static uint16 BL_Tx_Len = 0U;											// bytes gathered in fill buffer
+static uint8 BL_Tx_Fill_Index = 0U;								// buffer being gathered
+static volatile uint8 BL_Tx_Busy = 0U;						// DMA transmission running
+static uint8 BL_Auto_Baud_Armed = 0U;								// waiting for the sync byte measurement
+static uint32 BL_Auto_Baud_Tick = 0U;								// tick auto baud was armed at
+
+/* host link operations of USART6 */
+const Bl_Transport BL_UART_Transport = {
+	BL_UART_uint8Init,
+	BL_UART_uint8Receive,
+	BL_UART_VidTxWrite,
+	BL_UART_VidFlush,
+	BL_UART_VidWaitForData,
+	BL_UART_uint16MaxFrameSize,
+	BL_UART_VidDeInit
+};
+
+/********* Software Function Definition *******/
+/*****BL_UART_VidRxInit
+**@description start circular reception with idle line event
+**/
+void BL_UART_VidRxInit(void)
+{
+	BL_Rx_Ring.Head = 0U;
+	BL_Rx_Ring.Tail = 0U;
+	BL_Rx_Timeout = 0U;
+	/********* measurement of the first byte armed by MX_USART6_UART_Init , finished in receive *****/
+	if(UART_ADVFEATURE_AUTOBAUDRATE_ENABLE == (BL_UART_HOST_CHANNEL)->AdvancedInit.AutoBaudRateEnable){
+		BL_Auto_Baud_Armed = 1U;
+		BL_Auto_Baud_Tick = HAL_GetTick();
+	}
+	/********* DMA wraps by itself , reception never has to be re-armed *****/
+	if(HAL_OK != HAL_UARTEx_ReceiveToIdle_DMA(BL_UART_HOST_CHANNEL , BL_Rx_Buf , BL_UART_RX_RING_LENGTH)){
+		Error_Handler();
+	}
+	BL_UART_VidRxTimeoutInit();
+}
+
+/*****BL_UART_VidTxWrite
+**@param[in] data pointer to data
+**@param[in] len data length
+**/
+void BL_UART_VidTxWrite(const uint8 *data , uint16 len)
+{
+	uint16 loc_chunk = 0U;
+
+	while(len > 0U)
+	{
+		if(BL_UART_TX_BUFFER_LENGTH == BL_Tx_Len){
+			BL_UART_VidTxFlush();
+			if(BL_UART_TX_BUFFER_LENGTH == BL_Tx_Len){
+				/****** DMA could not be started , gathered data is kept for the next flush *****/
+				break;
+			}
+		}
+		loc_chunk = BL_UART_TX_BUFFER_LENGTH - BL_Tx_Len;
+		if(loc_chunk > len){
+			loc_chunk = len;
+		}
+		memcpy(&BL_Tx_Buf[BL_Tx_Fill_Index][BL_Tx_Len] , data , loc_chunk);
+		BL_Tx_Len = (uint16)(BL_Tx_Len + loc_chunk);
+		data = &data[loc_chunk];
+		len = (uint16)(len - loc_chunk);
+	}
+}
+
+/*****BL_UART_VidTxFlush
+**@description start DMA transmission of gathered data
+**/
+void BL_UART_VidTxFlush(void)
+{
+	HAL_StatusTypeDef loc_tx_status = HAL_ERROR;
+	uint32 loc_start_tick = 0U;
+
+	if(BL_Tx_Len > 0U){
+		/****** previous buffer must be on the wire completely before DMA is reused *****/
+		BL_UART_VidTxWaitIdle();
+		loc_start_tick = HAL_GetTick();
+		/****** HAL is busy while an interrupt restarts the reception , try again for a short while *****/
+		do{
+			BL_Tx_Busy = 1U;
+			loc_tx_status = HAL_UART_Transmit_DMA(BL_UART_HOST_CHANNEL , BL_Tx_Buf[BL_Tx_Fill_Index] , BL_Tx_Len);
+			if(HAL_OK != loc_tx_status){
+				BL_Tx_Busy = 0U;
+			}
+		}while((HAL_OK != loc_tx_status) && ((HAL_GetTick() - loc_start_tick) < BL_UART_TX_START_TIMEOUT_MS));
+		if(HAL_OK == loc_tx_status){
+			/****** gather next reply in the other buffer *****/
+			BL_Tx_Fill_Index = (uint8)((BL_Tx_Fill_Index + 1U) % BL_UART_TX_BUFFER_COUNT);
+			BL_Tx_Len = 0U;
+		}
+	}
+}
+
+/*****BL_UART_VidTxWaitIdle
+**@description wait for transmission complete callback
+**/
+void BL_UART_VidTxWaitIdle(void)
+{
+	while(0U != BL_Tx_Busy)
+	{
+	}
+}
+
+/*****HAL_UART_TxCpltCallback
+**@description last byte of a DMA transmission left the shift register
+**@param[in] huart uart handle
+**/
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+	if((BL_UART_HOST_CHANNEL)->Instance == huart->Instance){
+		BL_Tx_Busy = 0U;
+	}
+}
+
+/*****BL_UART_uint8CheckBaudRate
+**@param[in] baud_rate requested baud rate
+**@return BL_UART_BAUD_ACCEPTED if USART clock can generate it within tolerance else BL_UART_BAUD_REJECTED
+**/
+uint8 BL_UART_uint8CheckBaudRate(uint32 baud_rate)
+{
+	uint8 loc_baud_status = BL_UART_BAUD_REJECTED;
+	uint32 loc_uart_clk = HAL_RCC_GetPCLK2Freq();
+	uint32 loc_brr = 0U;
+	uint32 loc_actual_baud = 0U;
+	uint32 loc_deviation = 0U;
+
+	if(baud_rate >= BL_UART_MIN_BAUD_RATE){
+		/****** oversampling by 16 -> BRR = clk / baud , min. 16 ******/
+		loc_brr = (loc_uart_clk + (baud_rate / 2U)) / baud_rate;
+		if((loc_brr >= 16U) && (loc_brr <= 0xFFFFU)){
+			loc_actual_baud = loc_uart_clk / loc_brr;
+			loc_deviation = (loc_actual_baud > baud_rate) ? (loc_actual_baud - baud_rate) : (baud_rate - loc_actual_baud);
+			if(((uint64)loc_deviation * 1000U) <= ((uint64)baud_rate * BL_UART_MAX_BAUD_ERROR_PERMILLE)){
+				loc_baud_status = BL_UART_BAUD_ACCEPTED;
+			}
+		}
+	}
+	return loc_baud_status;
+}
+
+/*****BL_UART_uint8SetBaudRate
+**@param[in] baud_rate new baud rate
+**@return BL_UART_BAUD_ACCEPTED or BL_UART_BAUD_REJECTED
+**/
+uint8 BL_UART_uint8SetBaudRate(uint32 baud_rate)
+{
+	uint8 loc_baud_status = BL_UART_uint8CheckBaudRate(baud_rate);
+
+	if(BL_UART_BAUD_ACCEPTED == loc_baud_status){
+		/******* pending reply still goes out at the old rate *****/
+		BL_UART_VidTxFlush();
+		BL_UART_VidTxWaitIdle();
+		/******* stop ring , reprogram BRR (gState is ready so MSP/DMA config is kept) and restart ring *****/
+		(void)HAL_UART_AbortReceive(BL_UART_HOST_CHANNEL);
+		(BL_UART_HOST_CHANNEL)->Init.BaudRate = baud_rate;
+		/******* fixed rate from now on , auto baud must not measure next byte again ****/
+		(BL_UART_HOST_CHANNEL)->AdvancedInit.AutoBaudRateEnable = UART_ADVFEATURE_AUTOBAUDRATE_DISABLE;
+		if(HAL_OK != HAL_UART_Init(BL_UART_HOST_CHANNEL)){
+			loc_baud_status = BL_UART_BAUD_REJECTED;
+		}
+		BL_UART_VidRxInit();
+	}
+	return loc_baud_status;
+}
+
+/*****BL_UART_uint32GetBaudRate
+**@return current baud rate of host channel
+**/
+uint32 BL_UART_uint32GetBaudRate(void)
+{
+	return (BL_UART_HOST_CHANNEL)->Init.BaudRate;
+}
+
+/*****BL_UART_VidWaitForData
+**@description sleep until next interrupt (idle line , DMA half/full or systick)
+**/
+void BL_UART_VidWaitForData(void)
+{
+	__WFI();
+}
+
+/*****BL_UART_VidRxTimeoutIRQ
+**@description line silent for BL_TRANSPORT_INTER_BYTE_TIMEOUT_MS , remember where the ring stopped
+**/
+void BL_UART_VidRxTimeoutIRQ(void)
+{
+	if(SET == __HAL_UART_GET_FLAG(BL_UART_HOST_CHANNEL , UART_FLAG_RTOF)){
+		__HAL_UART_CLEAR_FLAG(BL_UART_HOST_CHANNEL , UART_CLEAR_RTOF);
+		BL_Rx_Timeout_Head = BL_UART_uint16RxHead();
+		BL_Rx_Timeout = 1U;
+	}
+}
+
+/*****HAL_UART_ErrorCallback
+**@description overrun aborts the DMA reception in HAL , restart the ring
+**@param[in] huart uart handle
+**/
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+	if((BL_UART_HOST_CHANNEL)->Instance == huart->Instance){
+		if(HAL_UART_STATE_READY == huart->RxState){
+			BL_UART_VidRxInit();
+		}
+	}
+}
+
+/********* Static Function Definitions************/
+/*****BL_UART_uint16RxHead
+**@return ring index of the next byte written by DMA
+**/
+static uint16 BL_UART_uint16RxHead(void)
+{
+	/****** NDTR counts down from ring length and reloads in circular mode ***/
+	uint16 loc_remaining = (uint16)__HAL_DMA_GET_COUNTER((BL_UART_HOST_CHANNEL)->hdmarx);
+	return (uint16)((BL_UART_RX_RING_LENGTH - loc_remaining) % BL_UART_RX_RING_LENGTH);
+}
+
+/*****BL_UART_VidRxTimeoutInit
+**@description arm receiver timeout for current baud rate
+**/
+static void BL_UART_VidRxTimeoutInit(void)
+{
+	UART_HandleTypeDef *loc_huart = BL_UART_HOST_CHANNEL;
+	/****** RTOR counts bit times , keep the same silence time at every rate ****/
+	uint32 loc_timeout_bits = (uint32)(((uint64)loc_huart->Init.BaudRate * BL_TRANSPORT_INTER_BYTE_TIMEOUT_MS) / 1000U);
+
+	if(loc_timeout_bits > USART_RTOR_RTO){
+		loc_timeout_bits = USART_RTOR_RTO;
+	}
+	HAL_UART_ReceiverTimeout_Config(loc_huart , loc_timeout_bits);
+	SET_BIT(loc_huart->Instance->CR2 , USART_CR2_RTOEN);
+	__HAL_UART_CLEAR_FLAG(loc_huart , UART_CLEAR_RTOF);
+	__HAL_UART_ENABLE_IT(loc_huart , UART_IT_RTO);
+}
+
+/*****BL_UART_uint8Init
+**@return BL_TRANSPORT_LINK_OK
+**/
+static uint8 BL_UART_uint8Init(void)
+{
+	BL_UART_VidRxInit();
+	return BL_TRANSPORT_LINK_OK;
+}
+
+/*****BL_UART_uint8Receive
+**@param[in] frame_buf destination buffer
+**@param[in] buf_len destination buffer size
+**@return BL_TRANSPORT_FRAME_xx
+**/
+static uint8 BL_UART_uint8Receive(uint8 *frame_buf , uint16 buf_len)
+{
+	uint8 loc_line_silent = 0U;
+
+	if(0U != BL_Auto_Baud_Armed){
+		BL_UART_VidAutoBaudStep();
+	}
+	BL_Rx_Ring.Head = BL_UART_uint16RxHead();
+	/******* timeout is only valid if nothing arrived after it *****/
+	if(0U != BL_Rx_Timeout){
+		BL_Rx_Timeout = 0U;
+		loc_line_silent = (BL_Rx_Timeout_Head == BL_Rx_Ring.Head) ? 1U : 0U;
+	}
+	return BL_Transport_uint8FetchFrame(&BL_Rx_Ring , frame_buf , buf_len , loc_line_silent);
+}
+
+/*****BL_UART_VidFlush
+**@param[in] flush_mode BL_TRANSPORT_FLUSH_NO_WAIT or BL_TRANSPORT_FLUSH_WAIT
+**/
+static void BL_UART_VidFlush(uint8 flush_mode)
+{
+	BL_UART_VidTxFlush();
+	if(BL_TRANSPORT_FLUSH_WAIT == flush_mode){
+		BL_UART_VidTxWaitIdle();
+	}
+}
+
+/*****BL_UART_uint16MaxFrameSize
+**@return biggest frame the ring can hold
+**/
+static uint16 BL_UART_uint16MaxFrameSize(void)
+{
+	/****** one frame must never fill the whole ring (head == tail means empty) ****/
+	return (uint16)(BL_UART_RX_RING_LENGTH - BL_TRANSPORT_FRAME_SOF_LEN - 1U);
+}
+
+/*****BL_UART_VidDeInit
+**@description last reply out , both DMA streams stopped
+**/
+static void BL_UART_VidDeInit(void)
+{
+	BL_UART_VidFlush(BL_TRANSPORT_FLUSH_WAIT);
+	/****** circular RX DMA would keep writing into RAM owned by the application ****/
+	(void)HAL_UART_Abort(BL_UART_HOST_CHANNEL);
+	(void)HAL_UART_DeInit(BL_UART_HOST_CHANNEL);
+}
+
+/*****BL_UART_VidAutoBaudStep
+**/
+static void BL_UART_VidAutoBaudStep(void)
+{
+	UART_HandleTypeDef *loc_huart = BL_UART_HOST_CHANNEL;
+	uint8 loc_sync_status = BL_UART_BAUD_REJECTED;
+	uint8 loc_sync_ack = BL_UART_AUTO_BAUD_SYNC_ACK;
+
+	/******* ABRF is set as soon as the first byte is measured , no extra round trip ******/
+	if(RESET == __HAL_UART_GET_FLAG(loc_huart , UART_FLAG_ABRF)){
+		if((HAL_GetTick() - BL_Auto_Baud_Tick) >= BL_UART_AUTO_BAUD_TIMEOUT_MS){
+			/******* no host , continue at default rate *****/
+			BL_Auto_Baud_Armed = 0U;
+			(void)BL_UART_uint8SetBaudRate(BL_UART_DEFAULT_BAUD_RATE);
+		}
+	}else if(SET == __HAL_UART_GET_FLAG(loc_huart , UART_FLAG_ABRE)){
+		BL_Auto_Baud_Armed = 0U;
+		(void)BL_UART_uint8SetBaudRate(BL_UART_DEFAULT_BAUD_RATE);
+	}else{
+		/******* sync byte itself is received at the measured rate and lands in the ring *****/
+		BL_Rx_Ring.Head = BL_UART_uint16RxHead();
+		if(BL_Transport_uint16RxAvailable(&BL_Rx_Ring) > 0U){
+			BL_Auto_Baud_Armed = 0U;
+			if(BL_UART_AUTO_BAUD_SYNC_BYTE == BL_Transport_uint8RxPeek(&BL_Rx_Ring , 0U)){
+				BL_Transport_VidRxRead(&BL_Rx_Ring , NULL , 1U);
+				/******* keep handle in line with BRR , measurement is done : a ring restart must not arm it again ****/
+				loc_huart->Init.BaudRate = HAL_RCC_GetPCLK2Freq() / loc_huart->Instance->BRR;
+				loc_huart->AdvancedInit.AutoBaudRateEnable = UART_ADVFEATURE_AUTOBAUDRATE_DISABLE;
+				BL_UART_VidRxTimeoutInit();
+				BL_UART_VidTxWrite(&loc_sync_ack , 1U);
+				BL_UART_VidTxFlush();
+				loc_sync_status = BL_UART_BAUD_ACCEPTED;
+			}
+			if(BL_UART_BAUD_ACCEPTED != loc_sync_status){
+				/******* not a sync byte , continue at default rate with an empty ring *****/
+				(void)BL_UART_uint8SetBaudRate(BL_UART_DEFAULT_BAUD_RATE);
+			}
+		}
+	}
+}
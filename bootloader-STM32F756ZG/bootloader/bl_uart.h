@@ -0,0 +1,106 @@
+/// \file bl_uart.h
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host channel engine : circular DMA reception with idle line detection , gathered DMA
+///        transmission and baud rate control. Exported to the command engine as BL_UART_Transport
+
+#ifndef BL_UART_H
+#define BL_UART_H
+/************** Global Includes**************/
+#include "LSTD_TYPES.h"
+#include <string.h>
+#include "usart.h"
+#include "bl_transport.h"
+
+/*********** Macro declerations**********/
+// UART connected to the host
+#define BL_UART_HOST_CHANNEL												&huart6
+
+// Receive ring filled by circular DMA (must hold several host frames , also extended ones)
+#define BL_UART_RX_RING_LENGTH											16384U
+
+// Transmit gather buffers (one is filled while the other is sent by DMA)
+#define BL_UART_TX_BUFFER_LENGTH										512U
+#define BL_UART_TX_BUFFER_COUNT											2U
+#define BL_UART_TX_START_TIMEOUT_MS									10U				/* DMA start retried this long , data kept if it fails */
+
+// Baud rate limits of host channel (USART6 on PCLK2 , oversampling by 16)
+#define BL_UART_MIN_BAUD_RATE												9600U
+#define BL_UART_MAX_BAUD_ERROR_PERMILLE							20U				/* 2% max. deviation */
+#define BL_UART_BAUD_REJECTED												0x00
+#define BL_UART_BAUD_ACCEPTED												0x01
+
+// Auto baud on entry : host sends 0x7F , hardware measures it , bootloader answers 0x79 at detected rate
+#define BL_UART_DEFAULT_BAUD_RATE										115200U		/* fixed rate if no sync byte arrives */
+#define BL_UART_AUTO_BAUD_TIMEOUT_MS								5000U			/* measurement stays armed , nothing waits for it */
+#define BL_UART_AUTO_BAUD_SYNC_BYTE									0x7FU
+#define BL_UART_AUTO_BAUD_SYNC_ACK									0x79U
+
+/********* Software Function Prototype*******/
+/*****BL_UART_VidRxInit
+**@description
+	Starts the circular DMA reception into the ring buffer with idle line events.
+	Init operation of BL_UART_Transport. While the USART auto baud rate hardware is enabled
+	(MX_USART6_UART_Init) the receive operation waits for the host sync byte on the side : it is
+	acknowledged at the detected rate , on timeout , measurement error or another byte the host
+	channel falls back to BL_UART_DEFAULT_BAUD_RATE.
+**/
+void BL_UART_VidRxInit(void);
+
+/*****BL_UART_VidTxWrite
+**@description
+	Transmit operation of BL_UART_Transport.
+	Appends data to the transmit gather buffer , nothing is sent before BL_UART_VidTxFlush
+	(or when the gather buffer is full).
+**@param[in] data pointer to data
+**@param[in] len data length
+**/
+void BL_UART_VidTxWrite(const uint8 *data , uint16 len);
+
+/*****BL_UART_VidTxFlush
+**@description
+	Starts DMA transmission of gathered data and returns at once , next reply is gathered
+	in the other buffer. Waits only if the previous transmission is still running.
+	If the DMA transfer can not be started the data stays gathered and goes out with the next flush.
+**/
+void BL_UART_VidTxFlush(void);
+
+/*****BL_UART_VidTxWaitIdle
+**@description
+	Waits until the last gathered byte left the shift register (before baud change or jump).
+**/
+void BL_UART_VidTxWaitIdle(void);
+
+/*****BL_UART_uint8CheckBaudRate
+**@param[in] baud_rate requested baud rate
+**@return BL_UART_BAUD_ACCEPTED if USART clock can generate it within tolerance else BL_UART_BAUD_REJECTED
+**/
+uint8 BL_UART_uint8CheckBaudRate(uint32 baud_rate);
+
+/*****BL_UART_uint8SetBaudRate
+**@description
+	Reprograms the host channel baud rate and restarts reception. Bytes pending in the ring are dropped.
+**@param[in] baud_rate new baud rate
+**@return BL_UART_BAUD_ACCEPTED or BL_UART_BAUD_REJECTED
+**/
+uint8 BL_UART_uint8SetBaudRate(uint32 baud_rate);
+
+/*****BL_UART_uint32GetBaudRate
+**@return current baud rate of host channel
+**/
+uint32 BL_UART_uint32GetBaudRate(void);
+
+/*****BL_UART_VidRxTimeoutIRQ
+**@description
+	Receiver timeout (line silent for BL_TRANSPORT_INTER_BYTE_TIMEOUT_MS) , called from USART6_IRQHandler
+	before HAL sees the flag (HAL would abort the DMA reception).
+**/
+void BL_UART_VidRxTimeoutIRQ(void);
+
+/*****BL_UART_VidWaitForData
+**@description
+	Sleeps until the next UART/DMA event (or systick). Poll operation of BL_UART_Transport.
+**/
+void BL_UART_VidWaitForData(void);
+
+#endif /*BL_UART_H*/
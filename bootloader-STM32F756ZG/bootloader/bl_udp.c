@@ -0,0 +1,652 @@
+/// \file bl_udp.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host channel over Ethernet : register level MAC/DMA driver with a minimal ARP , ICMP echo
+///        and UDP responder
+/// Every UDP datagram to BL_TRANSPORT_UDP_PORT carries whole frames in the
+/// UART format (marker included), its payload is appended to a ring and
+/// parsed by the shared transport parser. Replies are gathered behind
+/// prebuilt Ethernet/IP/UDP headers and sent to the last sender, the MAC
+/// inserts IP and UDP checksums. Frames are polled from the DMA descriptors
+/// (no interrupt), a full ring leaves descriptors with the CPU so the MAC
+/// drops further frames and the window write go-back-N resends them.
+/// The ETH pins are already configured by MX_GPIO_Init (CubeMX RMII pinout).
+
+
+/************Global Includes*************/
+#include "bl_udp.h"
+
+/********* Static Function Prototypes************/
+/*****BL_UDP_uint8Init
+**@description Init operation : MAC , DMA and PHY start up
+**@return BL_TRANSPORT_LINK_OK or BL_TRANSPORT_LINK_FAILED (no PHY reference clock)
+**/
+static uint8 BL_UDP_uint8Init(void);
+
+/*****BL_UDP_uint8Receive
+**@description Receive operation : drain DMA descriptors and parse next frame
+**@param[in] frame_buf destination buffer
+**@param[in] buf_len destination buffer size
+**@return BL_TRANSPORT_FRAME_xx
+**/
+static uint8 BL_UDP_uint8Receive(uint8 *frame_buf , uint16 buf_len);
+
+/*****BL_UDP_VidTransmit
+**@description Transmit operation : gather reply payload behind the UDP header
+**@param[in] data pointer to data
+**@param[in] len data length
+**/
+static void BL_UDP_VidTransmit(const uint8 *data , uint16 len);
+
+/*****BL_UDP_VidFlush
+**@description Flush operation : send gathered payload as one datagram
+**@param[in] flush_mode BL_TRANSPORT_FLUSH_NO_WAIT or BL_TRANSPORT_FLUSH_WAIT
+**/
+static void BL_UDP_VidFlush(uint8 flush_mode);
+
+/*****BL_UDP_VidPoll
+**@description Poll operation : sleep until systick , bring up MAC once the link is up
+**/
+static void BL_UDP_VidPoll(void);
+
+/*****BL_UDP_uint16MaxFrameSize
+**@return biggest frame (without marker) that fits one datagram
+**/
+static uint16 BL_UDP_uint16MaxFrameSize(void);
+
+/*****BL_UDP_VidDeInit
+**@description DeInit operation : last reply out , DMA and MAC stopped and reset
+**/
+static void BL_UDP_VidDeInit(void);
+
+/*****BL_UDP_uint16PhyRead
+**@param[in] phy_reg PHY register
+**@return register value (0xFFFF on MDIO timeout)
+**/
+static uint16 BL_UDP_uint16PhyRead(uint8 phy_reg);
+
+/*****BL_UDP_VidPhyWrite
+**@param[in] phy_reg PHY register
+**@param[in] value register value
+**/
+static void BL_UDP_VidPhyWrite(uint8 phy_reg , uint16 value);
+
+/*****BL_UDP_VidLinkCheck
+**@description applies negotiated speed/duplex to the MAC once the PHY reports link
+**/
+static void BL_UDP_VidLinkCheck(void);
+
+/*****BL_UDP_VidDescInit
+**@description chains RX descriptors (owned by DMA) and TX descriptors (owned by CPU)
+**/
+static void BL_UDP_VidDescInit(void);
+
+/*****BL_UDP_VidRxProcess
+**@description handles every frame the DMA has finished , as long as the ring has room
+**/
+static void BL_UDP_VidRxProcess(void);
+
+/*****BL_UDP_VidHandleArp
+**@param[in] frame received Ethernet frame
+**@param[in] len frame length without CRC
+**/
+static void BL_UDP_VidHandleArp(const uint8 *frame , uint16 len);
+
+/*****BL_UDP_VidHandleIp
+**@param[in] frame received Ethernet frame
+**@param[in] len frame length without CRC
+**/
+static void BL_UDP_VidHandleIp(const uint8 *frame , uint16 len);
+
+/*****BL_UDP_pTxAcquire
+**@return buffer of next TX descriptor (waits until the DMA released it) , NULL after BL_UDP_TX_TIMEOUT_MS
+**/
+static uint8 *BL_UDP_pTxAcquire(void);
+
+/*****BL_UDP_VidTxStart
+**@param[in] frame_len Ethernet frame length (MAC adds padding and CRC)
+**/
+static void BL_UDP_VidTxStart(uint16 frame_len);
+
+/*****BL_UDP_uint16Get
+**@return big endian 16 bit value at data
+**/
+static uint16 BL_UDP_uint16Get(const uint8 *data);
+
+/*****BL_UDP_VidPut16
+**@description stores value big endian at data
+**/
+static void BL_UDP_VidPut16(uint8 *data , uint16 value);
+
+/********* Global Variables Declerations************/
+static Bl_Eth_Desc BL_Eth_Rx_Desc[BL_UDP_RX_DESC_COUNT];
+static Bl_Eth_Desc BL_Eth_Tx_Desc[BL_UDP_TX_DESC_COUNT];
+static uint8 BL_Eth_Rx_Buf[BL_UDP_RX_DESC_COUNT][BL_UDP_BUFFER_LENGTH] __attribute__((aligned(4)));
+static uint8 BL_Eth_Tx_Buf[BL_UDP_TX_DESC_COUNT][BL_UDP_BUFFER_LENGTH] __attribute__((aligned(4)));
+static uint8 BL_Eth_Rx_Index = 0U;									// next RX descriptor to check
+static uint8 BL_Eth_Tx_Index = 0U;									// next TX descriptor to fill
+static uint8 BL_Eth_Link_Up = 0U;										// MAC configured for negotiated link
+static uint8 BL_Eth_Ready = 0U;											// MAC and DMA came out of reset
+
+static uint8 BL_Udp_Ring_Buf[BL_UDP_RX_RING_LENGTH];
+static Bl_Rx_Ring BL_Udp_Rx_Ring = {BL_Udp_Ring_Buf , BL_UDP_RX_RING_LENGTH , 0U , 0U};
+static uint32 BL_Udp_Last_Rx_Tick = 0U;							// tick of last host datagram
+static uint16 BL_Udp_Tx_Len = 0U;										// reply payload gathered
+static uint16 BL_Udp_Ip_Id = 0U;										// IPv4 identification
+
+static const uint8 BL_Local_Mac[6U] = BL_UDP_MAC_ADDR;
+static const uint8 BL_Local_Ip[4U] = BL_UDP_IP_ADDR;
+static uint8 BL_Peer_Mac[6U] = {0U};
+static uint8 BL_Peer_Ip[4U] = {0U};
+static uint16 BL_Peer_Port = 0U;
+static uint8 BL_Peer_Valid = 0U;										// a host datagram was received
+
+/* host link operations of the Ethernet MAC */
+const Bl_Transport BL_UDP_Transport = {
+	BL_UDP_uint8Init,
+	BL_UDP_uint8Receive,
+	BL_UDP_VidTransmit,
+	BL_UDP_VidFlush,
+	BL_UDP_VidPoll,
+	BL_UDP_uint16MaxFrameSize,
+	BL_UDP_VidDeInit
+};
+
+/********* Static Function Definitions************/
+/*****BL_UDP_uint8Init
+**@description MAC , DMA and PHY start up
+**@return BL_TRANSPORT_LINK_OK or BL_TRANSPORT_LINK_FAILED (no PHY reference clock)
+**/
+static uint8 BL_UDP_uint8Init(void)
+{
+	uint32 loc_start_tick = 0U;
+
+	BL_Eth_Ready = 0U;
+	BL_Eth_Link_Up = 0U;
+	BL_Peer_Valid = 0U;
+	/****** RMII must be selected while the MAC is still in reset ****/
+	SET_BIT(RCC->APB2ENR , RCC_APB2ENR_SYSCFGEN);
+	(void)READ_BIT(RCC->APB2ENR , RCC_APB2ENR_SYSCFGEN);
+	SET_BIT(RCC->AHB1RSTR , RCC_AHB1RSTR_ETHMACRST);
+	SET_BIT(SYSCFG->PMC , SYSCFG_PMC_MII_RMII_SEL);
+	CLEAR_BIT(RCC->AHB1RSTR , RCC_AHB1RSTR_ETHMACRST);
+	SET_BIT(RCC->AHB1ENR , RCC_AHB1ENR_ETHMACEN | RCC_AHB1ENR_ETHMACTXEN | RCC_AHB1ENR_ETHMACRXEN);
+	(void)READ_BIT(RCC->AHB1ENR , RCC_AHB1ENR_ETHMACEN);
+
+	/****** DMA software reset completes only with the PHY reference clock running ****/
+	SET_BIT(ETH->DMABMR , ETH_DMABMR_SR);
+	loc_start_tick = HAL_GetTick();
+	while(0U != READ_BIT(ETH->DMABMR , ETH_DMABMR_SR))
+	{
+		if((HAL_GetTick() - loc_start_tick) > BL_UDP_MAC_RESET_TIMEOUT_MS){
+			/****** without the clock the MAC stays silent , the boot entry timeout still starts the application ****/
+			CLEAR_BIT(RCC->AHB1ENR , RCC_AHB1ENR_ETHMACEN | RCC_AHB1ENR_ETHMACTXEN | RCC_AHB1ENR_ETHMACRXEN);
+			return BL_TRANSPORT_LINK_FAILED;
+		}
+	}
+	/****** MDC must stay below 2.5 MHz : HCLK 216 MHz / 102 ****/
+	ETH->MACMIIAR = ETH_MACMIIAR_CR_Div102;
+
+	/****** PHY reset , auto negotiation starts by itself afterwards ****/
+	BL_UDP_VidPhyWrite(0x00U , 0x8000U);
+	loc_start_tick = HAL_GetTick();
+	while((0U != (BL_UDP_uint16PhyRead(0x00U) & 0x8000U)) && ((HAL_GetTick() - loc_start_tick) < BL_UDP_PHY_RESET_TIMEOUT_MS))
+	{
+	}
+
+	/****** station address , perfect unicast + broadcast filter (MACFFR reset value) ****/
+	ETH->MACA0HR = ((uint32)BL_Local_Mac[5U] << 8U) | (uint32)BL_Local_Mac[4U];
+	ETH->MACA0LR = ((uint32)BL_Local_Mac[3U] << 24U) | ((uint32)BL_Local_Mac[2U] << 16U) |
+								 ((uint32)BL_Local_Mac[1U] << 8U) | (uint32)BL_Local_Mac[0U];
+
+	/****** store and forward both ways , frames with IP/UDP checksum errors are dropped ****/
+	ETH->DMAOMR = ETH_DMAOMR_RSF | ETH_DMAOMR_TSF;
+	ETH->DMABMR = ETH_DMABMR_EDE | ETH_DMABMR_AAB | ETH_DMABMR_FB | ETH_DMABMR_USP |
+								ETH_DMABMR_PBL_32Beat | ETH_DMABMR_RDP_32Beat;
+	BL_UDP_VidDescInit();
+	BL_Udp_Rx_Ring.Head = 0U;
+	BL_Udp_Rx_Ring.Tail = 0U;
+	BL_Udp_Tx_Len = 0U;
+	BL_Eth_Ready = 1U;
+
+	/****** wait for first link , later links are picked up by poll ****/
+	loc_start_tick = HAL_GetTick();
+	while((0U == BL_Eth_Link_Up) && ((HAL_GetTick() - loc_start_tick) < BL_UDP_PHY_LINK_TIMEOUT_MS))
+	{
+		BL_UDP_VidLinkCheck();
+	}
+	BL_Udp_Last_Rx_Tick = HAL_GetTick();
+	return BL_TRANSPORT_LINK_OK;
+}
+
+/*****BL_UDP_uint8Receive
+**@param[in] frame_buf destination buffer
+**@param[in] buf_len destination buffer size
+**@return BL_TRANSPORT_FRAME_xx
+**/
+static uint8 BL_UDP_uint8Receive(uint8 *frame_buf , uint16 buf_len)
+{
+	uint8 loc_line_silent = 0U;
+
+	if(0U == BL_Eth_Ready){
+		return BL_TRANSPORT_FRAME_NOT_READY;
+	}
+	BL_UDP_VidRxProcess();
+	/****** frames never span datagrams , a rest left after a silence is a broken frame ****/
+	if((HAL_GetTick() - BL_Udp_Last_Rx_Tick) >= BL_TRANSPORT_INTER_BYTE_TIMEOUT_MS){
+		loc_line_silent = 1U;
+	}
+	return BL_Transport_uint8FetchFrame(&BL_Udp_Rx_Ring , frame_buf , buf_len , loc_line_silent);
+}
+
+/*****BL_UDP_VidTransmit
+**@param[in] data pointer to data
+**@param[in] len data length
+**/
+static void BL_UDP_VidTransmit(const uint8 *data , uint16 len)
+{
+	uint8 *loc_buf = NULL;
+	uint16 loc_chunk = 0U;
+
+	while(len > 0U)
+	{
+		if(BL_TRANSPORT_UDP_MAX_PAYLOAD == BL_Udp_Tx_Len){
+			BL_UDP_VidFlush(BL_TRANSPORT_FLUSH_NO_WAIT);
+		}
+		loc_buf = BL_UDP_pTxAcquire();
+		if(NULL == loc_buf){
+			/****** DMA stuck on the descriptor , the reply is lost and the host resends ****/
+			BL_Udp_Tx_Len = 0U;
+			break;
+		}
+		loc_chunk = BL_TRANSPORT_UDP_MAX_PAYLOAD - BL_Udp_Tx_Len;
+		if(loc_chunk > len){
+			loc_chunk = len;
+		}
+		memcpy(&loc_buf[BL_UDP_HEADERS_LEN + BL_Udp_Tx_Len] , data , loc_chunk);
+		BL_Udp_Tx_Len = (uint16)(BL_Udp_Tx_Len + loc_chunk);
+		data = &data[loc_chunk];
+		len = (uint16)(len - loc_chunk);
+	}
+}
+
+/*****BL_UDP_VidFlush
+**@param[in] flush_mode BL_TRANSPORT_FLUSH_NO_WAIT or BL_TRANSPORT_FLUSH_WAIT
+**/
+static void BL_UDP_VidFlush(uint8 flush_mode)
+{
+	uint8 *loc_buf = NULL;
+	uint8 *loc_ip = NULL;
+	uint8 *loc_udp = NULL;
+	uint8 loc_index = 0U;
+	uint32 loc_start_tick = 0U;
+
+	if((BL_Udp_Tx_Len > 0U) && (0U != BL_Peer_Valid)){
+		loc_buf = BL_UDP_pTxAcquire();
+	}
+	if(NULL != loc_buf){
+		loc_ip = &loc_buf[BL_UDP_ETH_HEADER_LEN];
+		loc_udp = &loc_ip[BL_UDP_IP_HEADER_LEN];
+		/****** Ethernet header ****/
+		memcpy(&loc_buf[0U] , BL_Peer_Mac , 6U);
+		memcpy(&loc_buf[6U] , BL_Local_Mac , 6U);
+		BL_UDP_VidPut16(&loc_buf[12U] , BL_UDP_ETH_TYPE_IP);
+		/****** IPv4 header , checksum is inserted by the MAC ****/
+		loc_ip[0U] = 0x45U;
+		loc_ip[1U] = 0x00U;
+		BL_UDP_VidPut16(&loc_ip[2U] , (uint16)(BL_UDP_IP_HEADER_LEN + BL_UDP_UDP_HEADER_LEN + BL_Udp_Tx_Len));
+		BL_UDP_VidPut16(&loc_ip[4U] , BL_Udp_Ip_Id++);
+		BL_UDP_VidPut16(&loc_ip[6U] , 0x4000U);				/* don't fragment */
+		loc_ip[8U] = BL_UDP_IP_TTL;
+		loc_ip[9U] = BL_UDP_IP_PROTO_UDP;
+		BL_UDP_VidPut16(&loc_ip[10U] , 0U);
+		memcpy(&loc_ip[12U] , BL_Local_Ip , 4U);
+		memcpy(&loc_ip[16U] , BL_Peer_Ip , 4U);
+		/****** UDP header , checksum is inserted by the MAC ****/
+		BL_UDP_VidPut16(&loc_udp[0U] , BL_TRANSPORT_UDP_PORT);
+		BL_UDP_VidPut16(&loc_udp[2U] , BL_Peer_Port);
+		BL_UDP_VidPut16(&loc_udp[4U] , (uint16)(BL_UDP_UDP_HEADER_LEN + BL_Udp_Tx_Len));
+		BL_UDP_VidPut16(&loc_udp[6U] , 0U);
+		BL_UDP_VidTxStart((uint16)(BL_UDP_HEADERS_LEN + BL_Udp_Tx_Len));
+	}
+	/****** without a known host or a free descriptor the reply has nowhere to go ****/
+	BL_Udp_Tx_Len = 0U;
+	if(BL_TRANSPORT_FLUSH_WAIT == flush_mode){
+		loc_start_tick = HAL_GetTick();
+		for(loc_index = 0U ; loc_index < BL_UDP_TX_DESC_COUNT ; loc_index++)
+		{
+			while((0U != (BL_Eth_Tx_Desc[loc_index].Status & BL_UDP_DESC_OWN)) &&
+						((HAL_GetTick() - loc_start_tick) <= BL_UDP_TX_TIMEOUT_MS))
+			{
+			}
+		}
+	}
+}
+
+/*****BL_UDP_VidPoll
+**@description sleep until systick , bring up MAC once the link is up
+**/
+static void BL_UDP_VidPoll(void)
+{
+	if((0U != BL_Eth_Ready) && (0U == BL_Eth_Link_Up)){
+		BL_UDP_VidLinkCheck();
+	}
+	__WFI();
+}
+
+/*****BL_UDP_uint16MaxFrameSize
+**@return biggest frame (without marker) that fits one datagram
+**/
+static uint16 BL_UDP_uint16MaxFrameSize(void)
+{
+	return (uint16)(BL_TRANSPORT_UDP_MAX_PAYLOAD - BL_TRANSPORT_FRAME_SOF_LEN);
+}
+
+/*****BL_UDP_VidDeInit
+**@description last reply out , DMA and MAC stopped and reset
+**/
+static void BL_UDP_VidDeInit(void)
+{
+	BL_UDP_VidFlush(BL_TRANSPORT_FLUSH_WAIT);
+	/****** receive DMA would keep writing into RAM owned by the application ****/
+	CLEAR_BIT(ETH->DMAOMR , ETH_DMAOMR_ST | ETH_DMAOMR_SR);
+	CLEAR_BIT(ETH->MACCR , ETH_MACCR_TE | ETH_MACCR_RE);
+	SET_BIT(RCC->AHB1RSTR , RCC_AHB1RSTR_ETHMACRST);
+	CLEAR_BIT(RCC->AHB1RSTR , RCC_AHB1RSTR_ETHMACRST);
+	CLEAR_BIT(RCC->AHB1ENR , RCC_AHB1ENR_ETHMACEN | RCC_AHB1ENR_ETHMACTXEN | RCC_AHB1ENR_ETHMACRXEN);
+	BL_Eth_Link_Up = 0U;
+}
+
+/*****BL_UDP_uint16PhyRead
+**@param[in] phy_reg PHY register
+**@return register value (0xFFFF on MDIO timeout)
+**/
+static uint16 BL_UDP_uint16PhyRead(uint8 phy_reg)
+{
+	uint32 loc_start_tick = HAL_GetTick();
+
+	ETH->MACMIIAR = (ETH->MACMIIAR & ETH_MACMIIAR_CR) | ((uint32)BL_UDP_PHY_ADDRESS << ETH_MACMIIAR_PA_Pos) |
+									((uint32)phy_reg << ETH_MACMIIAR_MR_Pos) | ETH_MACMIIAR_MB;
+	while(0U != READ_BIT(ETH->MACMIIAR , ETH_MACMIIAR_MB))
+	{
+		if((HAL_GetTick() - loc_start_tick) > 2U){
+			return 0xFFFFU;
+		}
+	}
+	return (uint16)ETH->MACMIIDR;
+}
+
+/*****BL_UDP_VidPhyWrite
+**@param[in] phy_reg PHY register
+**@param[in] value register value
+**/
+static void BL_UDP_VidPhyWrite(uint8 phy_reg , uint16 value)
+{
+	uint32 loc_start_tick = HAL_GetTick();
+
+	ETH->MACMIIDR = value;
+	ETH->MACMIIAR = (ETH->MACMIIAR & ETH_MACMIIAR_CR) | ((uint32)BL_UDP_PHY_ADDRESS << ETH_MACMIIAR_PA_Pos) |
+									((uint32)phy_reg << ETH_MACMIIAR_MR_Pos) | ETH_MACMIIAR_MW | ETH_MACMIIAR_MB;
+	while((0U != READ_BIT(ETH->MACMIIAR , ETH_MACMIIAR_MB)) && ((HAL_GetTick() - loc_start_tick) <= 2U))
+	{
+	}
+}
+
+/*****BL_UDP_VidLinkCheck
+**@description applies negotiated speed/duplex to the MAC once the PHY reports link
+**/
+static void BL_UDP_VidLinkCheck(void)
+{
+	uint16 loc_bsr = BL_UDP_uint16PhyRead(0x01U);
+	uint16 loc_scsr = 0U;
+	uint32 loc_maccr = ETH_MACCR_IPCO;
+	uint32 loc_start_tick = 0U;
+
+	/****** link up (bit 2) and auto negotiation complete (bit 5) ****/
+	if((0xFFFFU != loc_bsr) && (0x0024U == (loc_bsr & 0x0024U))){
+		loc_scsr = BL_UDP_uint16PhyRead(BL_UDP_PHY_SCSR);
+		if(0U != (loc_scsr & BL_UDP_PHY_SCSR_100M)){
+			loc_maccr |= ETH_MACCR_FES;
+		}
+		if(0U != (loc_scsr & BL_UDP_PHY_SCSR_FULL_DUPLEX)){
+			loc_maccr |= ETH_MACCR_DM;
+		}
+		/****** MAC registers need a few clock cycles between writes ****/
+		ETH->MACCR = loc_maccr | ETH_MACCR_TE;
+		HAL_Delay(1U);
+		SET_BIT(ETH->DMAOMR , ETH_DMAOMR_FTF);
+		loc_start_tick = HAL_GetTick();
+		while(0U != READ_BIT(ETH->DMAOMR , ETH_DMAOMR_FTF))
+		{
+			if((HAL_GetTick() - loc_start_tick) > BL_UDP_FIFO_FLUSH_TIMEOUT_MS){
+				/****** link stays down , the next poll tries again ****/
+				ETH->MACCR = loc_maccr;
+				return;
+			}
+		}
+		ETH->MACCR = loc_maccr | ETH_MACCR_TE | ETH_MACCR_RE;
+		HAL_Delay(1U);
+		SET_BIT(ETH->DMAOMR , ETH_DMAOMR_ST | ETH_DMAOMR_SR);
+		BL_Eth_Link_Up = 1U;
+	}
+}
+
+/*****BL_UDP_VidDescInit
+**@description chains RX descriptors (owned by DMA) and TX descriptors (owned by CPU)
+**/
+static void BL_UDP_VidDescInit(void)
+{
+	uint8 loc_index = 0U;
+
+	for(loc_index = 0U ; loc_index < BL_UDP_RX_DESC_COUNT ; loc_index++)
+	{
+		memset((void *)&BL_Eth_Rx_Desc[loc_index] , 0 , sizeof(Bl_Eth_Desc));
+		BL_Eth_Rx_Desc[loc_index].Control = BL_UDP_RDES1_RCH | BL_UDP_BUFFER_LENGTH;
+		BL_Eth_Rx_Desc[loc_index].Buffer = (uint32)BL_Eth_Rx_Buf[loc_index];
+		BL_Eth_Rx_Desc[loc_index].Next = (uint32)&BL_Eth_Rx_Desc[(loc_index + 1U) % BL_UDP_RX_DESC_COUNT];
+		BL_Eth_Rx_Desc[loc_index].Status = BL_UDP_DESC_OWN;
+	}
+	for(loc_index = 0U ; loc_index < BL_UDP_TX_DESC_COUNT ; loc_index++)
+	{
+		memset((void *)&BL_Eth_Tx_Desc[loc_index] , 0 , sizeof(Bl_Eth_Desc));
+		BL_Eth_Tx_Desc[loc_index].Status = BL_UDP_TDES0_TCH;
+		BL_Eth_Tx_Desc[loc_index].Buffer = (uint32)BL_Eth_Tx_Buf[loc_index];
+		BL_Eth_Tx_Desc[loc_index].Next = (uint32)&BL_Eth_Tx_Desc[(loc_index + 1U) % BL_UDP_TX_DESC_COUNT];
+	}
+	BL_Eth_Rx_Index = 0U;
+	BL_Eth_Tx_Index = 0U;
+	ETH->DMARDLAR = (uint32)BL_Eth_Rx_Desc;
+	ETH->DMATDLAR = (uint32)BL_Eth_Tx_Desc;
+}
+
+/*****BL_UDP_VidRxProcess
+**@description handles every frame the DMA has finished , as long as the ring has room
+**/
+static void BL_UDP_VidRxProcess(void)
+{
+	Bl_Eth_Desc *loc_desc = &BL_Eth_Rx_Desc[BL_Eth_Rx_Index];
+	uint32 loc_status = 0U;
+	uint16 loc_len = 0U;
+	uint16 loc_free = 0U;
+
+	while(0U == (loc_desc->Status & BL_UDP_DESC_OWN))
+	{
+		/****** keep the frame in its descriptor until a whole datagram fits the ring ****/
+		loc_free = (uint16)(BL_UDP_RX_RING_LENGTH - 1U - BL_Transport_uint16RxAvailable(&BL_Udp_Rx_Ring));
+		if(loc_free < BL_TRANSPORT_UDP_MAX_PAYLOAD){
+			break;
+		}
+		loc_status = loc_desc->Status;
+		loc_len = (uint16)((loc_status & BL_UDP_RDES0_FL_MASK) >> BL_UDP_RDES0_FL_POS);
+		if((0U == (loc_status & BL_UDP_RDES0_ES)) && (0U != (loc_status & BL_UDP_RDES0_FS)) &&
+			(0U != (loc_status & BL_UDP_RDES0_LS)) && (loc_len > (BL_UDP_ETH_HEADER_LEN + BL_UDP_ETH_CRC_LEN))){
+			loc_len = (uint16)(loc_len - BL_UDP_ETH_CRC_LEN);
+			if(BL_UDP_ETH_TYPE_ARP == BL_UDP_uint16Get(&BL_Eth_Rx_Buf[BL_Eth_Rx_Index][12U])){
+				BL_UDP_VidHandleArp(BL_Eth_Rx_Buf[BL_Eth_Rx_Index] , loc_len);
+			}else if(BL_UDP_ETH_TYPE_IP == BL_UDP_uint16Get(&BL_Eth_Rx_Buf[BL_Eth_Rx_Index][12U])){
+				BL_UDP_VidHandleIp(BL_Eth_Rx_Buf[BL_Eth_Rx_Index] , loc_len);
+			}else{
+				/****** other protocols are ignored ****/
+			}
+		}
+		/****** give descriptor back , resume DMA if it ran out of descriptors ****/
+		loc_desc->Status = BL_UDP_DESC_OWN;
+		__DSB();
+		if(0U != READ_BIT(ETH->DMASR , ETH_DMASR_RBUS)){
+			ETH->DMASR = ETH_DMASR_RBUS;
+			ETH->DMARPDR = 0U;
+		}
+		BL_Eth_Rx_Index = (uint8)((BL_Eth_Rx_Index + 1U) % BL_UDP_RX_DESC_COUNT);
+		loc_desc = &BL_Eth_Rx_Desc[BL_Eth_Rx_Index];
+	}
+}
+
+/*****BL_UDP_VidHandleArp
+**@param[in] frame received Ethernet frame
+**@param[in] len frame length without CRC
+**/
+static void BL_UDP_VidHandleArp(const uint8 *frame , uint16 len)
+{
+	const uint8 *loc_arp = &frame[BL_UDP_ETH_HEADER_LEN];
+	uint8 *loc_buf = NULL;
+	uint8 *loc_reply = NULL;
+
+	/****** answer only "who has <our ip>" for Ethernet/IPv4 ****/
+	if((len >= (BL_UDP_ETH_HEADER_LEN + BL_UDP_ARP_LEN)) && (1U == BL_UDP_uint16Get(&loc_arp[0U])) &&
+		(BL_UDP_ETH_TYPE_IP == BL_UDP_uint16Get(&loc_arp[2U])) && (BL_UDP_ARP_REQUEST == BL_UDP_uint16Get(&loc_arp[6U])) &&
+		(0 == memcmp(&loc_arp[24U] , BL_Local_Ip , 4U))){
+		/****** a reply being gathered goes out first , it owns the current TX buffer ****/
+		BL_UDP_VidFlush(BL_TRANSPORT_FLUSH_NO_WAIT);
+		loc_buf = BL_UDP_pTxAcquire();
+		if(NULL == loc_buf){
+			return;
+		}
+		loc_reply = &loc_buf[BL_UDP_ETH_HEADER_LEN];
+		memcpy(&loc_buf[0U] , &loc_arp[8U] , 6U);
+		memcpy(&loc_buf[6U] , BL_Local_Mac , 6U);
+		BL_UDP_VidPut16(&loc_buf[12U] , BL_UDP_ETH_TYPE_ARP);
+		memcpy(&loc_reply[0U] , &loc_arp[0U] , 6U);				/* hw type , protocol , sizes */
+		BL_UDP_VidPut16(&loc_reply[6U] , BL_UDP_ARP_REPLY);
+		memcpy(&loc_reply[8U] , BL_Local_Mac , 6U);
+		memcpy(&loc_reply[14U] , BL_Local_Ip , 4U);
+		memcpy(&loc_reply[18U] , &loc_arp[8U] , 10U);			/* requester mac + ip */
+		BL_UDP_VidTxStart(BL_UDP_ETH_HEADER_LEN + BL_UDP_ARP_LEN);
+	}
+}
+
+/*****BL_UDP_VidHandleIp
+**@param[in] frame received Ethernet frame
+**@param[in] len frame length without CRC
+**/
+static void BL_UDP_VidHandleIp(const uint8 *frame , uint16 len)
+{
+	const uint8 *loc_ip = &frame[BL_UDP_ETH_HEADER_LEN];
+	const uint8 *loc_data = &loc_ip[BL_UDP_IP_HEADER_LEN];
+	uint16 loc_ip_len = 0U;
+	uint16 loc_data_len = 0U;
+	uint16 loc_first_part = 0U;
+	uint8 *loc_buf = NULL;
+
+	if(len < (BL_UDP_ETH_HEADER_LEN + BL_UDP_IP_HEADER_LEN)){
+		return;
+	}
+	loc_ip_len = BL_UDP_uint16Get(&loc_ip[2U]);
+	/****** plain IPv4 to us only : no options , no fragments ****/
+	if((0x45U != loc_ip[0U]) || (0U != (BL_UDP_uint16Get(&loc_ip[6U]) & 0x3FFFU)) || (0 != memcmp(&loc_ip[16U] , BL_Local_Ip , 4U)) ||
+		(loc_ip_len < BL_UDP_IP_HEADER_LEN) || (loc_ip_len > (len - BL_UDP_ETH_HEADER_LEN))){
+		return;
+	}
+	loc_data_len = (uint16)(loc_ip_len - BL_UDP_IP_HEADER_LEN);
+	if((BL_UDP_IP_PROTO_ICMP == loc_ip[9U]) && (loc_data_len >= 8U) && (BL_UDP_ICMP_ECHO_REQUEST == loc_data[0U])){
+		/****** ping : same frame back with swapped addresses , checksums inserted by the MAC ****/
+		BL_UDP_VidFlush(BL_TRANSPORT_FLUSH_NO_WAIT);
+		loc_buf = BL_UDP_pTxAcquire();
+		if(NULL == loc_buf){
+			return;
+		}
+		memcpy(loc_buf , frame , BL_UDP_ETH_HEADER_LEN + loc_ip_len);
+		memcpy(&loc_buf[0U] , &frame[6U] , 6U);
+		memcpy(&loc_buf[6U] , BL_Local_Mac , 6U);
+		memcpy(&loc_buf[BL_UDP_ETH_HEADER_LEN + 12U] , BL_Local_Ip , 4U);
+		memcpy(&loc_buf[BL_UDP_ETH_HEADER_LEN + 16U] , &loc_ip[12U] , 4U);
+		BL_UDP_VidPut16(&loc_buf[BL_UDP_ETH_HEADER_LEN + 10U] , 0U);
+		loc_buf[BL_UDP_ETH_HEADER_LEN + BL_UDP_IP_HEADER_LEN] = BL_UDP_ICMP_ECHO_REPLY;
+		BL_UDP_VidPut16(&loc_buf[BL_UDP_ETH_HEADER_LEN + BL_UDP_IP_HEADER_LEN + 2U] , 0U);
+		BL_UDP_VidTxStart((uint16)(BL_UDP_ETH_HEADER_LEN + loc_ip_len));
+	}else if((BL_UDP_IP_PROTO_UDP == loc_ip[9U]) && (loc_data_len >= BL_UDP_UDP_HEADER_LEN) &&
+		(BL_TRANSPORT_UDP_PORT == BL_UDP_uint16Get(&loc_data[2U]))){
+		loc_data_len = BL_UDP_uint16Get(&loc_data[4U]);
+		if((loc_data_len < BL_UDP_UDP_HEADER_LEN) || (loc_data_len > (loc_ip_len - BL_UDP_IP_HEADER_LEN))){
+			return;
+		}
+		/****** host datagram : remember sender for replies , payload to the ring ****/
+		memcpy(BL_Peer_Mac , &frame[6U] , 6U);
+		memcpy(BL_Peer_Ip , &loc_ip[12U] , 4U);
+		BL_Peer_Port = BL_UDP_uint16Get(&loc_data[0U]);
+		BL_Peer_Valid = 1U;
+		loc_data_len = (uint16)(loc_data_len - BL_UDP_UDP_HEADER_LEN);
+		loc_data = &loc_data[BL_UDP_UDP_HEADER_LEN];
+		loc_first_part = (uint16)(BL_UDP_RX_RING_LENGTH - BL_Udp_Rx_Ring.Head);
+		if(loc_data_len <= loc_first_part){
+			memcpy(&BL_Udp_Ring_Buf[BL_Udp_Rx_Ring.Head] , loc_data , loc_data_len);
+		}else{
+			memcpy(&BL_Udp_Ring_Buf[BL_Udp_Rx_Ring.Head] , loc_data , loc_first_part);
+			memcpy(&BL_Udp_Ring_Buf[0U] , &loc_data[loc_first_part] , loc_data_len - loc_first_part);
+		}
+		BL_Udp_Rx_Ring.Head = (uint16)((BL_Udp_Rx_Ring.Head + loc_data_len) % BL_UDP_RX_RING_LENGTH);
+		BL_Udp_Last_Rx_Tick = HAL_GetTick();
+	}else{
+		/****** other protocols and ports are ignored ****/
+	}
+}
+
+/*****BL_UDP_pTxAcquire
+**@return buffer of next TX descriptor (waits until the DMA released it) , NULL after BL_UDP_TX_TIMEOUT_MS
+**/
+static uint8 *BL_UDP_pTxAcquire(void)
+{
+	uint32 loc_start_tick = HAL_GetTick();
+
+	while(0U != (BL_Eth_Tx_Desc[BL_Eth_Tx_Index].Status & BL_UDP_DESC_OWN))
+	{
+		if((HAL_GetTick() - loc_start_tick) > BL_UDP_TX_TIMEOUT_MS){
+			return NULL;
+		}
+	}
+	return BL_Eth_Tx_Buf[BL_Eth_Tx_Index];
+}
+
+/*****BL_UDP_VidTxStart
+**@param[in] frame_len Ethernet frame length (MAC adds padding and CRC)
+**/
+static void BL_UDP_VidTxStart(uint16 frame_len)
+{
+	Bl_Eth_Desc *loc_desc = &BL_Eth_Tx_Desc[BL_Eth_Tx_Index];
+
+	loc_desc->Control = (uint32)frame_len & BL_UDP_DES1_BUFFER1_MASK;
+	loc_desc->Status = BL_UDP_DESC_OWN | BL_UDP_TDES0_FS | BL_UDP_TDES0_LS | BL_UDP_TDES0_CIC_FULL | BL_UDP_TDES0_TCH;
+	__DSB();
+	/****** resume DMA if it suspended on a CPU owned descriptor ****/
+	if(0U != READ_BIT(ETH->DMASR , ETH_DMASR_TBUS)){
+		ETH->DMASR = ETH_DMASR_TBUS;
+	}
+	ETH->DMATPDR = 0U;
+	BL_Eth_Tx_Index = (uint8)((BL_Eth_Tx_Index + 1U) % BL_UDP_TX_DESC_COUNT);
+}
+
+/*****BL_UDP_uint16Get
+**@return big endian 16 bit value at data
+**/
+static uint16 BL_UDP_uint16Get(const uint8 *data)
+{
+	return (uint16)(((uint16)data[0U] << 8U) | data[1U]);
+}
+
+/*****BL_UDP_VidPut16
+**@description stores value big endian at data
+**/
+static void BL_UDP_VidPut16(uint8 *data , uint16 value)
+{
+	data[0U] = (uint8)(value >> 8U);
+	data[1U] = (uint8)(value & 0xFFU);
+}
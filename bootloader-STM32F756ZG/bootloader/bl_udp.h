@@ -0,0 +1,85 @@
+/// \file bl_udp.h
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host channel over Ethernet : register level MAC/DMA driver with a minimal ARP , ICMP echo
+///        and UDP responder. Exported to the command engine as BL_UDP_Transport
+///        (select with BL_HOST_TRANSPORT = BL_TRANSPORT_UDP)
+
+#ifndef BL_UDP_H
+#define BL_UDP_H
+/************** Global Includes**************/
+#include "LSTD_TYPES.h"
+#include <string.h>
+#include "main.h"
+#include "bl_transport.h"
+
+/*********** Macro declerations**********/
+// Station address (CubeMX ETH default) and static IPv4 address of the bootloader
+#define BL_UDP_MAC_ADDR															{0x00U , 0x80U , 0xE1U , 0x00U , 0x00U , 0x00U}
+#define BL_UDP_IP_ADDR															{192U , 168U , 0U , 10U}
+
+// RMII PHY (LAN8742A on Nucleo-144 boards)
+#define BL_UDP_PHY_ADDRESS													0x00U
+#define BL_UDP_PHY_RESET_TIMEOUT_MS									500U
+#define BL_UDP_PHY_LINK_TIMEOUT_MS									3000U			/* link may also come up later , checked on every poll */
+#define BL_UDP_PHY_SCSR															0x1FU			/* special control/status register */
+#define BL_UDP_PHY_SCSR_100M												0x0008U
+#define BL_UDP_PHY_SCSR_FULL_DUPLEX									0x0010U
+#define BL_UDP_MAC_RESET_TIMEOUT_MS									100U
+#define BL_UDP_TX_TIMEOUT_MS												20U				/* DMA release of a TX descriptor , a full frame needs ~1.2 ms at 10 Mbit/s */
+#define BL_UDP_FIFO_FLUSH_TIMEOUT_MS								10U
+
+// DMA descriptors and frame buffers (one Ethernet frame each , no chaining of buffers)
+#define BL_UDP_RX_DESC_COUNT												8U				/* frames the host may have in flight */
+#define BL_UDP_TX_DESC_COUNT												2U				/* one is filled while the other is sent */
+#define BL_UDP_BUFFER_LENGTH												1536U
+
+// Receive ring between datagrams and frame parser (several window write frames)
+#define BL_UDP_RX_RING_LENGTH												8192U
+
+// Protocol layout
+#define BL_UDP_ETH_HEADER_LEN												14U
+#define BL_UDP_IP_HEADER_LEN												20U				/* options are not supported */
+#define BL_UDP_UDP_HEADER_LEN												8U
+#define BL_UDP_HEADERS_LEN													(BL_UDP_ETH_HEADER_LEN + BL_UDP_IP_HEADER_LEN + BL_UDP_UDP_HEADER_LEN)
+#define BL_UDP_ARP_LEN															28U
+#define BL_UDP_ETH_TYPE_IP													0x0800U
+#define BL_UDP_ETH_TYPE_ARP													0x0806U
+#define BL_UDP_IP_PROTO_ICMP												1U
+#define BL_UDP_IP_PROTO_UDP													17U
+#define BL_UDP_IP_TTL																64U
+#define BL_UDP_ARP_REQUEST													1U
+#define BL_UDP_ARP_REPLY														2U
+#define BL_UDP_ICMP_ECHO_REQUEST										8U
+#define BL_UDP_ICMP_ECHO_REPLY											0U
+
+// Enhanced DMA descriptor bits
+#define BL_UDP_DESC_OWN															0x80000000U
+#define BL_UDP_TDES0_IC															0x40000000U
+#define BL_UDP_TDES0_LS															0x20000000U
+#define BL_UDP_TDES0_FS															0x10000000U
+#define BL_UDP_TDES0_CIC_FULL												0x00C00000U			/* IP header and payload checksum inserted by MAC */
+#define BL_UDP_TDES0_TCH														0x00100000U
+#define BL_UDP_RDES0_FL_MASK												0x3FFF0000U
+#define BL_UDP_RDES0_FL_POS													16U
+#define BL_UDP_RDES0_ES															0x00008000U
+#define BL_UDP_RDES0_FS															0x00000200U
+#define BL_UDP_RDES0_LS															0x00000100U
+#define BL_UDP_RDES1_RCH														0x00004000U
+#define BL_UDP_DES1_BUFFER1_MASK										0x00001FFFU
+#define BL_UDP_ETH_CRC_LEN													4U
+
+/*********** Data Type Declerations*****/
+/* enhanced DMA descriptor (DMABMR EDE) , needed for checksum offload */
+typedef struct tagS__Bl_Eth_Desc{
+	volatile uint32	Status;						// DES0
+	volatile uint32	Control;					// DES1 buffer size
+	volatile uint32	Buffer;						// DES2
+	volatile uint32	Next;							// DES3 chained descriptor
+	volatile uint32	Extended;					// DES4 receive checksum status
+	volatile uint32	Reserved;					// DES5
+	volatile uint32	TimeStampLow;			// DES6
+	volatile uint32	TimeStampHigh;		// DES7
+}Bl_Eth_Desc;
+
+#endif /*BL_UDP_H*/
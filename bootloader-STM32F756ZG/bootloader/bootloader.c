@@ -16,6 +16,13 @@ return CRC_verify_passed if success else  CRC_verify_Failed
 **/
 static uint8	BL_uint8CRC_Verify(uint8*pdata , uint32 datalen , uint32 host_crc);
 
+/*****BL_uint8FrameCrcVerify 
+**@description frame crc against the CRC the frame layer calculated while the frame arrived
+**@param[in] frame decoded frame
+return CRC_verify_passed if success else  CRC_verify_Failed
+**/
+static uint8	BL_uint8FrameCrcVerify(const Bl_Frame *frame);
+
 /*****BL_VidSendAck 
 **@param[in] bl_reply_len bootloader reply length
 **/
@@ -45,12 +52,43 @@ static	uint8 Host_uint8AddressVerification(uint32 address);
 **/
 static uint8 Flash_Mem_Write_Payload(uint8 *payload , uint32 payload_address , uint16 payload_len);
 
+/*****BL_uint8WritePayload
+**@description host payload -> flash , decrypted first in an encrypted write session
+**@param[in] payload pointer to payload as received
+**@param[in] payload_address destination address
+**@param[in] payload_len payload length (up to BL_HOST_MAX_PAYLOAD_LENGTH)
+**/
+static uint8 BL_uint8WritePayload(uint8 *payload , uint32 payload_address , uint16 payload_len);
+
 /*****Flash_Mem_Write_Payload 
 **@param[in] sector_number sector for start from it
 **@param[in] numberofsectors  No.of sectors to erase
 **/
 static uint8 Perform_uint8FlashErase(uint8 sector_number , uint8 numberofsectors);
 
+/*****BL_uint8FlashSector
+**@param[in] address flash address
+**@return sector holding the address , FLASH_MAX_SECTORS outside of flash
+**/
+static uint8 BL_uint8FlashSector(uint32 address);
+
+/*****BL_uint8AutoErase
+**@description erases a sector of the range only when the payload can't be programmed over its content
+**@param[in] payload data to program
+**@param[in] address destination of payload
+**@param[in] len payload length
+**@return FLASH_WRITE_STATUS_PASS or FLASH_WRITE_STATUS_FAIL
+**/
+static uint8 BL_uint8AutoErase(const uint8 *payload , uint32 address , uint16 len);
+
+/*****BL_uint8FlashInPlace
+**@param[in] data data to program
+**@param[in] address destination in flash
+**@param[in] len data length
+**@return 1 when programming only clears bits ((flash & data) == data) , 0 otherwise
+**/
+static uint8 BL_uint8FlashInPlace(const uint8 *data , uint32 address , uint32 len);
+
 /*****STM32F756_Get_RDP_LEVEL
 **@param[in] 
 **/
@@ -115,6 +153,197 @@ static void BL_VidGoToAddr(uint8 *Host_buffer);
 **/
 static void BL_VidWriteMemory(uint8 *Host_buffer);
 
+/*****BL_VidWindowWriteMemory
+**@description 
+	Pipelined variant of write memory , frames carry a sequence number and host does not wait
+	for each reply. Every in order frame is answered with a cumulative ACK of next expected sequence,
+	lost or corrupted frames are answered once with a resend request (go back N).
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidWindowWriteMemory(uint8 *Host_buffer);
+
+/*****BL_VidChangeBaudRate
+**@description 
+	Switches host channel to the proposed baud rate. Reply is sent at old rate , then a confirmation
+	frame (same command and rate) is expected at new rate , otherwise old rate is restored.
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidChangeBaudRate(uint8 *Host_buffer);
+
+/*****BL_VidSendWindowReply
+**@param[in] window_status WINDOW_WRITE_STATUS_xx
+**@param[in] expected_seq next sequence expected from host
+**/
+static void BL_VidSendWindowReply(uint8 window_status , uint16 expected_seq);
+
+/*****BL_VidSetFrameMode
+**@description 
+	Negotiates extended frames "0x00 | len(2) | packet" carrying up to BL_HOST_MAX_PAYLOAD_LENGTH bytes.
+	Reply holds accepted mode and max. frame size the host may send.
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidSetFrameMode(uint8 *Host_buffer);
+
+/*****BL_VidBatch
+**@description 
+	Runs a list of sub commands (erase , write , check sum , go) from one frame and answers
+	with one status byte per sub command. Execution stops at the first failing sub command.
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidBatch(uint8 *Host_buffer);
+
+/*****BL_uint8BatchOp
+**@param[in] Host_buffer pointer to frame
+**@param[in] op_offset offset of op code , advanced behind the op arguments
+**@param[in] op_end offset of frame crc
+**@param[out] jump_address address of a go op (untouched for other ops)
+**@return BL_BATCH_STATUS_xx
+**/
+static uint8 BL_uint8BatchOp(uint8 *Host_buffer , uint16 *op_offset , uint16 op_end , uint32 *jump_address);
+
+/*****BL_uint32MemoryCrc
+**@param[in] address start address
+**@param[in] len number of bytes
+**@return crc32 of memory , same convention as frame crc
+**/
+static uint32 BL_uint32MemoryCrc(uint32 address , uint32 len);
+
+/*****BL_VidSetCrcMode
+**@description 
+	Switches frame and check sum CRC to the requested convention (BL_CRC_MODE_xx) , reply holds
+	the accepted mode. The frame is accepted in either convention , a restarted host does not
+	know the one an earlier session selected.
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidSetCrcMode(uint8 *Host_buffer);
+
+/*****BL_VidSessionDigest
+**@description 
+	Reports bytes written and running digest of the write session , then starts a new one.
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidSessionDigest(uint8 *Host_buffer);
+
+/*****BL_VidSessionStart
+**@description clears the write session (digest of no data in the CRC mode in use)
+**/
+static void BL_VidSessionStart(void);
+
+/*****BL_VidSessionUpdate
+**@description adds a programmed payload , read back from its destination , to the session digest
+**@param[in] address destination of payload
+**@param[in] len payload length
+**/
+static void BL_VidSessionUpdate(uint32 address , uint16 len);
+
+/*****BL_VidSetWriteMode
+**@description frame -> len | cmd | mode | nonce | crc32 , starts or ends an encrypted write session
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidSetWriteMode(uint8 *Host_buffer);
+
+/*****BL_VidImageManifest
+**@description frame -> header | cmd | part | data | crc32 , loads the Merkle header and leaf hashes of an image
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidImageManifest(uint8 *Host_buffer);
+
+/*****BL_uint8MerkleHeaderCheck
+**@param[in] image_header MERKLE header
+**@return BL_IMAGE_VALID if chunking is supported and the MAC matches
+**/
+static uint8 BL_uint8MerkleHeaderCheck(const Bl_Image_Header *image_header);
+
+/*****BL_uint8MerkleRoot
+**@description root of the leaf hashes , leaves hashed from the image in flash when none are given
+**@param[in] image_header MERKLE header
+**@param[in] leaves leaf hashes or NULL
+**@param[out] root BL_HASH_SHA256_LEN bytes
+**@param[out] cycles HASH cycles spent
+**@return BL_HASH_OK or BL_HASH_FAILED (root is then not valid)
+**/
+static uint8 BL_uint8MerkleRoot(const Bl_Image_Header *image_header , const uint8 *leaves , uint8 *root , uint32 *cycles);
+
+/*****BL_uint8MerkleChunk
+**@param[in] data payload to be written (word aligned)
+**@param[in] address destination address
+**@param[in] len payload length
+**@param[out] chunk_index chunk number (BL_MERKLE_CHUNK_VALID only)
+**@return BL_MERKLE_CHUNK_xx
+**/
+static uint8 BL_uint8MerkleChunk(const uint8 *data , uint32 address , uint16 len , uint32 *chunk_index);
+
+/*****BL_VidMerkleChunkDone
+**@description marks a programmed chunk , the last one stores the header and the verified record
+**@param[in] chunk_index chunk number
+**/
+static void BL_VidMerkleChunkDone(uint32 chunk_index);
+
+/*****BL_uint8FlashProgramWords
+**@param[in] address destination (word aligned)
+**@param[in] words data
+**@param[in] count number of words
+**@return FLASH_WRITE_STATUS_PASS or FLASH_WRITE_STATUS_FAIL
+**/
+static uint8 BL_uint8FlashProgramWords(uint32 address , const uint32 *words , uint32 count);
+
+/*****BL_VidImageVerify
+**@description 
+	Verifies the application image against its header (SHA-256 on the HASH processor) ,
+	replies the result and the cycles it took.
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidImageVerify(uint8 *Host_buffer);
+
+/*****BL_uint8ImageVerify
+**@param[out] cycles cycles of the digest (0 when the header is invalid)
+**@return BL_IMAGE_VALID if header is sane and the image matches its digest
+**/
+static uint8 BL_uint8ImageVerify(uint32 *cycles);
+
+/*****BL_VidBootOnTimeout
+**@description no host frame since entry : starts the application if its image is valid
+**/
+static void BL_VidBootOnTimeout(void);
+
+/*****BL_uint8ImageHeaderCheck
+**@param[in] image_header header in flash
+**@return BL_IMAGE_VALID if the header describes an image inside the application area (MERKLE only while
+          BL_IMAGE_AUTH is enforced)
+**/
+static uint8 BL_uint8ImageHeaderCheck(const Bl_Image_Header *image_header);
+
+/*****BL_uint32BootCacheScan
+**@param[out] write_count number of WRITE records
+**@param[out] last_record address of last record (0 for an empty log)
+**@return address of first free record (BL_BOOT_CACHE_END when full)
+**/
+static uint32 BL_uint32BootCacheScan(uint32 *write_count , uint32 *last_record);
+
+/*****BL_uint8BootCacheHit
+**@return BL_IMAGE_VALID if the last record marks the current header as verified and nothing was written since
+**/
+static uint8 BL_uint8BootCacheHit(void);
+
+/*****BL_VidBootCacheAppend
+**@description appends a record , a full log revokes its last record instead (WRITE only)
+**@param[in] record_type BL_BOOT_RECORD_WRITE or BL_BOOT_RECORD_VERIFIED
+**@param[in] sha256 header digest (VERIFIED) or NULL
+**/
+static void BL_VidBootCacheAppend(uint32 record_type , const uint8 *sha256);
+
+/*****BL_VidBootCacheInvalidate
+**@description called before any flash write or erase , logs it once per power cycle
+**/
+static void BL_VidBootCacheInvalidate(void);
+
+/*****BL_VidFlashBusy
+**@description
+	Idle work of an erase , runs from ITCM : the frame after the one being handled is taken
+	from the ring into the spare host buffer and checked while the flash is busy.
+**/
+static void BL_VidFlashBusy(void);
+
 /*****BL_VidErase 
 **@description 
 	Erases from one to all the flash memory pages
@@ -174,7 +403,8 @@ static void BL_VidReadOutUnProtect(uint8 *Host_buffer);
 
 /*****BL_VidCheckSum 
 **@description 
-	Computes a CRC value on a given memory area with a size multiple of 4 bytes.
+	Computes the CRC (frame convention) of one or more memory ranges on chip , replies one
+	value per range. Lets the host verify a written image without reading it back.
 **@param[in] Host_buffer pointer to data
 **/
 static void BL_VidCheckSum(uint8 *Host_buffer);
@@ -182,7 +412,40 @@ static void BL_VidCheckSum(uint8 *Host_buffer);
 
 
 /********* Global Variables Declerations************/
-static uint8 BL_Host_Buf[BL_HOST_BUFFER_RX_LENGTH];  // Host Buffer
+static uint8 BL_Host_Bufs[2U][BL_HOST_BUFFER_RX_LENGTH];  // Host Buffers : frame being handled , next frame during an erase
+static uint8 *BL_Host_Buf = BL_Host_Bufs[0U];					// frame being handled
+static uint8 BL_Host_Buf_Index = 0U;
+static Bl_Frame BL_Host_Frame_Copy;										// header of the frame in BL_Host_Buf , kept while the next one is fetched
+static const Bl_Frame *BL_Host_Frame = NULL;					// header of the frame in BL_Host_Buf , decoded by the frame layer
+static uint8 BL_Host_Prefetched = 0U;									// spare buffer took (part of) the next frame during an erase
+static uint8 BL_Host_Prefetch_Status = BL_TRANSPORT_FRAME_NOT_READY;
+static uint16 BL_Window_Expected_Seq = 0U;					// next in order windowed write frame
+static uint16 BL_Window_Resend_Seq = BL_WINDOW_SEQ_NONE;	// last resend request (sent only once)
+static uint8 BL_Window_Open = 0U;												// windowed write in progress , closed by any other command
+static uint8 BL_Frame_Mode = BL_FRAME_MODE_LEGACY;				// negotiated frame header mode
+static uint16 BL_Reply_Pending = 0U;											// payload bytes announced by last ACK , not yet gathered
+static uint32 BL_Session_Bytes = 0U;											// bytes written in write session
+static uint32 BL_Session_Programmed = 0U;								// of them really programmed (not already in flash)
+static uint32 BL_Session_Digest = BL_SESSION_DIGEST_EMPTY_LEGACY;	// CRC of all of them
+static uint8 BL_Boot_State = BL_BOOT_STATE_IDLE;						// application start on entry timeout
+static uint32 BL_Boot_Entry_Tick = 0U;
+static uint8 BL_Boot_Write_Logged = 0U;										// WRITE record appended since last VERIFIED one
+static uint8 BL_Write_Mode = BL_WRITE_MODE_PLAIN;								// payload encryption of write session
+static uint32 BL_Write_Buffer[(BL_HOST_MAX_PAYLOAD_LENGTH + (2U * BL_AES_BLOCK_LEN)) / 4U];	// decrypted payload , block aligned
+static uint8 BL_Merkle_State = BL_MERKLE_STATE_IDLE;						// chunk checking of write session
+static Bl_Image_Header BL_Merkle_Header;												// accepted manifest header
+static uint8 BL_Merkle_Leaves[BL_MERKLE_MAX_LEAVES][BL_HASH_SHA256_LEN];	// expected chunk hashes
+static uint32 BL_Merkle_Leaf_Count = 0U;
+static uint32 BL_Merkle_Leaves_Loaded = 0U;
+static uint32 BL_Merkle_Done[BL_MERKLE_MAX_LEAVES / 32U];					// programmed chunks , one bit each
+static uint32 BL_Merkle_Done_Count = 0U;
+static uint8 BL_Merkle_Stack[BL_MERKLE_MAX_DEPTH][BL_HASH_SHA256_LEN];	// root calculation , not on the 1 KB stack
+static uint8 BL_Merkle_Stack_Level[BL_MERKLE_MAX_DEPTH];
+static uint32 BL_Merkle_Pair[(2U * BL_HASH_SHA256_LEN) / 4U];					// left | right , word aligned for DMA
+static const uint8 BL_Merkle_Mac_Key[BL_HASH_HMAC_KEY_LEN] = BL_MERKLE_MAC_KEY;
+static const uint32 BL_Flash_Sector_Base[FLASH_MAX_SECTORS + 1U] = BL_FLASH_SECTOR_BASES;
+static uint8 BL_Erased_Sectors = 0U;												// bit n : sector n erased in write session
+static uint8 BL_Written_Sectors = 0U;												// bit n : sector n programmed without erase in write session
 // Bootloader Supported Commands 
 static uint8 Bl_Supported_Commands[BL_NO_OF_SUPPORTED_CMD] ={
 	CBL_GET_HELP_CMD,
@@ -191,6 +454,15 @@ static uint8 Bl_Supported_Commands[BL_NO_OF_SUPPORTED_CMD] ={
   CBL_READ_MEMORY_CMD, 			
   CBL_GO_TO_ADDR_CMD,			
   CBL_WRITE_MEMORY_CMD, 		
+  CBL_WINDOW_WRITE_MEMORY_CMD,
+  CBL_CHANGE_BAUD_RATE_CMD,
+  CBL_SET_FRAME_MODE_CMD,
+  CBL_BATCH_CMD,
+  CBL_SET_CRC_MODE_CMD,
+  CBL_SESSION_DIGEST_CMD,
+  CBL_IMAGE_VERIFY_CMD,
+  CBL_SET_WRITE_MODE_CMD,
+  CBL_IMAGE_MANIFEST_CMD,
   CBL_ERASE_CMD,		
   CBL_EXTENDED_ERASE_CMD, 	
   CBL_SPECIAL_CMD,	
@@ -224,6 +496,14 @@ void Bl_Print_Msg(char *format,...)
 	#endif
 	va_end(args);
 }
+/**function BL_VidBootEntryStart 
+*/
+void BL_VidBootEntryStart(void)
+{
+	/******** start up (link init , baud detection) counts against the same entry window ******/
+	BL_Boot_Entry_Tick = HAL_GetTick();
+	BL_Boot_State = BL_BOOT_STATE_WAIT;
+}
 /**function Bl_Uart_Fetch_Host_Cmd 
 *@param[in] format pointer 
 *@return BL_ACK if there is no error else return BL_NACK
@@ -231,28 +511,72 @@ void Bl_Print_Msg(char *format,...)
 Bl_Status Bl_Uart_Fetch_Host_Cmd(void)
 {
 	Bl_Status	loc_bl_status = BL_NACK;
-	HAL_StatusTypeDef	loc_status = HAL_ERROR;
-	uint8 ui_data_len = 0U;
+	uint8 loc_frame_status = BL_TRANSPORT_FRAME_NOT_READY;
 	
-	/******** clear Host buffer******/
-	memset(BL_Host_Buf,0,BL_HOST_BUFFER_RX_LENGTH);
-	/********** Read Length of cmd packet******/
-	// Receive command length "cmd code + (optional)info + crc"
-	loc_status = HAL_UART_Receive(BL_HOST_COMMUNICATION_UART , BL_Host_Buf , 1U , HAL_MAX_DELAY); 
-	if (HAL_OK != loc_status)
+	/******** frame layer fills BL_Host_Buf as the bytes arrive , handlers only read up to the frame length******/
+	if(BL_BOOT_STATE_IDLE == BL_Boot_State){
+		BL_VidBootEntryStart();
+	}
+	/********** Wait for complete cmd packet "length + cmd code + (optional)info + crc"******/
+	// host link keeps receiving while the previous command is executed
+	if(0U != BL_Host_Prefetched){
+		/******** next frame was fetched (or begun) during an erase , its buffer takes over ******/
+		BL_Host_Prefetched = 0U;
+		BL_Host_Buf_Index ^= 1U;
+		BL_Host_Buf = BL_Host_Bufs[BL_Host_Buf_Index];
+		loc_frame_status = BL_Host_Prefetch_Status;
+		BL_Host_Prefetch_Status = BL_TRANSPORT_FRAME_NOT_READY;
+	}else{
+		loc_frame_status = BL_HOST_LINK->Receive(BL_Host_Buf , BL_HOST_BUFFER_RX_LENGTH);
+	}
+	while(BL_TRANSPORT_FRAME_NOT_READY == loc_frame_status)
+	{
+		BL_HOST_LINK->Poll();
+		if((BL_BOOT_STATE_WAIT == BL_Boot_State) && ((HAL_GetTick() - BL_Boot_Entry_Tick) >= BL_BOOT_ENTRY_TIMEOUT_MS)){
+			BL_VidBootOnTimeout();
+		}
+		loc_frame_status = BL_HOST_LINK->Receive(BL_Host_Buf , BL_HOST_BUFFER_RX_LENGTH);
+	}
+	/******** host is there , stay in bootloader *****/
+	BL_Boot_State = BL_BOOT_STATE_DONE;
+	BL_Host_Frame_Copy = *BL_Transport_pGetFrame();
+	BL_Host_Frame = &BL_Host_Frame_Copy;
+	/******** any other valid command ends a windowed write , a new one may start at sequence 0 *****/
+	if((BL_TRANSPORT_FRAME_READY == loc_frame_status) && (CBL_WINDOW_WRITE_MEMORY_CMD != BL_Host_Frame->Cmd) &&
+		(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame))){
+		BL_Window_Open = 0U;
+	}
+	if (BL_TRANSPORT_FRAME_READY != loc_frame_status)
 	{
-		// TODO error handling
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		if(BL_TRANSPORT_FRAME_TOO_LONG == loc_frame_status){
+			Bl_Print_Msg("Cmd packet exceeds host buffer \r\n");
+		}else{
+			Bl_Print_Msg("Broken frame dropped , receiver resynced \r\n");
+		}
+#endif
+		BL_VidSendNack();
 		loc_bl_status = BL_NACK;
+	}else if(BL_TRANSPORT_FRAME_EXT_HEADER_LEN == BL_Host_Frame->Header_Len){
+		/******** extended frames are used for bulk transfer only *****/
+		if(CBL_WINDOW_WRITE_MEMORY_CMD == BL_Host_Frame->Cmd){
+			BL_VidWindowWriteMemory(BL_Host_Buf);
+			loc_bl_status = BL_ACK;
+		}else if(CBL_BATCH_CMD == BL_Host_Frame->Cmd){
+			BL_VidBatch(BL_Host_Buf);
+			loc_bl_status = BL_ACK;
+		}else if(CBL_IMAGE_MANIFEST_CMD == BL_Host_Frame->Cmd){
+			BL_VidImageManifest(BL_Host_Buf);
+			loc_bl_status = BL_ACK;
+		}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+			Bl_Print_Msg("Command not supported in extended frame \r\n");
+#endif
+			BL_VidSendNack();
+			loc_bl_status = BL_NACK;
+		}
 	}else{
-		ui_data_len = BL_Host_Buf[0U];  // store command packet length 
-		/********** Read command Info**********/
-		loc_status = HAL_UART_Receive(BL_HOST_COMMUNICATION_UART , &BL_Host_Buf[1U] , ui_data_len , HAL_MAX_DELAY);
-		if(HAL_OK != loc_status)
-			{
-					// TODO error handling
-				loc_bl_status = BL_NACK;
-			} else{
-				switch(BL_Host_Buf[1U])
+				switch(BL_Host_Frame->Cmd)
 				 {
 					case CBL_GET_HELP_CMD:
 					BL_VidGetHelp(BL_Host_Buf);	
@@ -276,6 +600,42 @@ Bl_Status Bl_Uart_Fetch_Host_Cmd(void)
 						break;
 					case CBL_WRITE_MEMORY_CMD:
 					BL_VidWriteMemory(BL_Host_Buf);
+					loc_bl_status = BL_ACK;
+						break;
+					case CBL_WINDOW_WRITE_MEMORY_CMD:
+					BL_VidWindowWriteMemory(BL_Host_Buf);
+					loc_bl_status = BL_ACK;
+						break;
+					case CBL_CHANGE_BAUD_RATE_CMD:
+					BL_VidChangeBaudRate(BL_Host_Buf);
+					loc_bl_status = BL_ACK;
+						break;
+					case CBL_SET_FRAME_MODE_CMD:
+					BL_VidSetFrameMode(BL_Host_Buf);
+					loc_bl_status = BL_ACK;
+						break;
+					case CBL_BATCH_CMD:
+					BL_VidBatch(BL_Host_Buf);
+					loc_bl_status = BL_ACK;
+						break;
+					case CBL_SET_CRC_MODE_CMD:
+					BL_VidSetCrcMode(BL_Host_Buf);
+					loc_bl_status = BL_ACK;
+						break;
+					case CBL_SESSION_DIGEST_CMD:
+					BL_VidSessionDigest(BL_Host_Buf);
+					loc_bl_status = BL_ACK;
+						break;
+					case CBL_IMAGE_VERIFY_CMD:
+					BL_VidImageVerify(BL_Host_Buf);
+					loc_bl_status = BL_ACK;
+						break;
+					case CBL_SET_WRITE_MODE_CMD:
+					BL_VidSetWriteMode(BL_Host_Buf);
+					loc_bl_status = BL_ACK;
+						break;
+					case CBL_IMAGE_MANIFEST_CMD:
+					BL_VidImageManifest(BL_Host_Buf);
 					loc_bl_status = BL_ACK;
 						break;
 					case CBL_ERASE_CMD:
@@ -323,8 +683,10 @@ Bl_Status Bl_Uart_Fetch_Host_Cmd(void)
 					loc_bl_status = BL_NACK;
 						break;
 				 }
-			}
 	}
+	/******** reply shorter than announced (e.g. read refused) must not stay in gather buffer *****/
+	BL_Reply_Pending = 0U;
+	BL_HOST_LINK->Flush(BL_TRANSPORT_FLUSH_NO_WAIT);
 	return loc_bl_status;
 }
 
@@ -339,50 +701,31 @@ return CRC_verify_passed if success else  CRC_verify_Failed
 **/
 static uint8	BL_uint8CRC_Verify(uint8*pdata , uint32 datalen , uint32 host_crc)
 {
-		uint8_t crc_status=CRC_VERIFY_FAILED;
-	uint32_t MCU_crc_calculated=0;
-	uint32_t DataBuffer=0;
-	for(uint8_t count=0;count<datalen;count++)
-	{
-		DataBuffer=(uint32_t)pdata[count];
-		MCU_crc_calculated = HAL_CRC_Accumulate(&hcrc, &DataBuffer, 1);
-
-	}
-	__HAL_CRC_DR_RESET(&hcrc);
-	if(host_crc== MCU_crc_calculated)
-	{
-		crc_status=CRC_VERFIY_SUCCESS;
+	uint8 crc_status = CRC_VERIFY_FAILED;
+	/****** negotiated convention , direct register writes instead of one HAL call per byte ****/
+	if(host_crc == BL_CRC_uint32Calculate(pdata , datalen)){
+		crc_status = CRC_VERFIY_SUCCESS;
+	}else{
+		crc_status = CRC_VERIFY_FAILED;
 	}
-	else
-	{
-		crc_status=CRC_VERIFY_FAILED;
+	return crc_status;
+}
+/*****BL_uint8FrameCrcVerify 
+*@param[in] frame decoded frame
+return CRC_verify_passed if success else  CRC_verify_Failed
+**/
+static uint8	BL_uint8FrameCrcVerify(const Bl_Frame *frame)
+{
+	uint8 crc_status = CRC_VERIFY_FAILED;
+	/****** convention changed since the frame arrived (mode command) -> calculate again ****/
+	if(frame->Crc_Mode != BL_CRC_uint8GetMode()){
+		crc_status = BL_uint8CRC_Verify(frame->Buffer , (uint32)frame->Len - CRC_SIZE_BYTE , frame->Host_Crc);
+	}else if(frame->Host_Crc == frame->Crc){
+		crc_status = CRC_VERFIY_SUCCESS;
+	}else{
+		crc_status = CRC_VERIFY_FAILED;
 	}
-
 	return crc_status;
-	
-	//uint8 loc_crc_status = CRC_VERIFY_FAILED;
-	//uint32 mc_crc_calc =0U;
-	//uint8	loc_data_counter =0U;
-	//uint32 loc_dataBuf = 0U;
-	/*********calculate Crc for first Two bytes to be compared***/
-//	for (loc_data_counter =0U; loc_data_counter<datalen ; loc_data_counter++)
-//	{
-//		loc_dataBuf = (uint32)pdata[loc_data_counter]; // assign single byte of buffer for crc check
-//		mc_crc_calc = HAL_CRC_Accumulate(BL_CRC_ENGINE , &loc_dataBuf , 1U); // calc for one byte every time
-//	}
-//	
-//	/**********Reset Crc engine***/
-//	__HAL_CRC_DR_RESET(BL_CRC_ENGINE);
-//	
-//	/******Check crc values*****/
-//	if(mc_crc_calc == host_crc){
-//	/*CRC success*/
-//		loc_crc_status = CRC_VERFIY_SUCCESS;
-//	}else{
-//		/**crc failed*/
-//		loc_crc_status = CRC_VERIFY_FAILED;
-//	}
-//	return loc_crc_status;
 }
 /*****BL_VidSendAck 
 **@param[in] bl_reply_len bootloader reply length
@@ -392,7 +735,12 @@ static void BL_VidSendAck(uint8 bl_reply_len)
 	uint8 loc_Ack[2U] ={0U};
 	loc_Ack[0U] = CBL_SEND_ACK;
 	loc_Ack[1U] = bl_reply_len;
-	HAL_UART_Transmit(BL_HOST_COMMUNICATION_UART,(uint8*)loc_Ack,2U,HAL_MAX_DELAY);
+	/******* ACK is gathered with its payload and sent in one DMA transfer ******/
+	BL_HOST_LINK->Transmit(loc_Ack , 2U);
+	BL_Reply_Pending = bl_reply_len;
+	if(0U == BL_Reply_Pending){
+		BL_HOST_LINK->Flush(BL_TRANSPORT_FLUSH_NO_WAIT);
+	}
 }
 /*****BL_VidSendNack 
 **@param[in] 
@@ -400,14 +748,43 @@ static void BL_VidSendAck(uint8 bl_reply_len)
 static void BL_VidSendNack(void)
 {
 	uint8 loc_Nack = CBL_SEND_NACK;
-	HAL_UART_Transmit(BL_HOST_COMMUNICATION_UART,&loc_Nack,1U,HAL_MAX_DELAY); // transmit NACK
+	BL_HOST_LINK->Transmit(&loc_Nack , 1U); // transmit NACK
+	BL_Reply_Pending = 0U;
+	BL_HOST_LINK->Flush(BL_TRANSPORT_FLUSH_NO_WAIT);
 }
 /*****BL_VidSendReplyTo_Host 
 **@param[in] host_buffer pointer to data
 **@param[in] data_len length of data
 **/
 static void BL_VidSendReplyTo_Host(uint8 * host_buffer, uint32 data_len){
-	HAL_UART_Transmit(BL_HOST_COMMUNICATION_UART , host_buffer,data_len,HAL_MAX_DELAY);
+	BL_HOST_LINK->Transmit(host_buffer , (uint16)data_len);
+	/******* whole announced reply gathered -> send it , command loop goes on meanwhile ******/
+	BL_Reply_Pending = (data_len >= BL_Reply_Pending) ? 0U : (uint16)(BL_Reply_Pending - data_len);
+	if(0U == BL_Reply_Pending){
+		BL_HOST_LINK->Flush(BL_TRANSPORT_FLUSH_NO_WAIT);
+	}
+}
+/*****BL_VidSendWindowReply
+**@param[in] window_status WINDOW_WRITE_STATUS_xx
+**@param[in] expected_seq next sequence expected from host
+**/
+static void BL_VidSendWindowReply(uint8 window_status , uint16 expected_seq)
+{
+	uint8 loc_reply[BL_WINDOW_WRITE_REPLY_LEN] = {0U};
+	loc_reply[0U] = window_status;
+	loc_reply[1U] = (uint8)(expected_seq & 0xFFU);
+	loc_reply[2U] = (uint8)(expected_seq >> 8U);
+	BL_VidSendAck(BL_WINDOW_WRITE_REPLY_LEN);
+	BL_VidSendReplyTo_Host(loc_reply , BL_WINDOW_WRITE_REPLY_LEN);
+}
+/*****BL_uint32MemoryCrc
+**@param[in] address start address
+**@param[in] len number of bytes
+**@return crc32 of memory , same convention as frame crc
+**/
+static uint32 BL_uint32MemoryCrc(uint32 address , uint32 len)
+{
+	return BL_CRC_uint32CalculateRange(address , len);
 }
 
 /*****Host_uint8AddressVerification 
@@ -436,39 +813,125 @@ static	uint8 Host_uint8AddressVerification(uint32 address)
 static uint8 Flash_Mem_Write_Payload(uint8 *payload , uint32 payload_address , uint16 payload_len)
 {
 	HAL_StatusTypeDef loc_status = HAL_ERROR;
-	uint16	loc_payload_counter =0U;
 	uint8  loc_flash_status  = FLASH_WRITE_STATUS_FAIL;
+	/****** verified image marker no longer holds ****/
+	BL_VidBootCacheInvalidate();
+	/****** a sector is erased only when the payload can't be programmed over it ****/
+	loc_status = (FLASH_WRITE_STATUS_PASS == BL_uint8AutoErase(payload , payload_address , payload_len)) ? HAL_OK : HAL_ERROR;
+#if BL_FLASH_WRITE_PATH == BL_FLASH_PATH_STREAM
+	/****Flash control register access 
+	* first payload of session -> unlock flash , PG and PSIZE set once
+	* End of session (digest , erase , jump) -> Lock flash
+	*/
+	if(HAL_OK == loc_status){
+		loc_status = (HAL_StatusTypeDef)BL_FLASH_uint8Begin();
+	}
+	if(HAL_OK == loc_status){
+		/********Program Flash , widest unit of the voltage range*******/
+		loc_status = (HAL_StatusTypeDef)BL_FLASH_uint8ProgramBuffer(payload_address , payload , payload_len);
+	}
+	if(HAL_OK != loc_status){
+		loc_flash_status = FLASH_WRITE_STATUS_FAIL;
+		/****** leave the flash locked on failure ****/
+		(void)BL_FLASH_uint8End();
+	}else{
+		loc_flash_status = FLASH_WRITE_STATUS_PASS;
+	}
+#else
 	/****Flash control register access 
 	* first -> unlock flash
 	* End   -> Lock flash
 	*/
 	/******unlock flash****/
-	loc_status = HAL_FLASH_Unlock();
+	if(HAL_OK == loc_status){
+		loc_status = HAL_FLASH_Unlock();
+	}
 	if(HAL_OK != loc_status){
 	loc_flash_status = FLASH_WRITE_STATUS_FAIL;
 	}else{
-	for(loc_payload_counter = 0U ; loc_payload_counter<payload_len;loc_payload_counter++ )
-	{
-		/********Program Flash one byte*******/
-		loc_status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_BYTE ,payload_address + loc_payload_counter,payload[loc_payload_counter]);
-		if(HAL_OK !=  loc_status){
-			loc_flash_status = FLASH_WRITE_STATUS_FAIL;
-		break;
-		}else{
+	/********Program Flash , widest unit of the voltage range*******/
+	loc_status = (HAL_StatusTypeDef)BL_FLASH_uint8Program(payload_address , payload , payload_len);
+	if(HAL_OK !=  loc_status){
+		loc_flash_status = FLASH_WRITE_STATUS_FAIL;
+		/****** leave the flash locked on failure too ****/
+		(void)HAL_FLASH_Lock();
+	}else{
 		loc_flash_status = FLASH_WRITE_STATUS_PASS;
-		}
 	}
 }
 	if ((FLASH_WRITE_STATUS_PASS == loc_flash_status) && (HAL_OK == loc_status)){
 		loc_status = HAL_FLASH_Lock();
 		if(HAL_OK !=loc_status ){
 		loc_flash_status = FLASH_WRITE_STATUS_FAIL;
-		}else{
-		loc_flash_status = FLASH_WRITE_STATUS_PASS;
 		}
 	}
+#endif
+	if(FLASH_WRITE_STATUS_PASS == loc_flash_status){
+		/****** what landed in memory , not what was received ****/
+		BL_VidSessionUpdate(payload_address , payload_len);
+		BL_Session_Programmed += BL_FLASH_uint32LastProgrammed();
+	}
 	return loc_flash_status;
 }
+/*****BL_uint8WritePayload 
+**@param[in] payload pointer to payload as received
+**@param[in] payload_address destination address
+**@param[in] payload_len payload length (up to BL_HOST_MAX_PAYLOAD_LENGTH)
+**/
+static uint8 BL_uint8WritePayload(uint8 *payload , uint32 payload_address , uint16 payload_len)
+{
+	uint8 *write_buffer = (uint8 *)BL_Write_Buffer;
+	uint32 block_offset = payload_address & (BL_AES_BLOCK_LEN - 1U);
+	uint8 *write_data = payload;
+	uint8 write_status = FLASH_WRITE_STATUS_FAIL;
+	uint8 chunk_status = BL_MERKLE_CHUNK_OUTSIDE;
+	uint32 chunk_index = 0U;
+	
+	if((BL_WRITE_MODE_AES_CTR == BL_Write_Mode) || (BL_MERKLE_STATE_ACTIVE == BL_Merkle_State)){
+		if(payload_len <= BL_HOST_MAX_PAYLOAD_LENGTH){
+			/****** payload at its offset inside the first counter block (word aligned for DMA) ****/
+			memcpy(&write_buffer[block_offset] , payload , payload_len);
+			write_data = &write_buffer[block_offset];
+			if(BL_WRITE_MODE_AES_CTR == BL_Write_Mode){
+				/****** decrypted in place by DMA ****/
+				BL_AES_VidCtrCrypt(write_buffer , (block_offset + payload_len + (BL_AES_BLOCK_LEN - 1U)) / BL_AES_BLOCK_LEN ,
+					payload_address / BL_AES_BLOCK_LEN);
+			}
+		}else{
+			/****** larger than the program buffer , not sent by the host ****/
+			chunk_status = BL_MERKLE_CHUNK_INVALID;
+		}
+	}
+	if((BL_MERKLE_STATE_ACTIVE == BL_Merkle_State) && (BL_MERKLE_CHUNK_INVALID != chunk_status)){
+		/****** plain text checked against its leaf , a bad chunk never reaches the flash ****/
+		chunk_status = BL_uint8MerkleChunk(write_data , payload_address , payload_len , &chunk_index);
+	}
+#if BL_IMAGE_AUTH == BL_IMAGE_AUTH_ENABLE
+	/****** application and header sectors take checked chunks only ****/
+	if((BL_MERKLE_CHUNK_VALID != chunk_status) && ((payload_address + payload_len) > FLASH_SECTOR1_BASE_ADDRESS) &&
+		(payload_address <= STM32F756_FLASH_END)){
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Unauthenticated write at 0x%X refused \r\n",payload_address);
+#endif
+		chunk_status = BL_MERKLE_CHUNK_INVALID;
+	}
+#endif
+	if(BL_MERKLE_CHUNK_INVALID != chunk_status){
+		write_status = Flash_Mem_Write_Payload(write_data , payload_address , payload_len);
+		if((FLASH_WRITE_STATUS_PASS == write_status) && (BL_MERKLE_CHUNK_VALID == chunk_status)){
+			/****** leaf was checked on the buffer , F7 doesn't flag a program over non erased flash : read it back ****/
+			if(0 == memcmp((const void *)payload_address , write_data , payload_len)){
+				BL_VidMerkleChunkDone(chunk_index);
+			}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+				Bl_Print_Msg("Chunk at 0x%X differs in flash \r\n",payload_address);
+#endif
+				write_status = FLASH_WRITE_STATUS_FAIL;
+			}
+		}
+	}
+	return write_status;
+}
 /*****Flash_Mem_Write_Payload 
 **@param[in] sector_number sector for start from it
 **@param[in] numberofsectors  No.of sectors to erase
@@ -476,9 +939,8 @@ static uint8 Flash_Mem_Write_Payload(uint8 *payload , uint32 payload_address , u
 static uint8 Perform_uint8FlashErase(uint8 sector_number , uint8 numberofsectors)
 {
 	uint8 sector_validity = SECTOR_IS_INVALID;
-	FLASH_EraseInitTypeDef  Eraseinit_;
 	uint8 Remaining_Sector =0U;
-	uint32 sectorerror_ =0U;
+	uint8 erase_sector = BL_FLASH_ERASE_MASS;
 	/****** check for no of sectors *********/
 	if((numberofsectors > FLASH_MAX_SECTORS)){
 		/*** sectors out of Rang */		
@@ -488,7 +950,7 @@ static uint8 Perform_uint8FlashErase(uint8 sector_number , uint8 numberofsectors
 				/********* Check Mass Erase*******/
 				if((FLASH_MASS_ERASE == sector_number )){
 					/******* perform mass Erase ****/
-				  Eraseinit_.TypeErase = FLASH_TYPEERASE_MASSERASE;
+				  erase_sector = BL_FLASH_ERASE_MASS;
 						/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 		Bl_Print_Msg("Flash Mass Erase Activation \r\n");
@@ -502,27 +964,23 @@ static uint8 Perform_uint8FlashErase(uint8 sector_number , uint8 numberofsectors
 					if(numberofsectors > Remaining_Sector){
 						numberofsectors = Remaining_Sector;    /***** assign remaining value to NoofSectors**/
 					}
-				/******* perform mass Erase ****/
-				  Eraseinit_.TypeErase = FLASH_TYPEERASE_SECTORS;
 					/********* initial flash sector*****/
-					Eraseinit_.Sector = sector_number; 
-					/*************** No of sectors to erase**/
-					Eraseinit_.NbSectors = numberofsectors;  
+					erase_sector = sector_number; 
 				}	
-					Eraseinit_.VoltageRange = FLASH_VOLTAGE_RANGE_3 ; /* Device operating range: 2.7V to 3.6V */
-				/********unlock flash********/
-				  HAL_StatusTypeDef	loc_status =HAL_ERROR;
-				
-					loc_status = HAL_FLASH_Unlock();
-				/*********** perform mass  or sector erase ********/
-					loc_status = HAL_FLASHEx_Erase(&Eraseinit_,&sectorerror_);
-				if((HAL_ERASE_SUCCESS == sectorerror_)){
+				/****** verified image marker no longer holds ****/
+					BL_VidBootCacheInvalidate();
+				/*********** perform mass or sector erase , next host frame is fetched meanwhile ********/
+				if(HAL_OK == BL_FLASH_uint8Erase(erase_sector , numberofsectors , BL_VidFlashBusy)){
 					sector_validity = FLASH_SUCCESS_ERASE;
+					/****** no second erase on the first write of the session ****/
+					if(FLASH_MASS_ERASE == sector_number){
+						BL_Erased_Sectors = (uint8)((1U << FLASH_MAX_SECTORS) - 1U);
+					}else{
+						BL_Erased_Sectors |= (uint8)(((1U << numberofsectors) - 1U) << sector_number);
+					}
 				}else{
 					sector_validity = FLASH_FAILED_ERASE;
 				}
-				/*********lock flash*****/
-				loc_status = HAL_FLASH_Lock();
 		}
 	  else{
 					sector_validity = FLASH_FAILED_ERASE;
@@ -530,6 +988,98 @@ static uint8 Perform_uint8FlashErase(uint8 sector_number , uint8 numberofsectors
 	}
 	return sector_validity;
 }
+
+/*****BL_uint8FlashSector 
+**@param[in] address flash address
+**@return sector holding the address , FLASH_MAX_SECTORS outside of flash
+**/
+static uint8 BL_uint8FlashSector(uint32 address)
+{
+	uint8 sector = FLASH_MAX_SECTORS;
+	uint8 sector_count = 0U;
+	
+	for(sector_count = 0U ; sector_count < FLASH_MAX_SECTORS ; sector_count++)
+	{
+		if((address >= BL_Flash_Sector_Base[sector_count]) && (address < BL_Flash_Sector_Base[sector_count + 1U])){
+			sector = sector_count;
+			break;
+		}
+	}
+	return sector;
+}
+
+/*****BL_uint8AutoErase 
+**@param[in] payload data to program
+**@param[in] address destination of payload
+**@param[in] len payload length
+**@return FLASH_WRITE_STATUS_PASS or FLASH_WRITE_STATUS_FAIL
+**/
+static uint8 BL_uint8AutoErase(const uint8 *payload , uint32 address , uint16 len)
+{
+	uint8 erase_status = FLASH_WRITE_STATUS_PASS;
+	uint8 first_sector = BL_uint8FlashSector(address);
+	uint8 last_sector = 0U;
+	uint8 sector = 0U;
+	uint32 slice_start = 0U;
+	uint32 slice_end = 0U;
+	
+	if((BL_AUTO_ERASE_ENABLE == BL_AUTO_ERASE) && (0U != len) && (FLASH_MAX_SECTORS != first_sector)){
+		last_sector = BL_uint8FlashSector(address + len - 1U);
+		if(FLASH_MAX_SECTORS == last_sector){
+			last_sector = FLASH_MAX_SECTORS - 1U;
+		}
+		/****** a payload crosses at most one sector boundary ****/
+		for(sector = first_sector ; sector <= last_sector ; sector++)
+		{
+			if((sector >= BL_AUTO_ERASE_FIRST_SECTOR) && (0U == (BL_Erased_Sectors & (1U << sector)))){
+				slice_start = (address > BL_Flash_Sector_Base[sector]) ? address : BL_Flash_Sector_Base[sector];
+				slice_end = ((address + len) < BL_Flash_Sector_Base[sector + 1U]) ? (address + len) : BL_Flash_Sector_Base[sector + 1U];
+				if(1U == BL_uint8FlashInPlace(&payload[slice_start - address] , slice_start , slice_end - slice_start)){
+					/****** erased or unchanged flash : no erase , identical units are skipped ****/
+					BL_Written_Sectors |= (uint8)(1U << sector);
+				}else if(0U == (BL_Written_Sectors & (1U << sector))){
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+					Bl_Print_Msg("Sector %d erased before its first write in session \r\n",sector);
+#endif
+					if(FLASH_SUCCESS_ERASE != Perform_uint8FlashErase(sector , 1U)){
+						erase_status = FLASH_WRITE_STATUS_FAIL;
+						break;
+					}
+				}else{
+					/****** an erase would lose the data this session already programmed ****/
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+					Bl_Print_Msg("Sector %d written in session , erase it by command first \r\n",sector);
+#endif
+					erase_status = FLASH_WRITE_STATUS_FAIL;
+					break;
+				}
+			}
+		}
+	}
+	return erase_status;
+}
+
+/*****BL_uint8FlashInPlace 
+**@param[in] data data to program
+**@param[in] address destination in flash
+**@param[in] len data length
+**@return 1 when programming only clears bits ((flash & data) == data) , 0 otherwise
+**/
+static uint8 BL_uint8FlashInPlace(const uint8 *data , uint32 address , uint32 len)
+{
+	const uint8 *flash = (const uint8 *)address;
+	uint32 count = 0U;
+	uint8 in_place = 1U;
+	
+	for(count = 0U ; count < len ; count++)
+	{
+		if((flash[count] & data[count]) != data[count]){
+			in_place = 0U;
+			break;
+		}
+	}
+	return in_place;
+}
 /*****STM32F756_Get_RDP_LEVEL
 **@param[in] 
 **/
@@ -738,6 +1288,9 @@ static void BL_Jump_To_App(void){
 	__set_MSP(MSP_Val);
 	
 	/********** deinitialize modules to reset state**/
+	(void)BL_FLASH_uint8End();
+	BL_FLASH_VidDeInit();
+	BL_HOST_LINK->DeInit();
 	HAL_RCC_DeInit();
 	
 	/********* Jump To Application **********/
@@ -750,24 +1303,17 @@ static void BL_Jump_To_App(void){
 **/
 static void BL_VidGetHelp(uint8 *Host_buffer)
 {
-	uint16 Host_cmd_packet_len = 0U;
-	uint32 Host_Crc32 = 0U;
-	
-	/***********Extract crc32 and cmd packet from host****/
-	Host_cmd_packet_len = Host_buffer[0U] + 1U;
-	Host_Crc32 = *((uint32 *)((Host_buffer + Host_cmd_packet_len) - CRC_SIZE_BYTE));
-	
 	/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 		Bl_Print_Msg(" Get Cmd Received \r\n");
 #endif
 	/****CRC verify check*****/
-	if(CRC_VERFIY_SUCCESS == BL_uint8CRC_Verify((uint8 *)&Host_buffer[0],Host_cmd_packet_len - 4U ,Host_Crc32)){
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 		Bl_Print_Msg("CRC Verification Successed \r\n");
 #endif
-		BL_VidSendAck(15U); 
-		BL_VidSendReplyTo_Host((uint8*)&Bl_Supported_Commands[0U],15U); 
+		BL_VidSendAck(BL_NO_OF_SUPPORTED_CMD); 
+		BL_VidSendReplyTo_Host((uint8*)&Bl_Supported_Commands[0U],BL_NO_OF_SUPPORTED_CMD); 
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 		Bl_Print_Msg("Here is List Of Supported Commands\r\n");
 		for(uint8 i=0 ;i <BL_NO_OF_SUPPORTED_CMD;i++){
@@ -788,19 +1334,13 @@ static void BL_VidGetHelp(uint8 *Host_buffer)
 static void BL_VidGetVersion(uint8 *Host_buffer)
 {
 uint8 bl_version[4U] = {CBL_VENDOR_ID , CBL_SW_MAJOR_VERSION ,CBL_SW_MINOR_VERSION,CBL_SW_PATCH_VERSION};
-	uint16 Host_cmd_packet_len = 0U;
-	uint32 Host_Crc32 = 0U;
-	
-	/****Extract Crc32 and cmd packet from host***/
-	Host_cmd_packet_len = Host_buffer[0U] +1U;  
-	Host_Crc32 = *((uint32*)((Host_buffer + Host_cmd_packet_len) - CRC_SIZE_BYTE));  // derefernce to first byte of CRC
 
 /*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 		Bl_Print_Msg("Read Bootloader Version \r\n");
 #endif
 	/****CRC verify check*****/
-	if (CRC_VERFIY_SUCCESS == BL_uint8CRC_Verify((uint8*)&Host_buffer[0U],Host_cmd_packet_len - 4U,Host_Crc32)){
+	if (CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
 		#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 		Bl_Print_Msg("CRC verification successed \r\n");
 		#endif
@@ -827,12 +1367,6 @@ uint8 bl_version[4U] = {CBL_VENDOR_ID , CBL_SW_MAJOR_VERSION ,CBL_SW_MINOR_VERSI
 static void BL_VidGetID(uint8 *Host_buffer)
 {
 	uint16 MC_Identification_Number = 0U;
-	uint16 Host_cmd_packet_len = 0U;
-	uint32 Host_Crc32 = 0U;
-	
-	/*******Extract Crc and cmd packet from host*****/
-	Host_cmd_packet_len = Host_buffer[0U] +1U;
-	Host_Crc32 =*((uint32*)((Host_buffer + Host_cmd_packet_len) - CRC_SIZE_BYTE));
 	
 	/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
@@ -840,7 +1374,7 @@ static void BL_VidGetID(uint8 *Host_buffer)
 #endif
 	
 	/****** CRC Verification ***/
-	if(CRC_VERFIY_SUCCESS == BL_uint8CRC_Verify((uint8 *)&Host_buffer[0U],Host_cmd_packet_len - 4U,Host_Crc32))
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame))
 	{
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 		Bl_Print_Msg("CRC Verification Successed \r\n");
@@ -872,9 +1406,9 @@ static void BL_VidReadMemory(uint8 *Host_buffer)
 	uint8	 address_verification = ADDRESS_IS_INVALID;
 	uint8 RDP_level = 0xEE;
 	
-	/*******Extract Crc and cmd packet from host*****/
-	Host_cmd_packet_len = Host_buffer[0U] +1U;
-	Host_Crc32 =*((uint32*)((Host_buffer + (Host_cmd_packet_len-2U)) - CRC_SIZE_BYTE));
+	/*******crc is followed by the length bytes here , not covered by the frame crc*****/
+	Host_cmd_packet_len = BL_Host_Frame->Len;
+	Host_Crc32 = BL_Transport_uint32GetLE(&Host_buffer[(Host_cmd_packet_len - 2U) - CRC_SIZE_BYTE]);
 	
 	/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
@@ -888,7 +1422,7 @@ static void BL_VidReadMemory(uint8 *Host_buffer)
 		Bl_Print_Msg("CRC Verification Successed \r\n");
 #endif
 		/*******Extract address from packet*******/
-		Host_address = *((uint32 *)&Host_buffer[2U]);
+		Host_address = BL_Host_Frame->Address;
 		/*****Check address Verification******/
 		address_verification = Host_uint8AddressVerification(Host_address);
 		if (ADDRESS_IS_VALID == address_verification)
@@ -904,7 +1438,7 @@ static void BL_VidReadMemory(uint8 *Host_buffer)
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 		Bl_Print_Msg(" Data Length 0x%x\r\n",DataLength);
 #endif
-			Host_Crc32 =*((uint32*)((Host_buffer + (Host_cmd_packet_len-1U))));
+			Host_Crc32 = Host_buffer[Host_cmd_packet_len - 1U];	// host buffer isn't cleared any more , one byte only
 			uint16 Data_buffer[DataLength]; 
 			if(Host_Crc32 == ((DataLength) ^ 0xff)){
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
@@ -951,27 +1485,21 @@ static void BL_VidReadMemory(uint8 *Host_buffer)
 **/
 static void BL_VidGoToAddr(uint8 *Host_buffer)
 {
-	uint16 Host_cmd_packet_len = 0U;
-	uint32 Host_Crc32 = 0U;
 	uint32 Host_address =0U;
 	uint8	 address_verification = ADDRESS_IS_INVALID;
 	
-	/*******Extract Crc and cmd packet from host*****/
-	Host_cmd_packet_len = Host_buffer[0U] +1U;
-	Host_Crc32 =*((uint32*)((Host_buffer + Host_cmd_packet_len) - CRC_SIZE_BYTE));
-	
 	/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 	Bl_Print_Msg("Jump To Specified Address Command Received \r\n");
 #endif
 	/****CRC verify check*****/
-	if(CRC_VERFIY_SUCCESS == BL_uint8CRC_Verify((uint8 *)&Host_buffer[0],Host_cmd_packet_len - 4U ,Host_Crc32)){
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 		Bl_Print_Msg("CRC Verification Successed \r\n");
 #endif
 		BL_VidSendAck(1U);
 		/*******Extract address from packet*******/
-		Host_address = *((uint32 *)&Host_buffer[2U]);
+		Host_address = BL_Host_Frame->Address;
 		/*****Check address Verification******/
 		address_verification = Host_uint8AddressVerification(Host_address);
 		if (ADDRESS_IS_VALID == address_verification)
@@ -988,6 +1516,10 @@ static void BL_VidGoToAddr(uint8 *Host_buffer)
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 			Bl_Print_Msg("Jump To : 0x%X \r\n",jump_add);
 #endif
+			/*****host link DMA must not keep writing into application RAM******/
+			(void)BL_FLASH_uint8End();
+			BL_FLASH_VidDeInit();
+			BL_HOST_LINK->DeInit();
 			jump_add();
 		}else{
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
@@ -1010,30 +1542,26 @@ static void BL_VidGoToAddr(uint8 *Host_buffer)
 **/
 static void BL_VidWriteMemory(uint8 *Host_buffer)
 {
-	uint16 Host_cmd_packet_len = 0U;
-	uint32 Host_Crc32 = 0U;
+	const uint8 *Host_info = BL_Host_Frame->Info;
 	uint32 Host_address =0U;
 	uint32 Payload_len =0U;
 	uint8	 address_verification = ADDRESS_IS_INVALID;
 	uint8  flash_status = FLASH_WRITE_STATUS_FAIL;
 	
-	/*******Extract Crc and cmd packet from host*****/
-	Host_cmd_packet_len = Host_buffer[0U] +1U;
-	Host_Crc32 =*((uint32*)((Host_buffer + Host_cmd_packet_len) - CRC_SIZE_BYTE));
-	
 	/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 	Bl_Print_Msg("Jump To Specified Address Command Received \r\n");
 #endif
-	/****CRC verify check*****/
-		if(CRC_VERFIY_SUCCESS == BL_uint8CRC_Verify((uint8 *)&Host_buffer[0],Host_cmd_packet_len - 4U ,Host_Crc32)){
+	/*******payload length from info "address (4) | payload len | payload" , the frame is not cleared between commands*****/
+	Payload_len = (BL_Host_Frame->Info_Len > 4U) ? Host_info[4U] : 0U;
+	/****CRC verify check (payload length must match frame length too)*****/
+		if((BL_Host_Frame->Info_Len == (5U + Payload_len)) && (CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame))){
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 		Bl_Print_Msg("CRC Verification Successed \r\n");
 #endif
 			BL_VidSendAck(1U);
 		/*******Extract address  and payload from packet*******/
-			Host_address = *((uint32 *)&Host_buffer[2U]);
-			Payload_len = Host_buffer[6U];
+			Host_address = BL_Host_Frame->Address;
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 			Bl_Print_Msg("Host Address is : 0x%X \r\n",Host_address);
 #endif
@@ -1044,7 +1572,7 @@ static void BL_VidWriteMemory(uint8 *Host_buffer)
 		Bl_Print_Msg("Address Validation Successed \r\n");
 #endif
 				/******Write payload to flash******/
-				flash_status = Flash_Mem_Write_Payload((uint8*)&Host_buffer[7U],Host_address,Payload_len);
+				flash_status = BL_uint8WritePayload((uint8*)&Host_info[5U],Host_address,(uint16)Payload_len);
 				if(FLASH_WRITE_STATUS_PASS == flash_status){
 					/*********Reply payload to host******/
 					BL_VidSendReplyTo_Host((uint8*)&flash_status,1U);
@@ -1074,33 +1602,935 @@ static void BL_VidWriteMemory(uint8 *Host_buffer)
 	}
 }
 
-/*****BL_VidErase 
+/*****BL_VidWindowWriteMemory 
+**@description frame -> header | cmd | seq (2 , LE) | address (4) | payload len | payload | crc32
+	payload len is 1 byte in legacy frames and 2 bytes (LE) in extended frames
 **@param[in] Host_buffer pointer to data
 **/
-static void BL_VidErase(uint8 *Host_buffer)
+static void BL_VidWindowWriteMemory(uint8 *Host_buffer)
 {
-	uint16 Host_cmd_packet_len = 0U;
-	uint32 Host_Crc32 = 0U;
-	uint8 flash_erase_status = FLASH_FAILED_ERASE;
+	const uint8 *Host_info = BL_Host_Frame->Info;
+	uint16 Payload_offset = 0U;
+	uint32 Host_address =0U;
+	uint16 Host_seq = 0U;
+	uint16 Payload_len =0U;
+	uint8	 address_verification = ADDRESS_IS_INVALID;
+	uint8  flash_status = FLASH_WRITE_STATUS_FAIL;
 	
-	/*******Extract Crc and cmd packet from host*****/
-	Host_cmd_packet_len = Host_buffer[0U] +1U;
-	Host_Crc32 =*((uint32*)((Host_buffer + Host_cmd_packet_len) - CRC_SIZE_BYTE));
+	/*******payload length field of the frame header type , offsets from the cmd code*****/
+	if(BL_TRANSPORT_FRAME_EXT_HEADER_LEN == BL_Host_Frame->Header_Len){
+		Payload_len = (uint16)(Host_info[6U] | ((uint16)Host_info[7U] << 8U));
+		Payload_offset = 8U;
+	}else{
+		Payload_len = Host_info[6U];
+		Payload_offset = 7U;
+	}
 	
-	/*****Log message***/	
-#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
-	Bl_Print_Msg("Sector or Mass Erase of Flash \r\n");
-#endif
-	/*********Crc verification ***********/ 
-	if(CRC_VERFIY_SUCCESS == BL_uint8CRC_Verify((uint8 *)&Host_buffer[0U],Host_cmd_packet_len -4U , Host_Crc32))
-{
-		/*****Log message***/	
+	/****CRC verify check (payload length must match frame length too)*****/
+	if((BL_Host_Frame->Info_Len != (Payload_offset + Payload_len)) ||
+		(CRC_VERFIY_SUCCESS != BL_uint8FrameCrcVerify(BL_Host_Frame))){
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
-	Bl_Print_Msg("Crc Verification Passed \r\n");
+		Bl_Print_Msg("Window frame CRC Verification Failed \r\n");
 #endif
-	BL_VidSendAck(1U);
+		/****** sequence can't be trusted , ask for resend once per expected frame ***/
+		if(BL_Window_Resend_Seq != BL_Window_Expected_Seq){
+			BL_Window_Resend_Seq = BL_Window_Expected_Seq;
+			BL_VidSendWindowReply(WINDOW_WRITE_STATUS_RESEND , BL_Window_Expected_Seq);
+		}
+		return;
+	}
+	Host_seq = (uint16)(Host_info[0U] | ((uint16)Host_info[1U] << 8U));
+	Host_address = BL_Transport_uint32GetLE(&Host_info[2U]);
 	
-	/********** perform Erase ***********/
+	/****** sequence 0 opens a new window only while none is open , a late copy of frame 0 must not rewind it ******/
+	if((0U == Host_seq) && (0U == BL_Window_Open)){
+		BL_Window_Expected_Seq = 0U;
+		BL_Window_Resend_Seq = BL_WINDOW_SEQ_NONE;
+	}
+	BL_Window_Open = 1U;
+	
+	if(Host_seq == BL_Window_Expected_Seq){
+		/*****Check address Verification***/
+		address_verification = Host_uint8AddressVerification(Host_address);
+		if(ADDRESS_IS_VALID == address_verification){
+			/******Write payload to flash , next frames keep arriving by DMA meanwhile******/
+			flash_status = BL_uint8WritePayload(&BL_Host_Frame->Info[Payload_offset],Host_address,Payload_len);
+		}
+		if(FLASH_WRITE_STATUS_PASS == flash_status){
+			BL_Window_Expected_Seq++;
+			BL_VidSendWindowReply(WINDOW_WRITE_STATUS_ACK , BL_Window_Expected_Seq);
+		}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Window frame %d write Failed at 0x%X \r\n",Host_seq,Host_address);
+#endif
+			BL_VidSendWindowReply(WINDOW_WRITE_STATUS_FAIL , BL_Window_Expected_Seq);
+		}
+	}else if(((uint16)(BL_Window_Expected_Seq - Host_seq)) <= BL_WINDOW_WRITE_MAX_FRAMES){
+		/****** duplicate of an already written frame (host went back) , confirm again ****/
+		BL_VidSendWindowReply(WINDOW_WRITE_STATUS_ACK , BL_Window_Expected_Seq);
+	}else{
+		/****** gap , a previous frame was lost. Frames after the gap are dropped ****/
+		if(BL_Window_Resend_Seq != BL_Window_Expected_Seq){
+			BL_Window_Resend_Seq = BL_Window_Expected_Seq;
+			BL_VidSendWindowReply(WINDOW_WRITE_STATUS_RESEND , BL_Window_Expected_Seq);
+		}
+	}
+}
+
+/*****BL_VidSetFrameMode 
+**@description frame -> len | cmd | mode | crc32 (always a legacy frame)
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidSetFrameMode(uint8 *Host_buffer)
+{
+	uint16 max_frame_len = BL_HOST_BUFFER_RX_LENGTH;
+	uint8 frame_mode_reply[BL_FRAME_MODE_REPLY_LEN] = {0U};
+	
+	/****CRC verify check*****/
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
+		/******* anything else than extended request falls back to legacy frames *****/
+		BL_Frame_Mode = (BL_FRAME_MODE_EXTENDED == Host_buffer[2U]) ? BL_FRAME_MODE_EXTENDED : BL_FRAME_MODE_LEGACY;
+		BL_Transport_VidSetExtendedFrames(BL_Frame_Mode);
+		if(BL_FRAME_MODE_LEGACY == BL_Frame_Mode){
+			max_frame_len = 0xFFU + BL_TRANSPORT_FRAME_HEADER_LEN;
+		}
+		/******* host link may buffer less than host buffer *****/
+		if(max_frame_len > BL_HOST_LINK->MaxFrameSize()){
+			max_frame_len = BL_HOST_LINK->MaxFrameSize();
+		}
+		frame_mode_reply[0U] = BL_Frame_Mode;
+		frame_mode_reply[1U] = (uint8)(max_frame_len & 0xFFU);
+		frame_mode_reply[2U] = (uint8)(max_frame_len >> 8U);
+		BL_VidSendAck(BL_FRAME_MODE_REPLY_LEN);
+		BL_VidSendReplyTo_Host(frame_mode_reply , BL_FRAME_MODE_REPLY_LEN);
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Frame mode %d , max. frame %d bytes \r\n",BL_Frame_Mode,max_frame_len);
+#endif
+	}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("CRC Verification Failed \r\n");
+#endif
+		BL_VidSendNack();
+	}
+}
+
+/*****BL_VidBatch 
+**@description frame -> header | cmd | op count | ops | crc32 , legacy or extended frame
+	reply -> one BL_BATCH_STATUS_xx per op
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidBatch(uint8 *Host_buffer)
+{
+	uint16 Op_offset = 0U;
+	uint8 Op_count = 0U;
+	uint8 Op_index = 0U;
+	uint32 Jump_address = 0U;
+	uint8 Batch_status[BL_BATCH_MAX_OPS];
+	
+	Op_count = BL_Host_Frame->Info[0U];
+	
+	/****CRC verify check*****/
+	if((0U == Op_count) || (Op_count > BL_BATCH_MAX_OPS) ||
+		(CRC_VERFIY_SUCCESS != BL_uint8FrameCrcVerify(BL_Host_Frame))){
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Batch frame rejected \r\n");
+#endif
+		BL_VidSendNack();
+		return;
+	}
+	memset(Batch_status , BL_BATCH_STATUS_SKIPPED , Op_count);
+	Op_offset = BL_Host_Frame->Header_Len + 2U;
+	for(Op_index = 0U ; Op_index < Op_count ; Op_index++)
+	{
+		Batch_status[Op_index] = BL_uint8BatchOp(Host_buffer , &Op_offset , BL_Host_Frame->Len - CRC_SIZE_BYTE , &Jump_address);
+		/****** go leaves the bootloader , nothing may follow it ****/
+		if((0U != Jump_address) && (Op_index != (Op_count - 1U))){
+			Batch_status[Op_index] = BL_BATCH_STATUS_INVALID;
+			Jump_address = 0U;
+		}
+		if(BL_BATCH_STATUS_PASS != Batch_status[Op_index]){
+			break;
+		}
+	}
+	/****** one log line per batch , logging each op would cost more than the op itself ****/
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+	Bl_Print_Msg("Batch of %d ops , %d passed \r\n",Op_count,Op_index);
+#endif
+	BL_VidSendAck(Op_count);
+	BL_VidSendReplyTo_Host(Batch_status , Op_count);
+	if(0U != Jump_address){
+		Ptr_JumpAdd jump_add = (Ptr_JumpAdd)(Jump_address+1U);  // T bit
+		/*****status vector must leave before the link is stopped******/
+		(void)BL_FLASH_uint8End();
+		BL_FLASH_VidDeInit();
+		BL_HOST_LINK->DeInit();
+		jump_add();
+	}
+}
+
+/*****BL_uint8BatchOp 
+**@param[in] Host_buffer pointer to frame
+**@param[in] op_offset offset of op code , advanced behind the op arguments
+**@param[in] op_end offset of frame crc
+**@param[out] jump_address address of a go op (untouched for other ops)
+**@return BL_BATCH_STATUS_xx
+**/
+static uint8 BL_uint8BatchOp(uint8 *Host_buffer , uint16 *op_offset , uint16 op_end , uint32 *jump_address)
+{
+	uint8 op_status = BL_BATCH_STATUS_INVALID;
+	uint16 offset = *op_offset;
+	uint32 op_address = 0U;
+	uint32 op_len = 0U;
+	
+	if(offset >= op_end){
+		return BL_BATCH_STATUS_INVALID;
+	}
+	switch(Host_buffer[offset])
+	{
+		case BL_BATCH_OP_ERASE:
+		if((offset + 3U) <= op_end){
+			op_status = (FLASH_SUCCESS_ERASE == Perform_uint8FlashErase(Host_buffer[offset + 1U] , Host_buffer[offset + 2U])) ?
+									BL_BATCH_STATUS_PASS : BL_BATCH_STATUS_FAIL;
+			offset += 3U;
+		}
+			break;
+		case BL_BATCH_OP_WRITE:
+		if((offset + 7U) <= op_end){
+			op_address = BL_Transport_uint32GetLE(&Host_buffer[offset + 1U]);
+			op_len = (uint32)Host_buffer[offset + 5U] | ((uint32)Host_buffer[offset + 6U] << 8U);
+			if(((offset + 7U + op_len) <= op_end) && (op_len > 0U) &&
+				(ADDRESS_IS_VALID == Host_uint8AddressVerification(op_address)) &&
+				(ADDRESS_IS_VALID == Host_uint8AddressVerification(op_address + op_len - 1U))){
+				op_status = (FLASH_WRITE_STATUS_PASS == BL_uint8WritePayload(&Host_buffer[offset + 7U] , op_address , (uint16)op_len)) ?
+										BL_BATCH_STATUS_PASS : BL_BATCH_STATUS_FAIL;
+				offset = (uint16)(offset + 7U + op_len);
+			}
+		}
+			break;
+		case BL_BATCH_OP_CHECK_SUM:
+		if((offset + 13U) <= op_end){
+			op_address = BL_Transport_uint32GetLE(&Host_buffer[offset + 1U]);
+			op_len = BL_Transport_uint32GetLE(&Host_buffer[offset + 5U]);
+			/****** length limit keeps both ends in the same memory ****/
+			if((op_len > 0U) && (op_len <= (STM32F756_FLASH_SIZE + 1U)) && (ADDRESS_IS_VALID == Host_uint8AddressVerification(op_address)) &&
+				(ADDRESS_IS_VALID == Host_uint8AddressVerification(op_address + op_len - 1U))){
+				op_status = (BL_Transport_uint32GetLE(&Host_buffer[offset + 9U]) == BL_uint32MemoryCrc(op_address , op_len)) ?
+										BL_BATCH_STATUS_PASS : BL_BATCH_STATUS_FAIL;
+				offset += 13U;
+			}
+		}
+			break;
+		case BL_BATCH_OP_GO:
+		if((offset + 5U) <= op_end){
+			op_address = BL_Transport_uint32GetLE(&Host_buffer[offset + 1U]);
+			if(ADDRESS_IS_VALID == Host_uint8AddressVerification(op_address)){
+				*jump_address = op_address;
+				op_status = BL_BATCH_STATUS_PASS;
+				offset += 5U;
+			}
+		}
+			break;
+		default:
+		op_status = BL_BATCH_STATUS_INVALID;
+			break;
+	}
+	*op_offset = offset;
+	return op_status;
+}
+
+/*****BL_VidSetCrcMode 
+**@description frame -> len | cmd | mode | crc32 (checked with the mode in use)
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidSetCrcMode(uint8 *Host_buffer)
+{
+	uint8 crc_mode = BL_CRC_uint8GetMode();
+	uint8 crc_status = BL_uint8FrameCrcVerify(BL_Host_Frame);
+	
+	/****CRC verify check , then in the other convention*****/
+	if(CRC_VERFIY_SUCCESS != crc_status){
+		BL_CRC_VidSetMode((BL_CRC_MODE_STANDARD == crc_mode) ? BL_CRC_MODE_LEGACY : BL_CRC_MODE_STANDARD);
+		crc_status = BL_uint8CRC_Verify(BL_Host_Frame->Buffer , (uint32)BL_Host_Frame->Len - CRC_SIZE_BYTE , BL_Host_Frame->Host_Crc);
+		BL_CRC_VidSetMode(crc_mode);
+	}
+	if(CRC_VERFIY_SUCCESS == crc_status){
+		/******* unknown modes fall back to the legacy convention *****/
+		BL_CRC_VidSetMode(Host_buffer[2U]);
+		crc_mode = BL_CRC_uint8GetMode();
+		/******* digest so far is in the old convention *****/
+		BL_VidSessionStart();
+		BL_VidSendAck(BL_CRC_MODE_REPLY_LEN);
+		BL_VidSendReplyTo_Host(&crc_mode , BL_CRC_MODE_REPLY_LEN);
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Crc mode %d \r\n",crc_mode);
+#endif
+	}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("CRC Verification Failed \r\n");
+#endif
+		BL_VidSendNack();
+	}
+}
+
+/*****BL_VidSetWriteMode 
+**@description frame -> len | cmd | mode | nonce | crc32 , reply -> accepted mode
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidSetWriteMode(uint8 *Host_buffer)
+{
+	/****CRC verify check (nonce must be complete)*****/
+	if((BL_Host_Frame->Len == (3U + BL_AES_NONCE_LEN + CRC_SIZE_BYTE)) &&
+		(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame))){
+		/******* unknown modes fall back to plain payloads *****/
+		BL_Write_Mode = (BL_WRITE_MODE_AES_CTR == Host_buffer[2U]) ? BL_WRITE_MODE_AES_CTR : BL_WRITE_MODE_PLAIN;
+		if(BL_WRITE_MODE_AES_CTR == BL_Write_Mode){
+			BL_AES_VidSetNonce(&Host_buffer[3U]);
+		}
+		BL_VidSendAck(BL_WRITE_MODE_REPLY_LEN);
+		BL_VidSendReplyTo_Host(&BL_Write_Mode , BL_WRITE_MODE_REPLY_LEN);
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Write mode %d \r\n",BL_Write_Mode);
+#endif
+	}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("CRC Verification Failed \r\n");
+#endif
+		BL_VidSendNack();
+	}
+}
+
+/*****BL_VidImageManifest 
+**@description frame -> header | cmd | part | data | crc32 , reply -> BL_MANIFEST_xx
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidImageManifest(uint8 *Host_buffer)
+{
+	const uint8 *Host_info = BL_Host_Frame->Info;
+	uint8 manifest_part = 0U;
+	uint16 first_leaf = 0U;
+	uint32 leaf_count = 0U;
+	uint8 manifest_root[BL_HASH_SHA256_LEN];
+	uint32 root_cycles = 0U;
+	uint8 manifest_status = BL_MANIFEST_REJECTED;
+	
+	/****CRC verify check*****/
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
+		manifest_part = Host_info[0U];
+		/****** HASH DMA borrows the host link TX stream , last reply must be out ****/
+		BL_HOST_LINK->Flush(BL_TRANSPORT_FLUSH_WAIT);
+		if((BL_MANIFEST_PART_HEADER == manifest_part) &&
+			(BL_Host_Frame->Info_Len == (1U + BL_MERKLE_HEADER_LEN))){
+			/****** new manifest , previous one dropped ****/
+			BL_Merkle_State = BL_MERKLE_STATE_IDLE;
+			memcpy(&BL_Merkle_Header , &Host_info[1U] , BL_MERKLE_HEADER_LEN);
+			if((BL_IMAGE_MAGIC_MERKLE == BL_Merkle_Header.Magic) && (BL_IMAGE_VALID == BL_uint8ImageHeaderCheck(&BL_Merkle_Header))){
+				BL_Merkle_Leaf_Count = (BL_Merkle_Header.Length + BL_Merkle_Header.Chunk_Size - 1U) / BL_Merkle_Header.Chunk_Size;
+				BL_Merkle_Leaves_Loaded = 0U;
+				BL_Merkle_State = BL_MERKLE_STATE_LOADING;
+				manifest_status = BL_MANIFEST_PENDING;
+			}
+		}else if((BL_MANIFEST_PART_LEAVES == manifest_part) && (BL_MERKLE_STATE_LOADING == BL_Merkle_State)){
+			first_leaf = (uint16)(Host_info[1U] | ((uint16)Host_info[2U] << 8U));
+			leaf_count = ((uint32)BL_Host_Frame->Info_Len - 3U) / BL_HASH_SHA256_LEN;
+			/****** leaves in order , whole hashes only ****/
+			if((first_leaf == BL_Merkle_Leaves_Loaded) && ((BL_Merkle_Leaves_Loaded + leaf_count) <= BL_Merkle_Leaf_Count) &&
+				(BL_Host_Frame->Info_Len == (3U + (leaf_count * BL_HASH_SHA256_LEN)))){
+				memcpy(BL_Merkle_Leaves[first_leaf] , &Host_info[3U] , leaf_count * BL_HASH_SHA256_LEN);
+				BL_Merkle_Leaves_Loaded += leaf_count;
+				manifest_status = BL_MANIFEST_PENDING;
+				if(BL_Merkle_Leaves_Loaded == BL_Merkle_Leaf_Count){
+					if((BL_HASH_OK == BL_uint8MerkleRoot(&BL_Merkle_Header , (const uint8 *)BL_Merkle_Leaves , manifest_root , &root_cycles)) &&
+						(0 == memcmp(manifest_root , BL_Merkle_Header.Sha256 , BL_HASH_SHA256_LEN))){
+						memset(BL_Merkle_Done , 0 , sizeof(BL_Merkle_Done));
+						BL_Merkle_Done_Count = 0U;
+						BL_Merkle_State = BL_MERKLE_STATE_ACTIVE;
+						manifest_status = BL_MANIFEST_ACTIVE;
+					}else{
+						manifest_status = BL_MANIFEST_REJECTED;
+					}
+				}
+			}
+			if(BL_MANIFEST_REJECTED == manifest_status){
+				BL_Merkle_State = BL_MERKLE_STATE_IDLE;
+			}
+		}else{
+			BL_Merkle_State = BL_MERKLE_STATE_IDLE;
+		}
+		BL_VidSendAck(BL_MANIFEST_REPLY_LEN);
+		BL_VidSendReplyTo_Host(&manifest_status , BL_MANIFEST_REPLY_LEN);
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Manifest part %d , status %d \r\n",manifest_part,manifest_status);
+#endif
+	}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("CRC Verification Failed \r\n");
+#endif
+		BL_VidSendNack();
+	}
+}
+
+/*****BL_uint8MerkleHeaderCheck 
+**@param[in] image_header MERKLE header
+**@return BL_IMAGE_VALID if chunking is supported and the MAC matches
+**/
+static uint8 BL_uint8MerkleHeaderCheck(const Bl_Image_Header *image_header)
+{
+	uint8 header_mac[BL_HASH_SHA256_LEN];
+	uint8 header_status = BL_IMAGE_INVALID;
+	
+	/****** word aligned chunks (HASH DMA) that fit a frame , leaves that fit the table ****/
+	if((0U == (image_header->Chunk_Size & 3U)) && (image_header->Chunk_Size >= BL_MERKLE_MIN_CHUNK) &&
+		(image_header->Chunk_Size <= BL_HOST_MAX_PAYLOAD_LENGTH) &&
+		(((image_header->Length + image_header->Chunk_Size - 1U) / image_header->Chunk_Size) <= BL_MERKLE_MAX_LEAVES)){
+		if((BL_HASH_OK == BL_HASH_uint8HmacSha256(BL_Merkle_Mac_Key , (const uint8 *)image_header , BL_MERKLE_MAC_DATA_LEN , header_mac)) &&
+			(0 == memcmp(header_mac , image_header->Mac , BL_HASH_SHA256_LEN))){
+			header_status = BL_IMAGE_VALID;
+		}
+	}
+	return header_status;
+}
+
+/*****BL_uint8MerkleRoot 
+**@param[in] image_header MERKLE header
+**@param[in] leaves leaf hashes or NULL
+**@param[out] root BL_HASH_SHA256_LEN bytes
+**@param[out] cycles HASH cycles spent
+**@return BL_HASH_OK or BL_HASH_FAILED (root is then not valid)
+**/
+static uint8 BL_uint8MerkleRoot(const Bl_Image_Header *image_header , const uint8 *leaves , uint8 *root , uint32 *cycles)
+{
+	uint8 *pair = (uint8 *)BL_Merkle_Pair;
+	uint32 leaf_count = (image_header->Length + image_header->Chunk_Size - 1U) / image_header->Chunk_Size;
+	uint32 leaf_index = 0U;
+	uint32 chunk_offset = 0U;
+	uint8 depth = 0U;
+	uint8 hash_status = BL_HASH_OK;
+	
+	*cycles = 0U;
+	/****** one pending node per level : equal levels merge , so only log2 nodes are kept ****/
+	for(leaf_index = 0U ; (leaf_index < leaf_count) && (BL_HASH_OK == hash_status) ; leaf_index++)
+	{
+		if(NULL != leaves){
+			memcpy(BL_Merkle_Stack[depth] , &leaves[leaf_index * BL_HASH_SHA256_LEN] , BL_HASH_SHA256_LEN);
+		}else{
+			chunk_offset = leaf_index * image_header->Chunk_Size;
+			hash_status = BL_HASH_uint8Sha256((const uint8 *)(image_header->Address + chunk_offset) ,
+				((image_header->Length - chunk_offset) < image_header->Chunk_Size) ? (image_header->Length - chunk_offset) : image_header->Chunk_Size ,
+				BL_Merkle_Stack[depth]);
+			*cycles += BL_HASH_uint32LastCycles();
+		}
+		BL_Merkle_Stack_Level[depth] = 0U;
+		depth++;
+		while((depth >= 2U) && (BL_Merkle_Stack_Level[depth - 2U] == BL_Merkle_Stack_Level[depth - 1U]) && (BL_HASH_OK == hash_status))
+		{
+			memcpy(pair , BL_Merkle_Stack[depth - 2U] , BL_HASH_SHA256_LEN);
+			memcpy(&pair[BL_HASH_SHA256_LEN] , BL_Merkle_Stack[depth - 1U] , BL_HASH_SHA256_LEN);
+			hash_status = BL_HASH_uint8Sha256(pair , 2U * BL_HASH_SHA256_LEN , BL_Merkle_Stack[depth - 2U]);
+			*cycles += BL_HASH_uint32LastCycles();
+			BL_Merkle_Stack_Level[depth - 2U]++;
+			depth--;
+		}
+	}
+	/****** odd nodes moved up , joined from the right ****/
+	while((depth >= 2U) && (BL_HASH_OK == hash_status))
+	{
+		memcpy(pair , BL_Merkle_Stack[depth - 2U] , BL_HASH_SHA256_LEN);
+		memcpy(&pair[BL_HASH_SHA256_LEN] , BL_Merkle_Stack[depth - 1U] , BL_HASH_SHA256_LEN);
+		hash_status = BL_HASH_uint8Sha256(pair , 2U * BL_HASH_SHA256_LEN , BL_Merkle_Stack[depth - 2U]);
+		*cycles += BL_HASH_uint32LastCycles();
+		depth--;
+	}
+	memcpy(root , BL_Merkle_Stack[0U] , BL_HASH_SHA256_LEN);
+	return hash_status;
+}
+
+/*****BL_uint8MerkleChunk 
+**@param[in] data payload to be written (word aligned)
+**@param[in] address destination address
+**@param[in] len payload length
+**@param[out] chunk_index chunk number (BL_MERKLE_CHUNK_VALID only)
+**@return BL_MERKLE_CHUNK_xx
+**/
+static uint8 BL_uint8MerkleChunk(const uint8 *data , uint32 address , uint16 len , uint32 *chunk_index)
+{
+	uint32 image_start = BL_Merkle_Header.Address;
+	uint32 image_end = BL_Merkle_Header.Address + BL_Merkle_Header.Length;
+	uint32 chunk_offset = address - image_start;
+	uint32 chunk_len = 0U;
+	uint8 chunk_digest[BL_HASH_SHA256_LEN];
+	uint8 chunk_status = BL_MERKLE_CHUNK_INVALID;
+	
+	if(((address + len) <= image_start) || (address >= image_end)){
+		chunk_status = BL_MERKLE_CHUNK_OUTSIDE;
+	}else if((address >= image_start) && (0U == (chunk_offset % BL_Merkle_Header.Chunk_Size))){
+		*chunk_index = chunk_offset / BL_Merkle_Header.Chunk_Size;
+		chunk_len = image_end - address;
+		if(chunk_len > BL_Merkle_Header.Chunk_Size){
+			chunk_len = BL_Merkle_Header.Chunk_Size;
+		}
+		if(len == chunk_len){
+			/****** HASH DMA borrows the host link TX stream , last reply must be out ****/
+			BL_HOST_LINK->Flush(BL_TRANSPORT_FLUSH_WAIT);
+			if((BL_HASH_OK == BL_HASH_uint8Sha256(data , len , chunk_digest)) &&
+				(0 == memcmp(chunk_digest , BL_Merkle_Leaves[*chunk_index] , BL_HASH_SHA256_LEN))){
+				chunk_status = BL_MERKLE_CHUNK_VALID;
+			}
+		}
+	}else{
+		/****** not on a chunk boundary ****/
+	}
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+	if(BL_MERKLE_CHUNK_INVALID == chunk_status){
+		Bl_Print_Msg("Chunk at 0x%X rejected \r\n",address);
+	}
+#endif
+	return chunk_status;
+}
+
+/*****BL_VidMerkleChunkDone 
+**@param[in] chunk_index chunk number
+**/
+static void BL_VidMerkleChunkDone(uint32 chunk_index)
+{
+	const uint32 *header_words = (const uint32 *)BL_IMAGE_HEADER_ADDRESS;
+	uint8 header_erased = 1U;
+	uint8 word_count = 0U;
+	
+	if(0U == (BL_Merkle_Done[chunk_index >> 5U] & (1UL << (chunk_index & 31U)))){
+		BL_Merkle_Done[chunk_index >> 5U] |= (1UL << (chunk_index & 31U));
+		BL_Merkle_Done_Count++;
+	}
+	if(BL_Merkle_Done_Count == BL_Merkle_Leaf_Count){
+		BL_Merkle_State = BL_MERKLE_STATE_IDLE;
+		for(word_count = 0U ; word_count < (BL_MERKLE_HEADER_LEN / 4U) ; word_count++)
+		{
+			if(0xFFFFFFFFU != header_words[word_count]){
+				header_erased = 0U;
+			}
+		}
+		if(0U == header_erased){
+			/****** host did not erase the header sector , slow path ****/
+			(void)Perform_uint8FlashErase(BL_IMAGE_HEADER_SECTOR , 1U);
+		}
+		/****** every chunk matched its leaf : header and verified record , next boot needs no hashing ****/
+		if(FLASH_WRITE_STATUS_PASS == BL_uint8FlashProgramWords(BL_IMAGE_HEADER_ADDRESS , (const uint32 *)&BL_Merkle_Header , BL_MERKLE_HEADER_LEN / 4U)){
+			BL_VidBootCacheAppend(BL_BOOT_RECORD_VERIFIED , BL_Merkle_Header.Sha256);
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+			Bl_Print_Msg("All %d chunks verified , header stored \r\n",BL_Merkle_Leaf_Count);
+#endif
+		}
+	}
+}
+
+/*****BL_VidImageVerify 
+**@description frame -> len | cmd | crc32 , reply -> BL_IMAGE_xx | cycles (4 , LE)
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidImageVerify(uint8 *Host_buffer)
+{
+	uint32 verify_cycles = 0U;
+	uint8 verify_reply[BL_IMAGE_VERIFY_REPLY_LEN] = {0U};
+	
+	/****CRC verify check*****/
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
+		/****** HASH DMA borrows the host link TX stream , last reply must be out ****/
+		BL_HOST_LINK->Flush(BL_TRANSPORT_FLUSH_WAIT);
+		verify_reply[0U] = BL_uint8ImageVerify(&verify_cycles);
+		memcpy(&verify_reply[1U] , &verify_cycles , sizeof(verify_cycles));
+		BL_VidSendAck(BL_IMAGE_VERIFY_REPLY_LEN);
+		BL_VidSendReplyTo_Host(verify_reply , BL_IMAGE_VERIFY_REPLY_LEN);
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Image status %d , %u cycles \r\n",verify_reply[0U],verify_cycles);
+#endif
+	}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("CRC Verification Failed \r\n");
+#endif
+		BL_VidSendNack();
+	}
+}
+
+/*****BL_uint8ImageVerify 
+**@param[out] cycles cycles of the digest (0 when the header is invalid)
+**@return BL_IMAGE_VALID if header is sane and the image matches its digest
+**/
+static uint8 BL_uint8ImageVerify(uint32 *cycles)
+{
+	const Bl_Image_Header *image_header = (const Bl_Image_Header *)BL_IMAGE_HEADER_ADDRESS;
+	uint8 image_digest[BL_HASH_SHA256_LEN] = {0U};
+	uint8 image_status = BL_IMAGE_INVALID;
+	uint8 hash_status = BL_HASH_FAILED;
+	
+	*cycles = 0U;
+	if(BL_IMAGE_VALID == BL_uint8ImageHeaderCheck(image_header)){
+		if(BL_IMAGE_MAGIC_MERKLE == image_header->Magic){
+			/****** every chunk hashed again , root compared as digest ****/
+			hash_status = BL_uint8MerkleRoot(image_header , NULL , image_digest , cycles);
+		}else{
+			hash_status = BL_HASH_uint8Sha256((const uint8 *)image_header->Address , image_header->Length , image_digest);
+			*cycles = BL_HASH_uint32LastCycles();
+		}
+		/****** a digest that could not be calculated counts as a mismatch ****/
+		if((BL_HASH_OK == hash_status) && (0 == memcmp(image_digest , image_header->Sha256 , BL_HASH_SHA256_LEN))){
+			image_status = BL_IMAGE_VALID;
+			/****** next boots trust this header until flash is written again ****/
+			if(BL_IMAGE_VALID != BL_uint8BootCacheHit()){
+				BL_VidBootCacheAppend(BL_BOOT_RECORD_VERIFIED , image_header->Sha256);
+			}
+		}
+	}
+	return image_status;
+}
+
+/*****BL_uint8ImageHeaderCheck 
+**@param[in] image_header header in flash
+**@return BL_IMAGE_VALID if the header describes an image inside the application area (MERKLE only while
+          BL_IMAGE_AUTH is enforced)
+**/
+static uint8 BL_uint8ImageHeaderCheck(const Bl_Image_Header *image_header)
+{
+	uint8 header_status = BL_IMAGE_INVALID;
+	
+	if((FLASH_SECTOR1_BASE_ADDRESS == image_header->Address) &&
+		(image_header->Length > 0U) && (image_header->Length <= (BL_IMAGE_HEADER_ADDRESS - FLASH_SECTOR1_BASE_ADDRESS))){
+		if(BL_IMAGE_MAGIC == image_header->Magic){
+			/****** digest only , anyone can write it ****/
+			header_status = (BL_IMAGE_AUTH_ENABLE == BL_IMAGE_AUTH) ? BL_IMAGE_INVALID : BL_IMAGE_VALID;
+		}else if(BL_IMAGE_MAGIC_MERKLE == image_header->Magic){
+			/****** constant cost : one MAC over the header fields ****/
+			header_status = BL_uint8MerkleHeaderCheck(image_header);
+		}else{
+			/****** no image ****/
+		}
+	}
+	return header_status;
+}
+
+/*****BL_uint32BootCacheScan 
+**@param[out] write_count number of WRITE records
+**@param[out] last_record address of last record (0 for an empty log)
+**@return address of first free record (BL_BOOT_CACHE_END when full)
+**/
+static uint32 BL_uint32BootCacheScan(uint32 *write_count , uint32 *last_record)
+{
+	uint32 record_address = BL_BOOT_CACHE_ADDRESS;
+	const Bl_Boot_Record *boot_record = NULL;
+	
+	*write_count = 0U;
+	*last_record = 0U;
+	while((record_address + BL_BOOT_RECORD_LEN) <= BL_BOOT_CACHE_END)
+	{
+		boot_record = (const Bl_Boot_Record *)record_address;
+		if(BL_BOOT_RECORD_ERASED == boot_record->Type){
+			break;
+		}
+		if(BL_BOOT_RECORD_WRITE == boot_record->Type){
+			(*write_count)++;
+		}
+		*last_record = record_address;
+		record_address += BL_BOOT_RECORD_LEN;
+	}
+	if((record_address + BL_BOOT_RECORD_LEN) > BL_BOOT_CACHE_END){
+		record_address = BL_BOOT_CACHE_END;
+	}
+	return record_address;
+}
+
+/*****BL_uint8BootCacheHit 
+**@return BL_IMAGE_VALID if the last record marks the current header as verified and nothing was written since
+**/
+static uint8 BL_uint8BootCacheHit(void)
+{
+	const Bl_Image_Header *image_header = (const Bl_Image_Header *)BL_IMAGE_HEADER_ADDRESS;
+	const Bl_Boot_Record *boot_record = NULL;
+	uint32 write_count = 0U;
+	uint32 last_record = 0U;
+	uint8 cache_status = BL_IMAGE_INVALID;
+	
+	(void)BL_uint32BootCacheScan(&write_count , &last_record);
+	if((0U != last_record) && (BL_IMAGE_VALID == BL_uint8ImageHeaderCheck(image_header))){
+		boot_record = (const Bl_Boot_Record *)last_record;
+		if((BL_BOOT_RECORD_VERIFIED == boot_record->Type) && (write_count == boot_record->Write_Count) &&
+			(0 == memcmp(boot_record->Sha256 , image_header->Sha256 , BL_HASH_SHA256_LEN))){
+			cache_status = BL_IMAGE_VALID;
+		}
+	}
+	return cache_status;
+}
+
+/*****BL_VidBootCacheAppend 
+**@param[in] record_type BL_BOOT_RECORD_WRITE or BL_BOOT_RECORD_VERIFIED
+**@param[in] sha256 header digest (VERIFIED) or NULL
+**/
+static void BL_VidBootCacheAppend(uint32 record_type , const uint8 *sha256)
+{
+	uint32 record_words[BL_BOOT_RECORD_LEN / 4U];
+	uint32 record_address = 0U;
+	uint32 write_count = 0U;
+	uint32 last_record = 0U;
+	
+	memset(record_words , 0xFF , sizeof(record_words));
+	record_words[0U] = record_type;
+	record_address = BL_uint32BootCacheScan(&write_count , &last_record);
+	record_words[1U] = write_count;
+	if(NULL != sha256){
+		memcpy(&record_words[2U] , sha256 , BL_HASH_SHA256_LEN);
+	}
+	if(BL_BOOT_CACHE_END != record_address){
+		/****** type first : a torn record never matches the header ****/
+		(void)BL_uint8FlashProgramWords(record_address , record_words , BL_BOOT_RECORD_LEN / 4U);
+	}else if(BL_BOOT_RECORD_WRITE == record_type){
+		/****** log full : revoke the last record , hashing on every boot until sector 7 is erased ****/
+		record_words[0U] = BL_BOOT_RECORD_REVOKED;
+		(void)BL_uint8FlashProgramWords(last_record , record_words , 1U);
+	}else{
+		/****** log full : verified state can not be recorded ****/
+	}
+	if(BL_BOOT_RECORD_VERIFIED == record_type){
+		/****** next write starts a new write count ****/
+		BL_Boot_Write_Logged = 0U;
+	}
+}
+
+/*****BL_uint8FlashProgramWords 
+**@param[in] address destination (word aligned)
+**@param[in] words data
+**@param[in] count number of words
+**@return FLASH_WRITE_STATUS_PASS or FLASH_WRITE_STATUS_FAIL
+**/
+static uint8 BL_uint8FlashProgramWords(uint32 address , const uint32 *words , uint32 count)
+{
+	uint8 program_status = FLASH_WRITE_STATUS_FAIL;
+	
+	if(HAL_OK == BL_FLASH_uint8Begin()){
+		program_status = FLASH_WRITE_STATUS_PASS;
+		if(HAL_OK != BL_FLASH_uint8ProgramBuffer(address , (const uint8 *)words , count << 2U)){
+			program_status = FLASH_WRITE_STATUS_FAIL;
+		}
+		/****** closes a write stream too , the next payload opens it again ****/
+		(void)BL_FLASH_uint8End();
+	}
+	return program_status;
+}
+
+/*****BL_VidBootCacheInvalidate 
+**@description called before any flash write or erase , logs it once per power cycle
+**/
+static void BL_VidBootCacheInvalidate(void)
+{
+	if(0U == BL_Boot_Write_Logged){
+		BL_VidBootCacheAppend(BL_BOOT_RECORD_WRITE , NULL);
+		BL_Boot_Write_Logged = 1U;
+	}
+}
+
+/*****BL_VidFlashBusy 
+**@description linked into ITCM with the receive path it calls (see the scatter file)
+**/
+static void BL_VidFlashBusy(void)
+{
+	/****** one frame ahead at most , the spare buffer holds it until the next fetch ****/
+	if(BL_TRANSPORT_FRAME_NOT_READY == BL_Host_Prefetch_Status){
+		BL_Host_Prefetched = 1U;
+		BL_Host_Prefetch_Status = BL_HOST_LINK->Receive(BL_Host_Bufs[BL_Host_Buf_Index ^ 1U] , BL_HOST_BUFFER_RX_LENGTH);
+	}
+	BL_HOST_LINK->Poll();
+}
+
+/*****BL_VidBootOnTimeout 
+**@description no host frame since entry : starts the application if its image is valid
+**/
+static void BL_VidBootOnTimeout(void)
+{
+	uint32 verify_cycles = 0U;
+	
+	BL_Boot_State = BL_BOOT_STATE_DONE;
+	/****** verified before and nothing written since : header check only ****/
+	if(BL_IMAGE_VALID == BL_uint8BootCacheHit()){
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Image verified on an earlier boot , starting application \r\n");
+#endif
+		BL_Jump_To_App();
+	}else if(BL_IMAGE_VALID == BL_uint8ImageVerify(&verify_cycles)){
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Image verified in %u cycles , starting application \r\n",verify_cycles);
+#endif
+		BL_Jump_To_App();
+	}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("No valid image (%u cycles) , waiting for host \r\n",verify_cycles);
+#endif
+	}
+}
+
+/*****BL_VidSessionDigest 
+**@description frame -> len | cmd | crc32
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidSessionDigest(uint8 *Host_buffer)
+{
+	uint32 session_reply[3U] = {0U};
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+	uint8 program_path = 0U;
+	uint8 program_type = 0U;
+#endif
+	
+	/****CRC verify check*****/
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
+		/****** end of write session , flash locked again ****/
+		(void)BL_FLASH_uint8End();
+		session_reply[0U] = BL_Session_Bytes;
+		session_reply[1U] = BL_Session_Digest;
+		session_reply[2U] = BL_Session_Programmed;
+		BL_VidSessionStart();
+		BL_VidSendAck(BL_SESSION_DIGEST_REPLY_LEN);
+		BL_VidSendReplyTo_Host((uint8 *)session_reply , BL_SESSION_DIGEST_REPLY_LEN);
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Session of %d bytes , digest 0x%X , %d bytes programmed , %d already in flash \r\n",
+			session_reply[0U],session_reply[1U],session_reply[2U],BL_FLASH_uint32Skipped());
+		for(program_path = BL_FLASH_PATH_HAL ; program_path < BL_FLASH_PATHS ; program_path++)
+		{
+			for(program_type = FLASH_TYPEPROGRAM_BYTE ; program_type < BL_FLASH_PROGRAM_TYPES ; program_type++)
+			{
+				if(0U != BL_FLASH_uint32Bytes(program_path , program_type)){
+					Bl_Print_Msg("  %s %d byte program : %u bytes , %u bytes/s , %u cycles per unit \r\n",
+						(BL_FLASH_PATH_STREAM == program_path) ? "stream" : "HAL",1U << program_type,
+						BL_FLASH_uint32Bytes(program_path , program_type),BL_FLASH_uint32BytesPerSecond(program_path , program_type),
+						BL_FLASH_uint32UnitCycles(program_path , program_type));
+				}
+			}
+		}
+#endif
+		/****** program throughput is measured per session too ****/
+		BL_FLASH_VidStatsReset();
+	}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("CRC Verification Failed \r\n");
+#endif
+		BL_VidSendNack();
+	}
+}
+
+/*****BL_VidSessionStart 
+**@description clears the write session (digest of no data in the CRC mode in use)
+**/
+static void BL_VidSessionStart(void)
+{
+	BL_CRC_VidStart();
+	BL_Session_Digest = BL_CRC_uint32Finish();
+	BL_Session_Bytes = 0U;
+	BL_Session_Programmed = 0U;
+	/****** sectors are erased again by the next session's writes ****/
+	BL_Erased_Sectors = 0U;
+	BL_Written_Sectors = 0U;
+}
+
+/*****BL_VidSessionUpdate 
+**@param[in] address destination of payload
+**@param[in] len payload length
+**/
+static void BL_VidSessionUpdate(uint32 address , uint16 len)
+{
+	BL_CRC_VidResume(BL_Session_Digest);
+	BL_CRC_VidAccumulate((const uint8 *)address , len);
+	BL_Session_Digest = BL_CRC_uint32Finish();
+	BL_Session_Bytes += len;
+}
+
+/*****BL_VidChangeBaudRate 
+**@description frame -> len | cmd | baud rate (4 , LE) | crc32
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidChangeBaudRate(uint8 *Host_buffer)
+{
+	uint32 Host_baud_rate = 0U;
+	uint8 baud_status = BAUD_CHANGE_REJECTED;
+#if BL_HOST_TRANSPORT == BL_TRANSPORT_UART
+	uint32 old_baud_rate = 0U;
+	uint8 frame_status = BL_TRANSPORT_FRAME_NOT_READY;
+#endif
+	
+	/*****Log message***/	
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+	Bl_Print_Msg("Change Baud Rate Command Received \r\n");
+#endif
+	/****CRC verify check*****/
+	if(CRC_VERFIY_SUCCESS != BL_uint8FrameCrcVerify(BL_Host_Frame)){
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("CRC Verification Failed \r\n");
+#endif
+		BL_VidSendNack();
+		return;
+	}
+	Host_baud_rate = BL_Host_Frame->Address;
+#if BL_HOST_TRANSPORT == BL_TRANSPORT_UART
+	old_baud_rate = BL_UART_uint32GetBaudRate();
+	baud_status = BL_UART_uint8CheckBaudRate(Host_baud_rate) ? BAUD_CHANGE_ACCEPTED : BAUD_CHANGE_REJECTED;
+#else
+	/******** host link has no baud rate *****/
+	baud_status = BAUD_CHANGE_REJECTED;
+#endif
+	
+	/******** reply at old rate , blocking transmit returns after last stop bit *****/
+	BL_VidSendAck(1U);
+	BL_VidSendReplyTo_Host((uint8*)&baud_status,1U);
+	if(BAUD_CHANGE_ACCEPTED != baud_status){
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Baud Rate %d Rejected \r\n",Host_baud_rate);
+#endif
+		return;
+	}
+#if BL_HOST_TRANSPORT == BL_TRANSPORT_UART
+	(void)BL_UART_uint8SetBaudRate(Host_baud_rate);
+	
+	/******** host has to repeat the same frame at new rate *****/
+	frame_status = BL_Transport_uint8ReceiveTimeout(BL_HOST_LINK , Host_buffer , BL_HOST_BUFFER_RX_LENGTH , BL_BAUD_CONFIRM_TIMEOUT_MS);
+	baud_status = BAUD_CHANGE_REJECTED;
+	if(BL_TRANSPORT_FRAME_READY == frame_status){
+		/******* take the repeated frame , the copy still describes the first one *****/
+		BL_Host_Frame_Copy = *BL_Transport_pGetFrame();
+		if((CBL_CHANGE_BAUD_RATE_CMD == BL_Host_Frame->Cmd) && (Host_baud_rate == BL_Host_Frame->Address) &&
+			(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame))){
+			baud_status = BAUD_CHANGE_CONFIRMED;
+		}
+	}
+	if(BAUD_CHANGE_CONFIRMED == baud_status){
+		BL_VidSendAck(1U);
+		BL_VidSendReplyTo_Host((uint8*)&baud_status,1U);
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Baud Rate changed to %d \r\n",Host_baud_rate);
+#endif
+	}else{
+		/******* no valid confirmation , fall back to old rate *****/
+		(void)BL_UART_uint8SetBaudRate(old_baud_rate);
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("Baud Rate not confirmed , back to %d \r\n",old_baud_rate);
+#endif
+	}
+#endif
+}
+
+/*****BL_VidErase 
+**@param[in] Host_buffer pointer to data
+**/
+static void BL_VidErase(uint8 *Host_buffer)
+{
+	uint8 flash_erase_status = FLASH_FAILED_ERASE;
+	
+	/*****Log message***/	
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+	Bl_Print_Msg("Sector or Mass Erase of Flash \r\n");
+#endif
+	/*********Crc verification ***********/ 
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame))
+{
+		/*****Log message***/	
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+	Bl_Print_Msg("Crc Verification Passed \r\n");
+#endif
+	BL_VidSendAck(1U);
+	
+	/********** perform Erase ***********/
 	flash_erase_status = Perform_uint8FlashErase(Host_buffer[2U] , Host_buffer[3U]);
 	if(FLASH_SUCCESS_ERASE == flash_erase_status)
 	{
@@ -1152,20 +2582,14 @@ static void BL_VidExtendedSpecial(uint8 *Host_buffer)
 **/
 static void BL_VidWriteProtect(uint8 *Host_buffer)
 {
-	uint16 Host_cmd_packet_len = 0U;
-	uint32 Host_Crc32 = 0U;
 	uint8 WRP_level =0xEE;
 	
-	/***********Extract crc and command packet ***/
-	Host_cmd_packet_len = Host_buffer[0U] + 1U;
-	Host_Crc32 = *((uint32*)((Host_buffer + Host_cmd_packet_len) - CRC_SIZE_BYTE));
-	
 		/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 	Bl_Print_Msg("Write Protection Level \r\n");
 #endif
 	/*********Crc verification ***********/ 
-	if(CRC_VERFIY_SUCCESS == BL_uint8CRC_Verify((uint8 *)&Host_buffer[0U],Host_cmd_packet_len -4U , Host_Crc32)){
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
 			/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 	Bl_Print_Msg("CRC Verification Passed \r\n");
@@ -1188,19 +2612,14 @@ static void BL_VidWriteProtect(uint8 *Host_buffer)
 **/
 static void BL_VidWriteUnProtect(uint8 *Host_buffer)
 {
-	uint16 Host_cmd_packet_len = 0U;
-	uint32 Host_Crc32 = 0U;
 	uint8 WRP_LEVEL = 0xEE;
 	
-	/**************** Extract CRC and Command Packet******/
-	Host_cmd_packet_len = Host_buffer[0U]+1U;
-	Host_Crc32 = *((uint32*)((Host_buffer + Host_cmd_packet_len) - CRC_SIZE_BYTE));
 			/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 	Bl_Print_Msg("Get Disable Write Protection State \r\n");
 #endif
 	/*********Crc verification ***********/ 
-	if(CRC_VERFIY_SUCCESS == BL_uint8CRC_Verify((uint8 *)&Host_buffer[0U],Host_cmd_packet_len -4U , Host_Crc32)){
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
 			/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 	Bl_Print_Msg("CRC Verification Passed \r\n");
@@ -1226,21 +2645,15 @@ static void BL_VidWriteUnProtect(uint8 *Host_buffer)
 **/
 static void BL_VidReadOutProtect(uint8 *Host_buffer)
 {
-	uint16 Host_cmd_packet_len = 0U;
-	uint32 Host_Crc32 = 0U;
 	uint8 ROP_level_status = ROP_LEVEL_CHANGE_INVALID;
 	uint8 host_ROP_level = 0U;
 	
-	/***********Extract crc and command packet ***/
-	Host_cmd_packet_len = Host_buffer[0U] + 1U;
-	Host_Crc32 = *((uint32*)((Host_buffer + Host_cmd_packet_len) - CRC_SIZE_BYTE));
-	
 		/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 	Bl_Print_Msg("Enable Read Protection Level \r\n");
 #endif
 	/*********Crc verification ***********/ 
-	if(CRC_VERFIY_SUCCESS == BL_uint8CRC_Verify((uint8 *)&Host_buffer[0U],Host_cmd_packet_len -4U , Host_Crc32)){
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
 			/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 	Bl_Print_Msg("CRC Verification Passed \r\n");
@@ -1274,20 +2687,14 @@ static void BL_VidReadOutProtect(uint8 *Host_buffer)
 **/
 static void BL_VidReadOutUnProtect(uint8 *Host_buffer)
 {
-	uint16 Host_cmd_packet_len = 0U;
-	uint32 Host_Crc32 = 0U;
 	uint8 RDP_level =0xEE;
 	
-	/***********Extract crc and command packet ***/
-	Host_cmd_packet_len = Host_buffer[0U] + 1U;
-	Host_Crc32 = *((uint32*)((Host_buffer + Host_cmd_packet_len) - CRC_SIZE_BYTE));
-	
 		/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 	Bl_Print_Msg("Get Read Protection Level \r\n");
 #endif
 	/*********Crc verification ***********/ 
-	if(CRC_VERFIY_SUCCESS == BL_uint8CRC_Verify((uint8 *)&Host_buffer[0U],Host_cmd_packet_len -4U , Host_Crc32)){
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
 			/*****Log message***/	
 #if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
 	Bl_Print_Msg("CRC Verification Passed \r\n");
@@ -1309,8 +2716,54 @@ static void BL_VidReadOutUnProtect(uint8 *Host_buffer)
 	}
 }
 /*****BL_VidCheckSum 
+**@description frame -> len | cmd | range count | (address (4) | len (4)) ... | crc32
 **@param[in] Host_buffer pointer to data
 **/
 static void BL_VidCheckSum(uint8 *Host_buffer)
 {
+	uint8 range_count = 0U;
+	uint8 range_index = 0U;
+	uint32 range_address = 0U;
+	uint32 range_len = 0U;
+	uint8 ranges_verification = ADDRESS_IS_INVALID;
+	uint32 range_crc[BL_CHECK_SUM_MAX_RANGES];
+	
+	/****CRC verify check*****/
+	if(CRC_VERFIY_SUCCESS == BL_uint8FrameCrcVerify(BL_Host_Frame)){
+		range_count = Host_buffer[2U];
+		if((range_count > 0U) && (range_count <= BL_CHECK_SUM_MAX_RANGES) &&
+			(BL_Host_Frame->Len == (7U + ((uint16)range_count * BL_CHECK_SUM_RANGE_LEN)))){
+			ranges_verification = ADDRESS_IS_VALID;
+		}
+		/****** ranges one after the other through the DMA backend , all must be valid ****/
+		for(range_index = 0U ; (ADDRESS_IS_VALID == ranges_verification) && (range_index < range_count) ; range_index++)
+		{
+			range_address = BL_Transport_uint32GetLE(&Host_buffer[3U + ((uint16)range_index * BL_CHECK_SUM_RANGE_LEN)]);
+			range_len = BL_Transport_uint32GetLE(&Host_buffer[7U + ((uint16)range_index * BL_CHECK_SUM_RANGE_LEN)]);
+			/****** length limit keeps both ends in the same memory ****/
+			if((range_len > 0U) && (range_len <= (STM32F756_FLASH_SIZE + 1U)) && (ADDRESS_IS_VALID == Host_uint8AddressVerification(range_address)) &&
+				(ADDRESS_IS_VALID == Host_uint8AddressVerification(range_address + range_len - 1U))){
+				range_crc[range_index] = BL_uint32MemoryCrc(range_address , range_len);
+			}else{
+				ranges_verification = ADDRESS_IS_INVALID;
+			}
+		}
+		if(ADDRESS_IS_VALID == ranges_verification){
+			BL_VidSendAck((uint8)(range_count * CRC_SIZE_BYTE));
+			BL_VidSendReplyTo_Host((uint8 *)range_crc , range_count * CRC_SIZE_BYTE);
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+			Bl_Print_Msg("Check sum of %d ranges \r\n",range_count);
+#endif
+		}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+			Bl_Print_Msg("Invalid check sum range \r\n");
+#endif
+			BL_VidSendNack();
+		}
+	}else{
+#if DEBUG_INFO_ENABLE == BL_DEBUG_INFO
+		Bl_Print_Msg("CRC Verification Failed \r\n");
+#endif
+		BL_VidSendNack();
+	}
 }
@@ -12,20 +12,29 @@
 #include <stdarg.h>
 #include "usart.h"
 #include "crc.h"
+#include "bl_transport.h"
+#include "bl_crc.h"
+#include "bl_hash.h"
+#include "bl_aes.h"
+#include "bl_flash.h"
+#if BL_HOST_TRANSPORT == BL_TRANSPORT_UART
+#include "bl_uart.h"
+#endif
 
 /*********** Macro declerations**********/
 // UART Used for debug and communication
 #define BL_DEBUG_UART															&huart2
-#define BL_HOST_COMMUNICATION_UART								&huart6
 #define BL_CRC_ENGINE															&hcrc
 
 #define DEBUG_INFO_DISABLE												0
 #define DEBUG_INFO_ENABLE													1
 #define BL_DEBUG_INFO															(DEBUG_INFO_ENABLE)
 
-// Host RX Buffer
-#define BL_HOST_BUFFER_RX_LENGTH									200U
-#define BL_NO_OF_SUPPORTED_CMD										15U
+// Host RX Buffer (flash friendly payload chunk + extended frame overhead)
+#define BL_HOST_MAX_PAYLOAD_LENGTH								4096U
+#define BL_HOST_FRAME_OVERHEAD										16U
+#define BL_HOST_BUFFER_RX_LENGTH									(BL_HOST_MAX_PAYLOAD_LENGTH + BL_HOST_FRAME_OVERHEAD)
+#define BL_NO_OF_SUPPORTED_CMD										24U
 
 // Debug Info
 #define BL_EN_UART_DEBUG_MSG											0x00
@@ -39,6 +48,15 @@
 #define CBL_READ_MEMORY_CMD  											0x11
 #define CBL_GO_TO_ADDR_CMD  											0x21
 #define CBL_WRITE_MEMORY_CMD  										0x31
+#define CBL_WINDOW_WRITE_MEMORY_CMD  							0x32
+#define CBL_CHANGE_BAUD_RATE_CMD  								0x33
+#define CBL_SET_FRAME_MODE_CMD  									0x34
+#define CBL_BATCH_CMD  														0x35
+#define CBL_SET_CRC_MODE_CMD  										0x36
+#define CBL_SESSION_DIGEST_CMD  									0x37
+#define CBL_IMAGE_VERIFY_CMD  										0x38
+#define CBL_SET_WRITE_MODE_CMD  									0x39
+#define CBL_IMAGE_MANIFEST_CMD  									0x3A
 #define CBL_ERASE_CMD  														0x43
 #define CBL_EXTENDED_ERASE_CMD  									0x44
 #define CBL_SPECIAL_CMD  													0x50
@@ -83,6 +101,137 @@
 #define FLASH_WRITE_STATUS_PASS										0x01
 #define FLASH_WRITE_STATUS_FAIL										0x00
 
+/***********Windowed write memory Info***********/
+/* host keeps several sequence numbered frames in flight , all of them must fit RX ring.
+   sequence 0 starts a new window unless one is open , any other command closes it */
+#define BL_WINDOW_WRITE_MAX_FRAMES								6U
+#define BL_WINDOW_WRITE_REPLY_LEN									3U				/* status + expected sequence (LE) */
+#define BL_WINDOW_SEQ_NONE												0xFFFFU
+
+#define WINDOW_WRITE_STATUS_FAIL									0x00			/* address or flash failure , host aborts */
+#define WINDOW_WRITE_STATUS_ACK										0x01			/* all frames before expected sequence are written */
+#define WINDOW_WRITE_STATUS_RESEND								0x02			/* go back and resend from expected sequence */
+
+/***********Frame mode Info***********/
+#define BL_FRAME_MODE_LEGACY											0x00			/* 1 byte length frames only */
+#define BL_FRAME_MODE_EXTENDED										0x01			/* 16 bit length frames allowed for bulk commands */
+#define BL_FRAME_MODE_REPLY_LEN										3U				/* mode + max. frame size (LE) */
+
+/***********Batch Info***********/
+/* frame -> header | cmd | op count | op code + args ... | crc32 , ops run in order until first failure */
+#define BL_BATCH_MAX_OPS													64U
+#define BL_BATCH_OP_ERASE													0x01			/* sector | number of sectors */
+#define BL_BATCH_OP_WRITE													0x02			/* address (4) | len (2) | data */
+#define BL_BATCH_OP_CHECK_SUM											0x03			/* address (4) | len (4) | expected crc32 (4) */
+#define BL_BATCH_OP_GO														0x04			/* address (4) , must be last op */
+
+#define BL_BATCH_STATUS_FAIL											0x00			/* erase , write or check sum failed */
+#define BL_BATCH_STATUS_PASS											0x01
+#define BL_BATCH_STATUS_INVALID										0x02			/* unknown op , truncated args or invalid address */
+#define BL_BATCH_STATUS_SKIPPED										0x03			/* not executed , an earlier op failed */
+
+/***********Crc mode Info***********/
+/* frame -> len | cmd | BL_CRC_MODE_xx | crc32 (old mode) , reply -> accepted mode , new mode applies to next frame */
+#define BL_CRC_MODE_REPLY_LEN											1U
+
+/***********Session digest Info***********/
+/* frame -> len | cmd | crc32 , reply -> bytes written (4 , LE) | digest (4 , LE) | bytes programmed (4 , LE) ,
+   then a new session starts.
+   digest = CRC (frame convention) of every payload programmed since the session start , in write order ,
+   read back from the destination after programming. Bytes programmed leaves out the units flash already held */
+#define BL_SESSION_DIGEST_REPLY_LEN								12U
+#define BL_SESSION_DIGEST_EMPTY_LEGACY						0xFFFFFFFFU		/* legacy CRC of no data (state after reset) */
+
+/***********Image verification Info***********/
+/* header written by the host after the image , in the last sector so the image sectors stay untouched.
+   application runs from FLASH_SECTOR1_BASE_ADDRESS and must end before the header */
+#define BL_IMAGE_HEADER_ADDRESS										0x080C0000U		/* sector 7 */
+#define BL_IMAGE_HEADER_SECTOR										7U
+#define BL_IMAGE_MAGIC														0x474D4942U		/* "BIMG" */
+#define BL_IMAGE_MAGIC_MERKLE											0x474D494DU		/* "MIMG" , Sha256 holds the Merkle root */
+#define BL_IMAGE_VALID														0x01
+#define BL_IMAGE_INVALID													0x00
+#define BL_IMAGE_VERIFY_REPLY_LEN									5U				/* BL_IMAGE_xx | cycles (4 , LE) */
+
+/* boot cache : append only record log behind the header. The first write or erase of a power cycle appends a
+   WRITE record before touching flash , a full verification appends a VERIFIED record bound to the number of
+   WRITE records and to the header digest. Boot skips hashing while the last record is such a VERIFIED one */
+#define BL_BOOT_CACHE_ADDRESS											(BL_IMAGE_HEADER_ADDRESS + 0x100U)
+#define BL_BOOT_CACHE_END													(STM32F756_FLASH_END + 1U)		/* end of sector 7 */
+#define BL_BOOT_RECORD_LEN												40U				/* sizeof(Bl_Boot_Record) */
+#define BL_BOOT_RECORD_ERASED											0xFFFFFFFFU
+#define BL_BOOT_RECORD_WRITE											0x57524954U		/* "WRIT" */
+#define BL_BOOT_RECORD_VERIFIED										0x56455249U		/* "VERI" */
+#define BL_BOOT_RECORD_REVOKED										0x00000000U		/* log full : last record cleared in place */
+
+/* no host frame within this time after entry -> verify image and start it */
+#define BL_BOOT_ENTRY_TIMEOUT_MS									1000U
+#define BL_BOOT_STATE_IDLE												0x00			/* entry time not taken yet (BL_VidBootEntryStart) */
+#define BL_BOOT_STATE_WAIT												0x01			/* waiting for host */
+#define BL_BOOT_STATE_DONE												0x02			/* host talked or no valid image , stay */
+
+/***********Encrypted write Info***********/
+/* frame -> len | cmd | BL_WRITE_MODE_xx | nonce (BL_AES_NONCE_LEN) | crc32 , reply -> accepted mode.
+   In AES-CTR mode every write payload (write memory , windowed write , batch write) is decrypted before it
+   is programmed , the block at flash address A uses counter A / BL_AES_BLOCK_LEN. Use a new nonce per image */
+#define BL_WRITE_MODE_PLAIN												0x00
+#define BL_WRITE_MODE_AES_CTR											0x01
+#define BL_WRITE_MODE_REPLY_LEN										1U
+
+/***********Image manifest Info***********/
+/* chunked image : leaf i = SHA-256 of chunk i (Chunk_Size bytes from the image start , last one shorter) ,
+   parent = SHA-256(left | right) , an odd last node moves up unchanged. The MERKLE header carries the root and
+   an HMAC-SHA256 of its fields. frame -> header | cmd | part | data | crc32 , reply -> BL_MANIFEST_xx
+   part HEADER : Bl_Image_Header (BL_MERKLE_HEADER_LEN) , part LEAVES : first leaf (2 , LE) | leaf hashes in order.
+   Once the leaves match the root every write into the image must be one whole chunk matching its leaf , the
+   bootloader programs the header itself after the last chunk (header sector erased by the host before) */
+#define BL_MANIFEST_PART_HEADER										0x00
+#define BL_MANIFEST_PART_LEAVES										0x01
+#define BL_MANIFEST_REJECTED											0x00			/* bad MAC , root or sequence , manifest dropped */
+#define BL_MANIFEST_PENDING												0x01			/* more leaves expected */
+#define BL_MANIFEST_ACTIVE												0x02			/* chunks checked while written */
+#define BL_MANIFEST_REPLY_LEN											1U
+#define BL_MERKLE_HEADER_LEN											80U				/* sizeof(Bl_Image_Header) */
+#define BL_MERKLE_MAC_DATA_LEN										48U				/* header fields before Mac */
+#define BL_MERKLE_MAX_LEAVES											1024U			/* 32 KB of leaf hashes */
+#define BL_MERKLE_MAX_DEPTH												12U				/* log2(BL_MERKLE_MAX_LEAVES) + 2 */
+#define BL_MERKLE_MIN_CHUNK												64U
+
+// Image MAC key : from the file named by BL_KEYS_FILE like BL_AES_KEY (format in bl_keys_template.h)
+#if defined(BL_KEYS_FILE)
+#include BL_KEYS_FILE
+#endif
+#if !defined(BL_MERKLE_MAC_KEY)
+#error "BL_MERKLE_MAC_KEY missing : define BL_KEYS_FILE , see bl_keys_template.h"
+#endif
+
+/* image authentication : while enforced only MERKLE headers with a valid MAC boot , and a write into the
+   application or header sectors is programmed only as a whole chunk matching the leaf of an active manifest */
+#define BL_IMAGE_AUTH_DISABLE											0U				/* "BIMG" headers boot , unchecked writes allowed */
+#define BL_IMAGE_AUTH_ENABLE											1U
+#ifndef BL_IMAGE_AUTH
+#define BL_IMAGE_AUTH															BL_IMAGE_AUTH_ENABLE
+#endif
+
+#define BL_MERKLE_STATE_IDLE											0x00
+#define BL_MERKLE_STATE_LOADING										0x01			/* header accepted , leaves arriving */
+#define BL_MERKLE_STATE_ACTIVE										0x02
+
+#define BL_MERKLE_CHUNK_OUTSIDE										0x00			/* write does not touch the image */
+#define BL_MERKLE_CHUNK_VALID											0x01
+#define BL_MERKLE_CHUNK_INVALID										0x02
+
+/***********Check sum Info***********/
+/* frame -> len | cmd | range count | (address (4) | len (4)) per range | crc32 , reply -> crc32 (LE) per range */
+#define BL_CHECK_SUM_RANGE_LEN										8U
+#define BL_CHECK_SUM_MAX_RANGES										31U				/* 7 + 31 * 8 bytes fit the 1 byte length frame */
+
+/***********Change baud rate Info***********/
+#define BL_BAUD_CONFIRM_TIMEOUT_MS								500U			/* host must confirm new rate within this time */
+#define BAUD_CHANGE_REJECTED											0x00
+#define BAUD_CHANGE_ACCEPTED											0x01			/* reply at old rate , rate switched */
+#define BAUD_CHANGE_CONFIRMED											0x02			/* reply at new rate , rate kept */
+
 #define FLASH_SUCCESS_ERASE												0x01
 #define FLASH_FAILED_ERASE												0x00
 
@@ -91,6 +240,19 @@
 #define SECTOR_IS_INVALID													0x00
 
 #define FLASH_MASS_ERASE 													0xFF
+
+/***********Auto erase Info***********/
+/* a write session erases a sector before its first write to it when the payload can't be programmed over the
+   flash content ((flash & data) != data) , unless an erase command already did in the session. A sector already
+   programmed in place in the session is not erased , the write fails. Sector 0 holds the bootloader and is never
+   erased automatically */
+#define BL_AUTO_ERASE_DISABLE											0U
+#define BL_AUTO_ERASE_ENABLE											1U
+#define BL_AUTO_ERASE															BL_AUTO_ERASE_ENABLE
+#define BL_AUTO_ERASE_FIRST_SECTOR								1U
+/* STM32F756 sector start addresses : 4 x 32 KB , 128 KB , 3 x 256 KB , then end of flash */
+#define BL_FLASH_SECTOR_BASES											{0x08000000U , 0x08008000U , 0x08010000U , 0x08018000U , \
+																								 0x08020000U , 0x08040000U , 0x08080000U , 0x080C0000U , 0x08100000U}
 #define HAL_ERASE_SUCCESS   											0xFFFFFFFFU
 
 /***** change RDP*****/
@@ -118,6 +280,23 @@ typedef enum tagE__Bl_Status{
 	BL_ACK=1U
 }Bl_Status;
 
+/****Application image header (BL_IMAGE_HEADER_ADDRESS)***/
+typedef struct tagS__Bl_Image_Header{
+	uint32	Magic;								// BL_IMAGE_MAGIC or BL_IMAGE_MAGIC_MERKLE
+	uint32	Address;							// image start , FLASH_SECTOR1_BASE_ADDRESS
+	uint32	Length;								// bytes covered by Sha256
+	uint8		Sha256[BL_HASH_SHA256_LEN];	// image digest , Merkle root (MERKLE)
+	uint32	Chunk_Size;						// MERKLE only
+	uint8		Mac[BL_HASH_SHA256_LEN];	// MERKLE only : HMAC-SHA256 of the fields above
+}Bl_Image_Header;
+
+/****Boot cache record (BL_BOOT_CACHE_ADDRESS , type programmed first)***/
+typedef struct tagS__Bl_Boot_Record{
+	uint32	Type;									// BL_BOOT_RECORD_xx
+	uint32	Write_Count;					// WRITE records before this one
+	uint8		Sha256[BL_HASH_SHA256_LEN];	// header digest (VERIFIED) , erased (WRITE)
+}Bl_Boot_Record;
+
 typedef void (*Ptr_JumpAdd) (void);
 typedef void (*Ptr_app) (void);
 
@@ -131,5 +310,9 @@ void Bl_Print_Msg(char *format,...);
 **@return BL_ACK if there is no error else return BL_NACK
 */
 Bl_Status Bl_Uart_Fetch_Host_Cmd(void);
+/**function BL_VidBootEntryStart
+**@description takes the entry time of BL_BOOT_ENTRY_TIMEOUT_MS , call once right after reset
+*/
+void BL_VidBootEntryStart(void);
 
 #endif /*BOOTLOADER_H*/
@@ -0,0 +1,25 @@
+/// \file crc.h
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host build : stands in for Core/Inc/crc.h , software model of the CRC unit
+///        (poly 0x04C11DB7 , init 0xFFFFFFFF , 32 bit words , no reflection)
+
+#ifndef __CRC_H__
+#define __CRC_H__
+/************** Global Includes**************/
+#include "main.h"
+
+/*********** Macro declerations**********/
+#define __HAL_CRC_DR_RESET(__HANDLE__)							((__HANDLE__)->Value = 0xFFFFFFFFU)
+
+/*********** Data Type Declerations*****/
+typedef struct{
+	uint32_t Value;				// data register
+}CRC_HandleTypeDef;
+
+extern CRC_HandleTypeDef hcrc;
+
+/********* Software Function Prototype*******/
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc , uint32_t pBuffer[] , uint32_t BufferLength);
+
+#endif /* __CRC_H__ */
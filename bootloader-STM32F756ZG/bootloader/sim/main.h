@@ -0,0 +1,108 @@
+/// \file main.h
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host build : stands in for Core/Inc/main.h and the HAL/CMSIS parts the command engine uses.
+///        Flash and SRAM are mapped at their STM32F756 addresses by sim_hal.c.
+
+#ifndef __MAIN_H
+#define __MAIN_H
+/************** Global Includes**************/
+#include <stdint.h>
+#include <stddef.h>
+
+/*********** Macro declerations**********/
+// Memory map (same addresses as the target , backed by host memory)
+#define FLASH_BASE																	0x08000000UL
+#define SRAM1_BASE																	0x20010000UL
+#define SRAM2_BASE																	0x2004C000UL
+#define SIM_FLASH_SIZE															(1024UL * 1024UL)
+#define SIM_SRAM1_SIZE															(240UL * 1024UL)
+#define SIM_SRAM2_SIZE															(16UL * 1024UL)
+
+#define HAL_MAX_DELAY																0xFFFFFFFFU
+
+// Flash erase / program
+#define FLASH_TYPEERASE_SECTORS											0x00000000U
+#define FLASH_TYPEERASE_MASSERASE										0x00000001U
+#define FLASH_VOLTAGE_RANGE_1												0x00000000U
+#define FLASH_VOLTAGE_RANGE_2												0x00000001U
+#define FLASH_VOLTAGE_RANGE_3												0x00000002U
+#define FLASH_VOLTAGE_RANGE_4												0x00000003U
+#define FLASH_TYPEPROGRAM_BYTE											0x00000000U
+#define FLASH_TYPEPROGRAM_HALFWORD									0x00000001U
+#define FLASH_TYPEPROGRAM_WORD											0x00000002U
+#define FLASH_TYPEPROGRAM_DOUBLEWORD								0x00000003U
+
+// Option bytes
+#define OPTIONBYTE_WRP															0x00000001U
+#define OPTIONBYTE_RDP															0x00000002U
+#define OB_WRPSTATE_DISABLE													0x00000000U
+#define OB_WRPSTATE_ENABLE													0x00000001U
+#define OB_WRP_SECTOR_All														0x00FF0000U
+#define OB_RDP_LEVEL_0															((uint8_t)0xAA)
+#define OB_RDP_LEVEL_1															((uint8_t)0x55)
+#define OB_RDP_LEVEL_2															((uint8_t)0xCC)
+
+// Device id reported by GET_ID (STM32F74x/75x)
+#define SIM_DEVICE_ID																0x10016449U
+
+/*********** Data Type Declerations*****/
+typedef enum{
+	HAL_OK = 0x00U,
+	HAL_ERROR = 0x01U,
+	HAL_BUSY = 0x02U,
+	HAL_TIMEOUT = 0x03U
+}HAL_StatusTypeDef;
+
+typedef struct{
+	uint32_t TypeErase;
+	uint32_t Banks;
+	uint32_t Sector;
+	uint32_t NbSectors;
+	uint32_t VoltageRange;
+}FLASH_EraseInitTypeDef;
+
+typedef struct{
+	uint32_t OptionType;
+	uint32_t WRPState;
+	uint32_t WRPSector;
+	uint32_t RDPLevel;
+	uint32_t BORLevel;
+	uint32_t USERConfig;
+	uint32_t BootAddr0;
+	uint32_t BootAddr1;
+}FLASH_OBProgramInitTypeDef;
+
+typedef struct{
+	volatile uint32_t IDCODE;
+	volatile uint32_t CR;
+	volatile uint32_t APB1FZ;
+	volatile uint32_t APB2FZ;
+}DBGMCU_TypeDef;
+
+extern DBGMCU_TypeDef Sim_DBGMCU;
+#define DBGMCU																			(&Sim_DBGMCU)
+
+/********* Software Function Prototype*******/
+void Error_Handler(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+HAL_StatusTypeDef HAL_RCC_DeInit(void);
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram , uint32_t Address , uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit , uint32_t *SectorError);
+HAL_StatusTypeDef HAL_FLASH_OB_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_OB_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_OB_Launch(void);
+HAL_StatusTypeDef HAL_FLASHEx_OBProgram(FLASH_OBProgramInitTypeDef *pOBInit);
+void HAL_FLASHEx_OBGetConfig(FLASH_OBProgramInitTypeDef *pOBInit);
+void __set_MSP(uint32_t topOfMainStack);
+
+/*****Sim_VidMemoryInit
+**@description maps flash (kept in flash_image file) , SRAM1 and SRAM2 at target addresses
+**@param[in] flash_image path of flash backing file , created erased if missing
+**/
+void Sim_VidMemoryInit(const char *flash_image);
+
+#endif /* __MAIN_H */
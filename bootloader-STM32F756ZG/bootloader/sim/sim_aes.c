@@ -0,0 +1,161 @@
+/// \file sim_aes.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host build : stands in for bootloader/bl_aes.c , portable AES-128 CTR (FIPS 197) in software
+/// BL_AES_uint32LastCycles reports nanoseconds instead of cycles.
+
+
+/************Global Includes*************/
+#include <string.h>
+#include <time.h>
+#include "bl_aes.h"
+
+/*********** Macro declerations**********/
+#define SIM_AES_ROUNDS															10U
+#define SIM_AES_XTIME(x)														((uint8)(((x) << 1U) ^ ((0U != ((x) & 0x80U)) ? 0x1BU : 0x00U)))
+
+/********* Static Function Prototypes************/
+static void Sim_AES_VidExpandKey(void);
+static void Sim_AES_VidEncryptBlock(const uint8 *input , uint8 *output);
+static uint32 Sim_AES_uint32Nanoseconds(void);
+
+/********* Global Variables Declerations************/
+static const uint8 Sim_Aes_Sbox[256U] = {
+	0x63U , 0x7CU , 0x77U , 0x7BU , 0xF2U , 0x6BU , 0x6FU , 0xC5U , 0x30U , 0x01U , 0x67U , 0x2BU , 0xFEU , 0xD7U , 0xABU , 0x76U ,
+	0xCAU , 0x82U , 0xC9U , 0x7DU , 0xFAU , 0x59U , 0x47U , 0xF0U , 0xADU , 0xD4U , 0xA2U , 0xAFU , 0x9CU , 0xA4U , 0x72U , 0xC0U ,
+	0xB7U , 0xFDU , 0x93U , 0x26U , 0x36U , 0x3FU , 0xF7U , 0xCCU , 0x34U , 0xA5U , 0xE5U , 0xF1U , 0x71U , 0xD8U , 0x31U , 0x15U ,
+	0x04U , 0xC7U , 0x23U , 0xC3U , 0x18U , 0x96U , 0x05U , 0x9AU , 0x07U , 0x12U , 0x80U , 0xE2U , 0xEBU , 0x27U , 0xB2U , 0x75U ,
+	0x09U , 0x83U , 0x2CU , 0x1AU , 0x1BU , 0x6EU , 0x5AU , 0xA0U , 0x52U , 0x3BU , 0xD6U , 0xB3U , 0x29U , 0xE3U , 0x2FU , 0x84U ,
+	0x53U , 0xD1U , 0x00U , 0xEDU , 0x20U , 0xFCU , 0xB1U , 0x5BU , 0x6AU , 0xCBU , 0xBEU , 0x39U , 0x4AU , 0x4CU , 0x58U , 0xCFU ,
+	0xD0U , 0xEFU , 0xAAU , 0xFBU , 0x43U , 0x4DU , 0x33U , 0x85U , 0x45U , 0xF9U , 0x02U , 0x7FU , 0x50U , 0x3CU , 0x9FU , 0xA8U ,
+	0x51U , 0xA3U , 0x40U , 0x8FU , 0x92U , 0x9DU , 0x38U , 0xF5U , 0xBCU , 0xB6U , 0xDAU , 0x21U , 0x10U , 0xFFU , 0xF3U , 0xD2U ,
+	0xCDU , 0x0CU , 0x13U , 0xECU , 0x5FU , 0x97U , 0x44U , 0x17U , 0xC4U , 0xA7U , 0x7EU , 0x3DU , 0x64U , 0x5DU , 0x19U , 0x73U ,
+	0x60U , 0x81U , 0x4FU , 0xDCU , 0x22U , 0x2AU , 0x90U , 0x88U , 0x46U , 0xEEU , 0xB8U , 0x14U , 0xDEU , 0x5EU , 0x0BU , 0xDBU ,
+	0xE0U , 0x32U , 0x3AU , 0x0AU , 0x49U , 0x06U , 0x24U , 0x5CU , 0xC2U , 0xD3U , 0xACU , 0x62U , 0x91U , 0x95U , 0xE4U , 0x79U ,
+	0xE7U , 0xC8U , 0x37U , 0x6DU , 0x8DU , 0xD5U , 0x4EU , 0xA9U , 0x6CU , 0x56U , 0xF4U , 0xEAU , 0x65U , 0x7AU , 0xAEU , 0x08U ,
+	0xBAU , 0x78U , 0x25U , 0x2EU , 0x1CU , 0xA6U , 0xB4U , 0xC6U , 0xE8U , 0xDDU , 0x74U , 0x1FU , 0x4BU , 0xBDU , 0x8BU , 0x8AU ,
+	0x70U , 0x3EU , 0xB5U , 0x66U , 0x48U , 0x03U , 0xF6U , 0x0EU , 0x61U , 0x35U , 0x57U , 0xB9U , 0x86U , 0xC1U , 0x1DU , 0x9EU ,
+	0xE1U , 0xF8U , 0x98U , 0x11U , 0x69U , 0xD9U , 0x8EU , 0x94U , 0x9BU , 0x1EU , 0x87U , 0xE9U , 0xCEU , 0x55U , 0x28U , 0xDFU ,
+	0x8CU , 0xA1U , 0x89U , 0x0DU , 0xBFU , 0xE6U , 0x42U , 0x68U , 0x41U , 0x99U , 0x2DU , 0x0FU , 0xB0U , 0x54U , 0xBBU , 0x16U
+};
+static const uint8 Sim_Aes_Key[BL_AES_KEY_LEN] = BL_AES_KEY;
+static uint8 Sim_Aes_Round_Keys[(SIM_AES_ROUNDS + 1U) * BL_AES_BLOCK_LEN];
+static uint8 Sim_Aes_Key_Ready = 0U;
+static uint8 Sim_Aes_Nonce[BL_AES_NONCE_LEN] = {0U};
+static uint32 Sim_Aes_Last_Ns = 0U;
+
+/********* Software Function Definition *******/
+void BL_AES_VidSetNonce(const uint8 *nonce)
+{
+	memcpy(Sim_Aes_Nonce , nonce , BL_AES_NONCE_LEN);
+}
+
+void BL_AES_VidCtrCrypt(uint8 *data , uint32 blocks , uint32 counter)
+{
+	uint8 loc_counter_block[BL_AES_BLOCK_LEN];
+	uint8 loc_key_stream[BL_AES_BLOCK_LEN];
+	uint32 loc_block = 0U;
+	uint8 loc_count = 0U;
+	uint32 loc_start = Sim_AES_uint32Nanoseconds();
+
+	if(0U == Sim_Aes_Key_Ready){
+		Sim_AES_VidExpandKey();
+		Sim_Aes_Key_Ready = 1U;
+	}
+	memcpy(loc_counter_block , Sim_Aes_Nonce , BL_AES_NONCE_LEN);
+	for(loc_block = 0U ; loc_block < blocks ; loc_block++)
+	{
+		loc_counter_block[12U] = (uint8)(counter >> 24U);
+		loc_counter_block[13U] = (uint8)(counter >> 16U);
+		loc_counter_block[14U] = (uint8)(counter >> 8U);
+		loc_counter_block[15U] = (uint8)counter;
+		Sim_AES_VidEncryptBlock(loc_counter_block , loc_key_stream);
+		for(loc_count = 0U ; loc_count < BL_AES_BLOCK_LEN ; loc_count++)
+		{
+			data[(loc_block * BL_AES_BLOCK_LEN) + loc_count] ^= loc_key_stream[loc_count];
+		}
+		counter++;
+	}
+	Sim_Aes_Last_Ns = Sim_AES_uint32Nanoseconds() - loc_start;
+}
+
+uint32 BL_AES_uint32LastCycles(void)
+{
+	return Sim_Aes_Last_Ns;
+}
+
+/********* Static Function Definitions************/
+static void Sim_AES_VidExpandKey(void)
+{
+	uint8 loc_rcon = 0x01U;
+	uint8 loc_temp[4U];
+	uint8 loc_count = 0U;
+
+	memcpy(Sim_Aes_Round_Keys , Sim_Aes_Key , BL_AES_KEY_LEN);
+	for(loc_count = 4U ; loc_count < (4U * (SIM_AES_ROUNDS + 1U)) ; loc_count++)
+	{
+		memcpy(loc_temp , &Sim_Aes_Round_Keys[(loc_count - 1U) << 2U] , 4U);
+		if(0U == (loc_count & 3U)){
+			/****** RotWord , SubWord , Rcon ****/
+			uint8 loc_first = loc_temp[0U];
+			loc_temp[0U] = Sim_Aes_Sbox[loc_temp[1U]] ^ loc_rcon;
+			loc_temp[1U] = Sim_Aes_Sbox[loc_temp[2U]];
+			loc_temp[2U] = Sim_Aes_Sbox[loc_temp[3U]];
+			loc_temp[3U] = Sim_Aes_Sbox[loc_first];
+			loc_rcon = SIM_AES_XTIME(loc_rcon);
+		}
+		Sim_Aes_Round_Keys[(loc_count << 2U) + 0U] = Sim_Aes_Round_Keys[((loc_count - 4U) << 2U) + 0U] ^ loc_temp[0U];
+		Sim_Aes_Round_Keys[(loc_count << 2U) + 1U] = Sim_Aes_Round_Keys[((loc_count - 4U) << 2U) + 1U] ^ loc_temp[1U];
+		Sim_Aes_Round_Keys[(loc_count << 2U) + 2U] = Sim_Aes_Round_Keys[((loc_count - 4U) << 2U) + 2U] ^ loc_temp[2U];
+		Sim_Aes_Round_Keys[(loc_count << 2U) + 3U] = Sim_Aes_Round_Keys[((loc_count - 4U) << 2U) + 3U] ^ loc_temp[3U];
+	}
+}
+
+static void Sim_AES_VidEncryptBlock(const uint8 *input , uint8 *output)
+{
+	uint8 loc_state[BL_AES_BLOCK_LEN];
+	uint8 loc_shifted[BL_AES_BLOCK_LEN];
+	uint8 loc_round = 0U;
+	uint8 loc_count = 0U;
+	uint8 loc_a0 , loc_a1 , loc_a2 , loc_a3 , loc_all;
+
+	for(loc_count = 0U ; loc_count < BL_AES_BLOCK_LEN ; loc_count++)
+	{
+		loc_state[loc_count] = input[loc_count] ^ Sim_Aes_Round_Keys[loc_count];
+	}
+	for(loc_round = 1U ; loc_round <= SIM_AES_ROUNDS ; loc_round++)
+	{
+		/****** SubBytes and ShiftRows (state is column major) ****/
+		for(loc_count = 0U ; loc_count < BL_AES_BLOCK_LEN ; loc_count++)
+		{
+			loc_shifted[loc_count] = Sim_Aes_Sbox[loc_state[(loc_count + ((loc_count & 3U) << 2U)) & 15U]];
+		}
+		/****** MixColumns , skipped in the last round ****/
+		for(loc_count = 0U ; loc_count < BL_AES_BLOCK_LEN ; loc_count += 4U)
+		{
+			loc_a0 = loc_shifted[loc_count + 0U];
+			loc_a1 = loc_shifted[loc_count + 1U];
+			loc_a2 = loc_shifted[loc_count + 2U];
+			loc_a3 = loc_shifted[loc_count + 3U];
+			if(SIM_AES_ROUNDS != loc_round){
+				loc_all = loc_a0 ^ loc_a1 ^ loc_a2 ^ loc_a3;
+				loc_shifted[loc_count + 0U] = loc_a0 ^ loc_all ^ SIM_AES_XTIME(loc_a0 ^ loc_a1);
+				loc_shifted[loc_count + 1U] = loc_a1 ^ loc_all ^ SIM_AES_XTIME(loc_a1 ^ loc_a2);
+				loc_shifted[loc_count + 2U] = loc_a2 ^ loc_all ^ SIM_AES_XTIME(loc_a2 ^ loc_a3);
+				loc_shifted[loc_count + 3U] = loc_a3 ^ loc_all ^ SIM_AES_XTIME(loc_a3 ^ loc_a0);
+			}
+		}
+		for(loc_count = 0U ; loc_count < BL_AES_BLOCK_LEN ; loc_count++)
+		{
+			loc_state[loc_count] = loc_shifted[loc_count] ^ Sim_Aes_Round_Keys[(loc_round * BL_AES_BLOCK_LEN) + loc_count];
+		}
+	}
+	memcpy(output , loc_state , BL_AES_BLOCK_LEN);
+}
+
+static uint32 Sim_AES_uint32Nanoseconds(void)
+{
+	struct timespec loc_ts;
+	clock_gettime(CLOCK_MONOTONIC , &loc_ts);
+	return (uint32)((uint64)loc_ts.tv_sec * 1000000000ULL + (uint64)loc_ts.tv_nsec);
+}
@@ -0,0 +1,133 @@
+/// \file sim_crc.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host build : stands in for bootloader/bl_crc.c , both CRC conventions in software
+/// BL_CRC_VidMeasureCycles reports nanoseconds instead of cycles , the DMA
+/// path (BL_CRC_uint32CalculateRange) is calculated in software as well.
+
+
+/************Global Includes*************/
+#include <time.h>
+#include "bl_crc.h"
+#include "crc.h"
+
+/*********** Macro declerations**********/
+#define SIM_CRC_POLY																0x04C11DB7U
+#define SIM_CRC_POLY_REFLECTED											0xEDB88320U
+#define SIM_CRC_INIT																0xFFFFFFFFU
+
+/********* Static Function Prototypes************/
+/*****Sim_uint32Nanoseconds
+**@return monotonic time in ns (truncated)
+**/
+static uint32 Sim_uint32Nanoseconds(void);
+
+/********* Global Variables Declerations************/
+static uint8 Sim_Crc_Mode = BL_CRC_MODE_LEGACY;
+static uint32 Sim_Crc_Value = SIM_CRC_INIT;
+
+/********* Software Function Definition *******/
+void BL_CRC_VidInit(void)
+{
+}
+
+void BL_CRC_VidSetMode(uint8 crc_mode)
+{
+	Sim_Crc_Mode = (BL_CRC_MODE_STANDARD == crc_mode) ? BL_CRC_MODE_STANDARD : BL_CRC_MODE_LEGACY;
+}
+
+uint8 BL_CRC_uint8GetMode(void)
+{
+	return Sim_Crc_Mode;
+}
+
+void BL_CRC_VidStart(void)
+{
+	Sim_Crc_Value = SIM_CRC_INIT;
+}
+
+void BL_CRC_VidResume(uint32 crc)
+{
+	Sim_Crc_Value = (BL_CRC_MODE_STANDARD == Sim_Crc_Mode) ? (crc ^ 0xFFFFFFFFU) : crc;
+}
+
+void BL_CRC_VidAccumulate(const uint8 *data , uint32 len)
+{
+	uint32 loc_count = 0U;
+	uint8 loc_bit = 0U;
+
+	for(loc_count = 0U ; loc_count < len ; loc_count++)
+	{
+		if(BL_CRC_MODE_LEGACY == Sim_Crc_Mode){
+			/****** byte zero extended to a word , 32 shifts ****/
+			Sim_Crc_Value ^= data[loc_count];
+			for(loc_bit = 0U ; loc_bit < 32U ; loc_bit++)
+			{
+				Sim_Crc_Value = (Sim_Crc_Value & 0x80000000U) ? ((Sim_Crc_Value << 1U) ^ SIM_CRC_POLY) : (Sim_Crc_Value << 1U);
+			}
+		}else{
+			Sim_Crc_Value ^= data[loc_count];
+			for(loc_bit = 0U ; loc_bit < 8U ; loc_bit++)
+			{
+				Sim_Crc_Value = (Sim_Crc_Value & 1U) ? ((Sim_Crc_Value >> 1U) ^ SIM_CRC_POLY_REFLECTED) : (Sim_Crc_Value >> 1U);
+			}
+		}
+	}
+}
+
+uint32 BL_CRC_uint32Finish(void)
+{
+	return (BL_CRC_MODE_STANDARD == Sim_Crc_Mode) ? (Sim_Crc_Value ^ 0xFFFFFFFFU) : Sim_Crc_Value;
+}
+
+uint32 BL_CRC_uint32Calculate(const uint8 *data , uint32 len)
+{
+	BL_CRC_VidStart();
+	BL_CRC_VidAccumulate(data , len);
+	return BL_CRC_uint32Finish();
+}
+
+uint32 BL_CRC_uint32CalculateRange(uint32 address , uint32 len)
+{
+	return BL_CRC_uint32Calculate((const uint8 *)address , len);
+}
+
+void BL_CRC_VidDmaIRQ(void)
+{
+}
+
+void BL_CRC_VidMeasureCycles(const uint8 *data , uint32 len , Bl_Crc_Cycles *cycles)
+{
+	uint8 loc_mode = Sim_Crc_Mode;
+	uint32 loc_data = 0U;
+	uint32 loc_count = 0U;
+	uint32 loc_start = Sim_uint32Nanoseconds();
+
+	for(loc_count = 0U ; loc_count < len ; loc_count++)
+	{
+		loc_data = (uint32)data[loc_count];
+		(void)HAL_CRC_Accumulate(&hcrc , &loc_data , 1U);
+	}
+	__HAL_CRC_DR_RESET(&hcrc);
+	cycles->HalPerByte = Sim_uint32Nanoseconds() - loc_start;
+	Sim_Crc_Mode = BL_CRC_MODE_LEGACY;
+	loc_start = Sim_uint32Nanoseconds();
+	(void)BL_CRC_uint32Calculate(data , len);
+	cycles->Legacy = Sim_uint32Nanoseconds() - loc_start;
+	Sim_Crc_Mode = BL_CRC_MODE_STANDARD;
+	loc_start = Sim_uint32Nanoseconds();
+	(void)BL_CRC_uint32Calculate(data , len);
+	cycles->Standard = Sim_uint32Nanoseconds() - loc_start;
+	loc_start = Sim_uint32Nanoseconds();
+	(void)BL_CRC_uint32Calculate(data , len);
+	cycles->Dma = Sim_uint32Nanoseconds() - loc_start;
+	Sim_Crc_Mode = loc_mode;
+}
+
+/********* Static Function Definitions************/
+static uint32 Sim_uint32Nanoseconds(void)
+{
+	struct timespec loc_ts;
+	clock_gettime(CLOCK_MONOTONIC , &loc_ts);
+	return (uint32)((uint64)loc_ts.tv_sec * 1000000000ULL + (uint64)loc_ts.tv_nsec);
+}
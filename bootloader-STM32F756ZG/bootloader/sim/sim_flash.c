@@ -0,0 +1,195 @@
+/// \file sim_flash.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host build : stands in for bootloader/bl_flash.c , same split on the sim HAL
+/// The stream path has no registers to drive , it programs through the sim HAL while
+/// the stream is open. Throughput and unit time are taken from the monotonic clock in
+/// nanoseconds instead of cycles. There is no vector table to move , the erase of the sim
+/// HAL is instant : idle runs once so the host link work of a real erase is still done.
+
+
+/************Global Includes*************/
+#include <string.h>
+#include <time.h>
+#include "bl_flash.h"
+
+/********* Static Function Prototypes************/
+static uint8 Sim_FLASH_uint8ProgramUnits(uint8 path , uint8 type , uint32 address , const uint8 *data , uint32 count);
+static uint8 Sim_FLASH_uint8Split(uint8 path , uint32 address , const uint8 *data , uint32 len);
+static uint64 Sim_FLASH_uint64Nanoseconds(void);
+
+/********* Global Variables Declerations************/
+static uint32 Sim_Flash_Bytes[BL_FLASH_PATHS][BL_FLASH_PROGRAM_TYPES];
+static uint64 Sim_Flash_Ns[BL_FLASH_PATHS][BL_FLASH_PROGRAM_TYPES];
+static uint8 Sim_Flash_Stream_Open = 0U;
+static uint32 Sim_Flash_Skipped = 0U;
+static uint32 Sim_Flash_Last_Programmed = 0U;
+
+/********* Software Function Definition *******/
+void BL_FLASH_VidInit(void)
+{
+}
+
+void BL_FLASH_VidDeInit(void)
+{
+}
+
+uint8 BL_FLASH_uint8Program(uint32 address , const uint8 *data , uint32 len)
+{
+	return Sim_FLASH_uint8Split(BL_FLASH_PATH_HAL , address , data , len);
+}
+
+uint8 BL_FLASH_uint8Begin(void)
+{
+	/****** an erase locks the sim HAL too , unlock on every call ****/
+	uint8 loc_status = HAL_FLASH_Unlock();
+
+	Sim_Flash_Stream_Open = (HAL_OK == loc_status) ? 1U : 0U;
+	return loc_status;
+}
+
+uint8 BL_FLASH_uint8ProgramBuffer(uint32 address , const uint8 *data , uint32 len)
+{
+	uint8 loc_status = HAL_ERROR;
+
+	if(0U != Sim_Flash_Stream_Open){
+		loc_status = Sim_FLASH_uint8Split(BL_FLASH_PATH_STREAM , address , data , len);
+	}
+	return loc_status;
+}
+
+uint8 BL_FLASH_uint8End(void)
+{
+	Sim_Flash_Stream_Open = 0U;
+	(void)HAL_FLASH_Lock();
+	return HAL_OK;
+}
+
+uint8 BL_FLASH_uint8Erase(uint8 sector , uint8 count , Bl_Flash_Idle idle)
+{
+	FLASH_EraseInitTypeDef loc_erase;
+	uint32 loc_error = 0U;
+	uint8 loc_status = HAL_ERROR;
+
+	(void)BL_FLASH_uint8End();
+	if(HAL_OK == HAL_FLASH_Unlock()){
+		if(NULL != idle){
+			idle();
+		}
+		loc_erase.TypeErase = (BL_FLASH_ERASE_MASS == sector) ? FLASH_TYPEERASE_MASSERASE : FLASH_TYPEERASE_SECTORS;
+		loc_erase.Sector = sector;
+		loc_erase.NbSectors = count;
+		loc_erase.VoltageRange = BL_FLASH_VOLTAGE_RANGE;
+		loc_status = HAL_FLASHEx_Erase(&loc_erase , &loc_error);
+		if(0xFFFFFFFFU != loc_error){
+			loc_status = HAL_ERROR;
+		}
+	}
+	(void)HAL_FLASH_Lock();
+	return loc_status;
+}
+
+uint32 BL_FLASH_uint32LastProgrammed(void)
+{
+	return Sim_Flash_Last_Programmed;
+}
+
+uint32 BL_FLASH_uint32Skipped(void)
+{
+	return Sim_Flash_Skipped;
+}
+
+uint32 BL_FLASH_uint32Bytes(uint8 path , uint8 type)
+{
+	return ((path < BL_FLASH_PATHS) && (type < BL_FLASH_PROGRAM_TYPES)) ? Sim_Flash_Bytes[path][type] : 0U;
+}
+
+uint32 BL_FLASH_uint32BytesPerSecond(uint8 path , uint8 type)
+{
+	uint32 loc_rate = 0U;
+
+	if((path < BL_FLASH_PATHS) && (type < BL_FLASH_PROGRAM_TYPES) && (0U != Sim_Flash_Ns[path][type])){
+		loc_rate = (uint32)(((uint64)Sim_Flash_Bytes[path][type] * 1000000000ULL) / Sim_Flash_Ns[path][type]);
+	}
+	return loc_rate;
+}
+
+uint32 BL_FLASH_uint32UnitCycles(uint8 path , uint8 type)
+{
+	uint32 loc_ns = 0U;
+
+	if((path < BL_FLASH_PATHS) && (type < BL_FLASH_PROGRAM_TYPES) && (0U != Sim_Flash_Bytes[path][type])){
+		loc_ns = (uint32)(Sim_Flash_Ns[path][type] / (Sim_Flash_Bytes[path][type] >> type));
+	}
+	return loc_ns;
+}
+
+void BL_FLASH_VidStatsReset(void)
+{
+	memset(Sim_Flash_Bytes , 0 , sizeof(Sim_Flash_Bytes));
+	memset(Sim_Flash_Ns , 0 , sizeof(Sim_Flash_Ns));
+	Sim_Flash_Skipped = 0U;
+}
+
+/********* Static Function Definitions************/
+static uint8 Sim_FLASH_uint8Split(uint8 path , uint32 address , const uint8 *data , uint32 len)
+{
+	uint8 loc_status = HAL_OK;
+	uint32 loc_head = (BL_FLASH_PROGRAM_UNIT - (address & (BL_FLASH_PROGRAM_UNIT - 1UL))) & (BL_FLASH_PROGRAM_UNIT - 1UL);
+	uint32 loc_count = 0U;
+
+	Sim_Flash_Last_Programmed = 0U;
+	if(loc_head > len){
+		loc_head = len;
+	}
+	loc_count = (len - loc_head) / BL_FLASH_PROGRAM_UNIT;
+	loc_status = Sim_FLASH_uint8ProgramUnits(path , FLASH_TYPEPROGRAM_BYTE , address , data , loc_head);
+	if(HAL_OK == loc_status){
+		loc_status = Sim_FLASH_uint8ProgramUnits(path , BL_FLASH_PROGRAM_TYPE , address + loc_head , &data[loc_head] , loc_count);
+	}
+	if(HAL_OK == loc_status){
+		loc_head += loc_count * BL_FLASH_PROGRAM_UNIT;
+		loc_status = Sim_FLASH_uint8ProgramUnits(path , FLASH_TYPEPROGRAM_BYTE , address + loc_head , &data[loc_head] , len - loc_head);
+	}
+	return loc_status;
+}
+
+static uint8 Sim_FLASH_uint8ProgramUnits(uint8 path , uint8 type , uint32 address , const uint8 *data , uint32 count)
+{
+	uint8 loc_status = HAL_OK;
+	uint32 loc_width = 1UL << type;
+	uint32 loc_count = 0U;
+	uint32 loc_programmed = 0U;
+	uint64 loc_start = Sim_FLASH_uint64Nanoseconds();
+	uint64 loc_unit = 0U;
+
+	for(loc_count = 0U ; loc_count < count ; loc_count++)
+	{
+		if((BL_FLASH_SKIP_ENABLE == BL_FLASH_SKIP_MATCHING) &&
+			(0 == memcmp((const void *)(uintptr_t)(address + (loc_count * loc_width)) , &data[loc_count * loc_width] , loc_width))){
+			continue;
+		}
+		/****** source may be unaligned , little endian like the flash ****/
+		loc_unit = 0U;
+		memcpy(&loc_unit , &data[loc_count * loc_width] , loc_width);
+		loc_status = HAL_FLASH_Program(type , address + (loc_count * loc_width) , loc_unit);
+		if(HAL_OK != loc_status){
+			break;
+		}
+		loc_programmed += loc_width;
+	}
+	if(0U != count){
+		Sim_Flash_Ns[path][type] += Sim_FLASH_uint64Nanoseconds() - loc_start;
+		Sim_Flash_Bytes[path][type] += loc_programmed;
+		Sim_Flash_Skipped += (loc_count * loc_width) - loc_programmed;
+		Sim_Flash_Last_Programmed += loc_programmed;
+	}
+	return loc_status;
+}
+
+static uint64 Sim_FLASH_uint64Nanoseconds(void)
+{
+	struct timespec loc_ts;
+	clock_gettime(CLOCK_MONOTONIC , &loc_ts);
+	return ((uint64)loc_ts.tv_sec * 1000000000ULL) + (uint64)loc_ts.tv_nsec;
+}
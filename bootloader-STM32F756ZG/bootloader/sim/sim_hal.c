@@ -0,0 +1,275 @@
+/// \file sim_hal.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host build : HAL model used by the command engine on Linux
+/// Flash is a file mapped at FLASH_BASE , so images survive between runs and
+/// the engine reads it through plain pointers like on the target. Programming
+/// can only clear bits and erase sets a whole sector to 0xFF , same as the
+/// real flash. A jump into the mapped memory (GO command or application
+/// start) faults because nothing is executable , the fault is reported as
+/// the jump target and the process ends.
+
+
+/************Global Includes*************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "main.h"
+#include "usart.h"
+#include "crc.h"
+
+/*********** Macro declerations**********/
+#define SIM_FLASH_MAX_SECTORS												8U
+#define SIM_CRC_POLY																0x04C11DB7U
+
+/********* Static Function Prototypes************/
+/*****Sim_VidMap
+**@param[in] address target address
+**@param[in] size region size
+**@param[in] fd backing file or -1 for anonymous memory
+**/
+static void Sim_VidMap(uintptr_t address , size_t size , int fd);
+
+/*****Sim_VidFaultHandler
+**@description reports jumps into mapped (non executable) target memory
+**/
+static void Sim_VidFaultHandler(int sig , siginfo_t *info , void *context);
+
+/********* Global Variables Declerations************/
+UART_HandleTypeDef huart2 = {STDERR_FILENO};
+CRC_HandleTypeDef hcrc = {0xFFFFFFFFU};
+DBGMCU_TypeDef Sim_DBGMCU = {SIM_DEVICE_ID , 0U , 0U , 0U};
+
+/* F756 sector layout : 4 x 32 KB , 1 x 128 KB , 3 x 256 KB */
+static const uint32_t Sim_Sector_Size[SIM_FLASH_MAX_SECTORS] = {
+	0x8000U , 0x8000U , 0x8000U , 0x8000U , 0x20000U , 0x40000U , 0x40000U , 0x40000U
+};
+static uint8_t Sim_Flash_Locked = 1U;
+static FLASH_OBProgramInitTypeDef Sim_Option_Bytes = {0U , OB_WRPSTATE_DISABLE , 0U , OB_RDP_LEVEL_0 , 0U , 0U , 0U , 0U};
+
+/********* Software Function Definition *******/
+/*****Sim_VidMemoryInit
+**@param[in] flash_image path of flash backing file , created erased if missing
+**/
+void Sim_VidMemoryInit(const char *flash_image)
+{
+	struct sigaction loc_action;
+	struct stat loc_stat;
+	int loc_fd = open(flash_image , O_RDWR | O_CREAT , 0644);
+	off_t loc_size = 0;
+
+	if((loc_fd < 0) || (0 != fstat(loc_fd , &loc_stat))){
+		perror(flash_image);
+		exit(EXIT_FAILURE);
+	}
+	loc_size = loc_stat.st_size;
+	if(loc_size < (off_t)SIM_FLASH_SIZE){
+		/****** new image : extend it and make the missing part erased ****/
+		if(0 != ftruncate(loc_fd , SIM_FLASH_SIZE)){
+			perror(flash_image);
+			exit(EXIT_FAILURE);
+		}
+	}
+	Sim_VidMap(FLASH_BASE , SIM_FLASH_SIZE , loc_fd);
+	if(loc_size < (off_t)SIM_FLASH_SIZE){
+		memset((uint8_t *)(FLASH_BASE + (uintptr_t)loc_size) , 0xFF , SIM_FLASH_SIZE - (size_t)loc_size);
+	}
+	close(loc_fd);
+	Sim_VidMap(SRAM1_BASE , SIM_SRAM1_SIZE , -1);
+	Sim_VidMap(SRAM2_BASE , SIM_SRAM2_SIZE , -1);
+
+	memset(&loc_action , 0 , sizeof(loc_action));
+	loc_action.sa_sigaction = Sim_VidFaultHandler;
+	loc_action.sa_flags = SA_SIGINFO;
+	sigaction(SIGSEGV , &loc_action , NULL);
+}
+
+void Error_Handler(void)
+{
+	fprintf(stderr , "Error_Handler called\n");
+	exit(EXIT_FAILURE);
+}
+
+uint32_t HAL_GetTick(void)
+{
+	struct timespec loc_now;
+	clock_gettime(CLOCK_MONOTONIC , &loc_now);
+	return (uint32_t)((loc_now.tv_sec * 1000) + (loc_now.tv_nsec / 1000000));
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	usleep(Delay * 1000U);
+}
+
+HAL_StatusTypeDef HAL_RCC_DeInit(void)
+{
+	return HAL_OK;
+}
+
+void __set_MSP(uint32_t topOfMainStack)
+{
+	(void)topOfMainStack;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart , const uint8_t *pData , uint16_t Size , uint32_t Timeout)
+{
+	(void)Timeout;
+	/****** debug messages are sent as fixed size zero padded buffers ****/
+	if(write(huart->Fd , pData , strnlen((const char *)pData , Size)) < 0){
+		return HAL_ERROR;
+	}
+	return HAL_OK;
+}
+
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc , uint32_t pBuffer[] , uint32_t BufferLength)
+{
+	uint32_t loc_index = 0U;
+	uint8_t loc_bit = 0U;
+
+	for(loc_index = 0U ; loc_index < BufferLength ; loc_index++)
+	{
+		hcrc->Value ^= pBuffer[loc_index];
+		for(loc_bit = 0U ; loc_bit < 32U ; loc_bit++)
+		{
+			hcrc->Value = (hcrc->Value & 0x80000000U) ? ((hcrc->Value << 1U) ^ SIM_CRC_POLY) : (hcrc->Value << 1U);
+		}
+	}
+	return hcrc->Value;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+	Sim_Flash_Locked = 0U;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+	Sim_Flash_Locked = 1U;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram , uint32_t Address , uint64_t Data)
+{
+	static const uint8_t loc_width[4U] = {1U , 2U , 4U , 8U};
+	uint8_t *loc_dest = (uint8_t *)(uintptr_t)Address;
+	uint8_t loc_index = 0U;
+
+	if((0U != Sim_Flash_Locked) || (TypeProgram > FLASH_TYPEPROGRAM_DOUBLEWORD) ||
+		(Address < FLASH_BASE) || ((Address + loc_width[TypeProgram]) > (FLASH_BASE + SIM_FLASH_SIZE))){
+		return HAL_ERROR;
+	}
+	/****** programming can only clear bits ****/
+	for(loc_index = 0U ; loc_index < loc_width[TypeProgram] ; loc_index++)
+	{
+		loc_dest[loc_index] &= (uint8_t)(Data >> (8U * loc_index));
+	}
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit , uint32_t *SectorError)
+{
+	uint32_t loc_offset = 0U;
+	uint32_t loc_sector = 0U;
+
+	*SectorError = 0xFFFFFFFFU;
+	if(0U != Sim_Flash_Locked){
+		return HAL_ERROR;
+	}
+	if(FLASH_TYPEERASE_MASSERASE == pEraseInit->TypeErase){
+		memset((uint8_t *)FLASH_BASE , 0xFF , SIM_FLASH_SIZE);
+		return HAL_OK;
+	}
+	for(loc_sector = 0U ; loc_sector < SIM_FLASH_MAX_SECTORS ; loc_sector++)
+	{
+		if((loc_sector >= pEraseInit->Sector) && (loc_sector < (pEraseInit->Sector + pEraseInit->NbSectors))){
+			memset((uint8_t *)(FLASH_BASE + loc_offset) , 0xFF , Sim_Sector_Size[loc_sector]);
+		}
+		loc_offset += Sim_Sector_Size[loc_sector];
+	}
+	if((pEraseInit->Sector + pEraseInit->NbSectors) > SIM_FLASH_MAX_SECTORS){
+		*SectorError = SIM_FLASH_MAX_SECTORS;
+		return HAL_ERROR;
+	}
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_OB_Unlock(void)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_OB_Lock(void)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_OB_Launch(void)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_OBProgram(FLASH_OBProgramInitTypeDef *pOBInit)
+{
+	/****** option bytes only live for this run , level 2 is not made permanent ****/
+	if(OPTIONBYTE_RDP & pOBInit->OptionType){
+		Sim_Option_Bytes.RDPLevel = pOBInit->RDPLevel;
+	}
+	if(OPTIONBYTE_WRP & pOBInit->OptionType){
+		Sim_Option_Bytes.WRPState = pOBInit->WRPState;
+		Sim_Option_Bytes.WRPSector = pOBInit->WRPSector;
+	}
+	return HAL_OK;
+}
+
+void HAL_FLASHEx_OBGetConfig(FLASH_OBProgramInitTypeDef *pOBInit)
+{
+	*pOBInit = Sim_Option_Bytes;
+	pOBInit->OptionType = OPTIONBYTE_WRP | OPTIONBYTE_RDP;
+}
+
+/********* Static Function Definitions************/
+/*****Sim_VidMap
+**@param[in] address target address
+**@param[in] size region size
+**@param[in] fd backing file or -1 for anonymous memory
+**/
+static void Sim_VidMap(uintptr_t address , size_t size , int fd)
+{
+	int loc_flags = MAP_FIXED_NOREPLACE | ((fd < 0) ? (MAP_PRIVATE | MAP_ANONYMOUS) : MAP_SHARED);
+	void *loc_mem = mmap((void *)address , size , PROT_READ | PROT_WRITE , loc_flags , fd , 0);
+
+	if(loc_mem != (void *)address){
+		fprintf(stderr , "cannot map target memory at 0x%08lX\n" , (unsigned long)address);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/*****Sim_VidFaultHandler
+**@description reports jumps into mapped (non executable) target memory
+**/
+static void Sim_VidFaultHandler(int sig , siginfo_t *info , void *context)
+{
+	uintptr_t loc_address = (uintptr_t)info->si_addr;
+	char loc_msg[64];
+	int loc_len = 0;
+
+	(void)context;
+	if(((loc_address >= FLASH_BASE) && (loc_address < (FLASH_BASE + SIM_FLASH_SIZE))) ||
+		((loc_address >= SRAM1_BASE) && (loc_address < (SRAM1_BASE + SIM_SRAM1_SIZE))) ||
+		((loc_address >= SRAM2_BASE) && (loc_address < (SRAM2_BASE + SIM_SRAM2_SIZE)))){
+		loc_len = snprintf(loc_msg , sizeof(loc_msg) , "jump to 0x%08lX , simulation ends\n" , (unsigned long)loc_address);
+		(void)write(STDERR_FILENO , loc_msg , (size_t)loc_len);
+		_exit(EXIT_SUCCESS);
+	}
+	signal(sig , SIG_DFL);
+	raise(sig);
+}
@@ -0,0 +1,150 @@
+/// \file sim_hash.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host build : stands in for bootloader/bl_hash.c , portable SHA-256 (FIPS 180-4) in software
+/// BL_HASH_uint32LastCycles reports nanoseconds instead of cycles.
+
+
+/************Global Includes*************/
+#include <string.h>
+#include <time.h>
+#include "bl_hash.h"
+
+/*********** Macro declerations**********/
+#define SIM_HASH_BLOCK_LEN													64U
+#define SIM_HASH_HMAC_IPAD													0x36U
+#define SIM_HASH_HMAC_OPAD													0x5CU
+#define SIM_HASH_ROTR(x , n)												(((x) >> (n)) | ((x) << (32U - (n))))
+
+/********* Static Function Prototypes************/
+static void Sim_HASH_VidBlock(uint32 *state , const uint8 *block);
+static uint32 Sim_HASH_uint32Nanoseconds(void);
+
+/********* Global Variables Declerations************/
+static const uint32 Sim_Hash_K[64U] = {
+	0x428A2F98U , 0x71374491U , 0xB5C0FBCFU , 0xE9B5DBA5U , 0x3956C25BU , 0x59F111F1U , 0x923F82A4U , 0xAB1C5ED5U ,
+	0xD807AA98U , 0x12835B01U , 0x243185BEU , 0x550C7DC3U , 0x72BE5D74U , 0x80DEB1FEU , 0x9BDC06A7U , 0xC19BF174U ,
+	0xE49B69C1U , 0xEFBE4786U , 0x0FC19DC6U , 0x240CA1CCU , 0x2DE92C6FU , 0x4A7484AAU , 0x5CB0A9DCU , 0x76F988DAU ,
+	0x983E5152U , 0xA831C66DU , 0xB00327C8U , 0xBF597FC7U , 0xC6E00BF3U , 0xD5A79147U , 0x06CA6351U , 0x14292967U ,
+	0x27B70A85U , 0x2E1B2138U , 0x4D2C6DFCU , 0x53380D13U , 0x650A7354U , 0x766A0ABBU , 0x81C2C92EU , 0x92722C85U ,
+	0xA2BFE8A1U , 0xA81A664BU , 0xC24B8B70U , 0xC76C51A3U , 0xD192E819U , 0xD6990624U , 0xF40E3585U , 0x106AA070U ,
+	0x19A4C116U , 0x1E376C08U , 0x2748774CU , 0x34B0BCB5U , 0x391C0CB3U , 0x4ED8AA4AU , 0x5B9CCA4FU , 0x682E6FF3U ,
+	0x748F82EEU , 0x78A5636FU , 0x84C87814U , 0x8CC70208U , 0x90BEFFFAU , 0xA4506CEBU , 0xBEF9A3F7U , 0xC67178F2U
+};
+static uint32 Sim_Hash_Last_Ns = 0U;
+
+/********* Software Function Definition *******/
+uint8 BL_HASH_uint8Sha256(const uint8 *data , uint32 len , uint8 *digest)
+{
+	uint32 loc_state[8U] = {
+		0x6A09E667U , 0xBB67AE85U , 0x3C6EF372U , 0xA54FF53AU , 0x510E527FU , 0x9B05688CU , 0x1F83D9ABU , 0x5BE0CD19U
+	};
+	uint8 loc_tail[2U * SIM_HASH_BLOCK_LEN] = {0U};
+	uint32 loc_tail_len = len % SIM_HASH_BLOCK_LEN;
+	uint32 loc_pad_len = (loc_tail_len < 56U) ? SIM_HASH_BLOCK_LEN : (2U * SIM_HASH_BLOCK_LEN);
+	uint64 loc_bits = (uint64)len << 3U;
+	uint32 loc_count = 0U;
+	uint32 loc_start = Sim_HASH_uint32Nanoseconds();
+
+	for(loc_count = 0U ; (loc_count + SIM_HASH_BLOCK_LEN) <= len ; loc_count += SIM_HASH_BLOCK_LEN)
+	{
+		Sim_HASH_VidBlock(loc_state , &data[loc_count]);
+	}
+	/****** last bytes , 0x80 , zeros , length in bits (big endian) ****/
+	memcpy(loc_tail , &data[loc_count] , loc_tail_len);
+	loc_tail[loc_tail_len] = 0x80U;
+	for(loc_count = 0U ; loc_count < 8U ; loc_count++)
+	{
+		loc_tail[loc_pad_len - 1U - loc_count] = (uint8)(loc_bits >> (loc_count << 3U));
+	}
+	for(loc_count = 0U ; loc_count < loc_pad_len ; loc_count += SIM_HASH_BLOCK_LEN)
+	{
+		Sim_HASH_VidBlock(loc_state , &loc_tail[loc_count]);
+	}
+	for(loc_count = 0U ; loc_count < 8U ; loc_count++)
+	{
+		digest[(loc_count << 2U) + 0U] = (uint8)(loc_state[loc_count] >> 24U);
+		digest[(loc_count << 2U) + 1U] = (uint8)(loc_state[loc_count] >> 16U);
+		digest[(loc_count << 2U) + 2U] = (uint8)(loc_state[loc_count] >> 8U);
+		digest[(loc_count << 2U) + 3U] = (uint8)loc_state[loc_count];
+	}
+	Sim_Hash_Last_Ns = Sim_HASH_uint32Nanoseconds() - loc_start;
+	return BL_HASH_OK;
+}
+
+uint8 BL_HASH_uint8HmacSha256(const uint8 *key , const uint8 *data , uint32 len , uint8 *mac)
+{
+	uint8 loc_block[SIM_HASH_BLOCK_LEN + BL_HASH_HMAC_MAX_DATA];
+	uint8 loc_inner[BL_HASH_SHA256_LEN];
+	uint8 loc_count = 0U;
+
+	memset(loc_block , SIM_HASH_HMAC_IPAD , SIM_HASH_BLOCK_LEN);
+	for(loc_count = 0U ; loc_count < BL_HASH_HMAC_KEY_LEN ; loc_count++)
+	{
+		loc_block[loc_count] ^= key[loc_count];
+	}
+	memcpy(&loc_block[SIM_HASH_BLOCK_LEN] , data , len);
+	(void)BL_HASH_uint8Sha256(loc_block , SIM_HASH_BLOCK_LEN + len , loc_inner);
+	memset(loc_block , SIM_HASH_HMAC_OPAD , SIM_HASH_BLOCK_LEN);
+	for(loc_count = 0U ; loc_count < BL_HASH_HMAC_KEY_LEN ; loc_count++)
+	{
+		loc_block[loc_count] ^= key[loc_count];
+	}
+	memcpy(&loc_block[SIM_HASH_BLOCK_LEN] , loc_inner , BL_HASH_SHA256_LEN);
+	return BL_HASH_uint8Sha256(loc_block , SIM_HASH_BLOCK_LEN + BL_HASH_SHA256_LEN , mac);
+}
+
+uint32 BL_HASH_uint32LastCycles(void)
+{
+	return Sim_Hash_Last_Ns;
+}
+
+/********* Static Function Definitions************/
+static void Sim_HASH_VidBlock(uint32 *state , const uint8 *block)
+{
+	uint32 loc_w[64U];
+	uint32 loc_v[8U];
+	uint32 loc_t1 = 0U;
+	uint32 loc_t2 = 0U;
+	uint8 loc_count = 0U;
+
+	for(loc_count = 0U ; loc_count < 16U ; loc_count++)
+	{
+		loc_w[loc_count] = ((uint32)block[loc_count << 2U] << 24U) | ((uint32)block[(loc_count << 2U) + 1U] << 16U) |
+											 ((uint32)block[(loc_count << 2U) + 2U] << 8U) | (uint32)block[(loc_count << 2U) + 3U];
+	}
+	for(loc_count = 16U ; loc_count < 64U ; loc_count++)
+	{
+		loc_w[loc_count] = (SIM_HASH_ROTR(loc_w[loc_count - 2U] , 17U) ^ SIM_HASH_ROTR(loc_w[loc_count - 2U] , 19U) ^ (loc_w[loc_count - 2U] >> 10U)) +
+											 loc_w[loc_count - 7U] +
+											 (SIM_HASH_ROTR(loc_w[loc_count - 15U] , 7U) ^ SIM_HASH_ROTR(loc_w[loc_count - 15U] , 18U) ^ (loc_w[loc_count - 15U] >> 3U)) +
+											 loc_w[loc_count - 16U];
+	}
+	memcpy(loc_v , state , sizeof(loc_v));
+	for(loc_count = 0U ; loc_count < 64U ; loc_count++)
+	{
+		loc_t1 = loc_v[7U] + (SIM_HASH_ROTR(loc_v[4U] , 6U) ^ SIM_HASH_ROTR(loc_v[4U] , 11U) ^ SIM_HASH_ROTR(loc_v[4U] , 25U)) +
+						 ((loc_v[4U] & loc_v[5U]) ^ (~loc_v[4U] & loc_v[6U])) + Sim_Hash_K[loc_count] + loc_w[loc_count];
+		loc_t2 = (SIM_HASH_ROTR(loc_v[0U] , 2U) ^ SIM_HASH_ROTR(loc_v[0U] , 13U) ^ SIM_HASH_ROTR(loc_v[0U] , 22U)) +
+						 ((loc_v[0U] & loc_v[1U]) ^ (loc_v[0U] & loc_v[2U]) ^ (loc_v[1U] & loc_v[2U]));
+		loc_v[7U] = loc_v[6U];
+		loc_v[6U] = loc_v[5U];
+		loc_v[5U] = loc_v[4U];
+		loc_v[4U] = loc_v[3U] + loc_t1;
+		loc_v[3U] = loc_v[2U];
+		loc_v[2U] = loc_v[1U];
+		loc_v[1U] = loc_v[0U];
+		loc_v[0U] = loc_t1 + loc_t2;
+	}
+	for(loc_count = 0U ; loc_count < 8U ; loc_count++)
+	{
+		state[loc_count] += loc_v[loc_count];
+	}
+}
+
+static uint32 Sim_HASH_uint32Nanoseconds(void)
+{
+	struct timespec loc_ts;
+	clock_gettime(CLOCK_MONOTONIC , &loc_ts);
+	return (uint32)((uint64)loc_ts.tv_sec * 1000000000ULL + (uint64)loc_ts.tv_nsec);
+}
@@ -0,0 +1,43 @@
+/// \file sim_main.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host build : runs the bootloader command engine on Linux over BL_Sim_Transport
+///
+/// Build (from bootloader-STM32F756ZG) :
+///   gcc -O2 -no-pie -DBL_HOST_TRANSPORT=BL_TRANSPORT_SIM -Ibootloader/sim -Ibootloader -ILIB
+///       bootloader/bootloader.c bootloader/bl_transport.c bootloader/sim/*.c -o bl_sim
+/// Run :
+///   ./bl_sim [flash image , default bl_sim_flash.bin]
+///   python Host.py and open the printed /dev/pts/N as serial port
+/// -no-pie keeps the executable away from the target memory map.
+
+
+/************Global Includes*************/
+#include <stdio.h>
+#include "main.h"
+#include "bootloader.h"
+
+/*********** Macro declerations**********/
+#define SIM_DEFAULT_FLASH_IMAGE											"bl_sim_flash.bin"
+
+int main(int argc , char *argv[])
+{
+	Bl_Status Status = BL_NACK;
+
+	Sim_VidMemoryInit((argc > 1) ? argv[1] : SIM_DEFAULT_FLASH_IMAGE);
+	BL_VidBootEntryStart();
+	if(BL_TRANSPORT_LINK_OK != BL_HOST_LINK->Init()){
+#if BL_DEBUG_INFO == DEBUG_INFO_ENABLE
+		Bl_Print_Msg("Host link failed to start \r\n");
+#endif
+	}
+#if BL_DEBUG_INFO == DEBUG_INFO_ENABLE
+	Bl_Print_Msg("Bootloader Started \r\n");
+#endif
+	while(1)
+	{
+		Status = Bl_Uart_Fetch_Host_Cmd();
+		(void)Status;
+	}
+	return 0;
+}
@@ -0,0 +1,179 @@
+/// \file sim_transport.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host build : host link over a Linux pseudo terminal (BL_Sim_Transport)
+/// The slave side name is printed on start , Host.py opens it like a serial
+/// port (baud rate is ignored). Received bytes go to the same kind of ring
+/// the UART DMA fills and are parsed by the shared transport parser.
+
+
+/************Global Includes*************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+#include "main.h"
+#include "bl_transport.h"
+
+/*********** Macro declerations**********/
+#define SIM_RX_RING_LENGTH													16384U
+#define SIM_POLL_TIMEOUT_MS													1
+
+/********* Static Function Prototypes************/
+static uint8 Sim_uint8Init(void);
+static uint8 Sim_uint8Receive(uint8 *frame_buf , uint16 buf_len);
+static void Sim_VidTransmit(const uint8 *data , uint16 len);
+static void Sim_VidFlush(uint8 flush_mode);
+static void Sim_VidPoll(void);
+static uint16 Sim_uint16MaxFrameSize(void);
+static void Sim_VidDeInit(void);
+
+/*****Sim_VidRxFill
+**@description moves everything the host wrote into the ring (never blocks)
+**/
+static void Sim_VidRxFill(void);
+
+/********* Global Variables Declerations************/
+static int Sim_Pty_Fd = -1;
+static uint8 Sim_Rx_Buf[SIM_RX_RING_LENGTH];
+static Bl_Rx_Ring Sim_Rx_Ring = {Sim_Rx_Buf , SIM_RX_RING_LENGTH , 0U , 0U};
+static uint32 Sim_Last_Rx_Tick = 0U;							// tick of last received byte
+
+/* host link operations of the pseudo terminal */
+const Bl_Transport BL_Sim_Transport = {
+	Sim_uint8Init,
+	Sim_uint8Receive,
+	Sim_VidTransmit,
+	Sim_VidFlush,
+	Sim_VidPoll,
+	Sim_uint16MaxFrameSize,
+	Sim_VidDeInit
+};
+
+/********* Static Function Definitions************/
+/*****Sim_uint8Init
+**@description opens the pseudo terminal in raw mode and prints its slave name
+**@return BL_TRANSPORT_LINK_OK (exits when no pseudo terminal is available)
+**/
+static uint8 Sim_uint8Init(void)
+{
+	struct termios loc_tio;
+	int loc_slave_fd = -1;
+
+	Sim_Pty_Fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if((Sim_Pty_Fd < 0) || (0 != grantpt(Sim_Pty_Fd)) || (0 != unlockpt(Sim_Pty_Fd))){
+		perror("posix_openpt");
+		exit(EXIT_FAILURE);
+	}
+	/****** raw slave : no echo , no line editing , all 256 byte values pass ****/
+	loc_slave_fd = open(ptsname(Sim_Pty_Fd) , O_RDWR | O_NOCTTY);
+	if((loc_slave_fd >= 0) && (0 == tcgetattr(loc_slave_fd , &loc_tio))){
+		cfmakeraw(&loc_tio);
+		(void)tcsetattr(loc_slave_fd , TCSANOW , &loc_tio);
+	}
+	printf("host link : %s\n" , ptsname(Sim_Pty_Fd));
+	fflush(stdout);
+	/****** slave stays open , master reads would fail with EIO while no host is connected ****/
+	Sim_Rx_Ring.Head = 0U;
+	Sim_Rx_Ring.Tail = 0U;
+	Sim_Last_Rx_Tick = HAL_GetTick();
+	return BL_TRANSPORT_LINK_OK;
+}
+
+/*****Sim_uint8Receive
+**@param[in] frame_buf destination buffer
+**@param[in] buf_len destination buffer size
+**@return BL_TRANSPORT_FRAME_xx
+**/
+static uint8 Sim_uint8Receive(uint8 *frame_buf , uint16 buf_len)
+{
+	uint8 loc_line_silent = 0U;
+
+	Sim_VidRxFill();
+	if((HAL_GetTick() - Sim_Last_Rx_Tick) >= BL_TRANSPORT_INTER_BYTE_TIMEOUT_MS){
+		loc_line_silent = 1U;
+	}
+	return BL_Transport_uint8FetchFrame(&Sim_Rx_Ring , frame_buf , buf_len , loc_line_silent);
+}
+
+/*****Sim_VidTransmit
+**@param[in] data pointer to data
+**@param[in] len data length
+**/
+static void Sim_VidTransmit(const uint8 *data , uint16 len)
+{
+	ssize_t loc_written = 0;
+	struct pollfd loc_pfd = {Sim_Pty_Fd , POLLOUT , 0};
+
+	while(len > 0U)
+	{
+		loc_written = write(Sim_Pty_Fd , data , len);
+		if(loc_written > 0){
+			data = &data[loc_written];
+			len = (uint16)(len - (uint16)loc_written);
+		}else{
+			(void)poll(&loc_pfd , 1U , SIM_POLL_TIMEOUT_MS);
+		}
+	}
+}
+
+/*****Sim_VidFlush
+**@param[in] flush_mode BL_TRANSPORT_FLUSH_NO_WAIT or BL_TRANSPORT_FLUSH_WAIT
+**/
+static void Sim_VidFlush(uint8 flush_mode)
+{
+	/****** written bytes are already in the pty ****/
+	(void)flush_mode;
+}
+
+/*****Sim_VidPoll
+**@description waits up to 1 ms for host data (like systick wake up on target)
+**/
+static void Sim_VidPoll(void)
+{
+	struct pollfd loc_pfd = {Sim_Pty_Fd , POLLIN , 0};
+	(void)poll(&loc_pfd , 1U , SIM_POLL_TIMEOUT_MS);
+}
+
+/*****Sim_uint16MaxFrameSize
+**@return biggest frame the ring can hold
+**/
+static uint16 Sim_uint16MaxFrameSize(void)
+{
+	return (uint16)(SIM_RX_RING_LENGTH - BL_TRANSPORT_FRAME_SOF_LEN - 1U);
+}
+
+/*****Sim_VidDeInit
+**@description keeps the pty open , host still reads the last reply after a jump
+**/
+static void Sim_VidDeInit(void)
+{
+}
+
+/*****Sim_VidRxFill
+**@description moves everything the host wrote into the ring (never blocks)
+**/
+static void Sim_VidRxFill(void)
+{
+	uint16 loc_free = (uint16)(SIM_RX_RING_LENGTH - 1U - BL_Transport_uint16RxAvailable(&Sim_Rx_Ring));
+	uint16 loc_chunk = 0U;
+	ssize_t loc_read = 1;
+
+	while((loc_free > 0U) && (loc_read > 0))
+	{
+		/****** contiguous part up to ring end ****/
+		loc_chunk = (uint16)(SIM_RX_RING_LENGTH - Sim_Rx_Ring.Head);
+		if(loc_chunk > loc_free){
+			loc_chunk = loc_free;
+		}
+		loc_read = read(Sim_Pty_Fd , &Sim_Rx_Buf[Sim_Rx_Ring.Head] , loc_chunk);
+		if(loc_read > 0){
+			Sim_Rx_Ring.Head = (uint16)((Sim_Rx_Ring.Head + (uint16)loc_read) % SIM_RX_RING_LENGTH);
+			loc_free = (uint16)(loc_free - (uint16)loc_read);
+			Sim_Last_Rx_Tick = HAL_GetTick();
+		}
+	}
+}
@@ -0,0 +1,201 @@
+/// \file sim_udp.c
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host build : host link over a loopback UDP socket (BL_Sim_UDP_Transport)
+/// Same datagram format as the Ethernet link of the target (bl_udp.c) , so
+/// Host.py talks to it with "udp:127.0.0.1". Build with
+/// -DBL_HOST_TRANSPORT=BL_TRANSPORT_SIM_UDP.
+
+
+/************Global Includes*************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "main.h"
+#include "bl_transport.h"
+
+/*********** Macro declerations**********/
+#define SIM_UDP_RX_RING_LENGTH											8192U
+#define SIM_UDP_POLL_TIMEOUT_MS											1
+
+/********* Static Function Prototypes************/
+static uint8 Sim_UDP_uint8Init(void);
+static uint8 Sim_UDP_uint8Receive(uint8 *frame_buf , uint16 buf_len);
+static void Sim_UDP_VidTransmit(const uint8 *data , uint16 len);
+static void Sim_UDP_VidFlush(uint8 flush_mode);
+static void Sim_UDP_VidPoll(void);
+static uint16 Sim_UDP_uint16MaxFrameSize(void);
+static void Sim_UDP_VidDeInit(void);
+
+/*****Sim_UDP_VidRxFill
+**@description moves pending datagrams into the ring while a whole datagram fits (never blocks)
+**/
+static void Sim_UDP_VidRxFill(void);
+
+/********* Global Variables Declerations************/
+static int Sim_Udp_Fd = -1;
+static uint8 Sim_Udp_Rx_Buf[SIM_UDP_RX_RING_LENGTH];
+static Bl_Rx_Ring Sim_Udp_Rx_Ring = {Sim_Udp_Rx_Buf , SIM_UDP_RX_RING_LENGTH , 0U , 0U};
+static uint32 Sim_Udp_Last_Rx_Tick = 0U;						// tick of last datagram
+static uint8 Sim_Udp_Tx_Buf[BL_TRANSPORT_UDP_MAX_PAYLOAD];
+static uint16 Sim_Udp_Tx_Len = 0U;									// reply payload gathered
+static struct sockaddr_in Sim_Udp_Peer;
+static uint8 Sim_Udp_Peer_Valid = 0U;
+
+/* host link operations of the loopback socket */
+const Bl_Transport BL_Sim_UDP_Transport = {
+	Sim_UDP_uint8Init,
+	Sim_UDP_uint8Receive,
+	Sim_UDP_VidTransmit,
+	Sim_UDP_VidFlush,
+	Sim_UDP_VidPoll,
+	Sim_UDP_uint16MaxFrameSize,
+	Sim_UDP_VidDeInit
+};
+
+/********* Static Function Definitions************/
+/*****Sim_UDP_uint8Init
+**@description binds the socket to 127.0.0.1:BL_TRANSPORT_UDP_PORT
+**@return BL_TRANSPORT_LINK_OK (exits when the port is taken)
+**/
+static uint8 Sim_UDP_uint8Init(void)
+{
+	struct sockaddr_in loc_addr;
+
+	Sim_Udp_Fd = socket(AF_INET , SOCK_DGRAM | SOCK_NONBLOCK , 0);
+	memset(&loc_addr , 0 , sizeof(loc_addr));
+	loc_addr.sin_family = AF_INET;
+	loc_addr.sin_port = htons(BL_TRANSPORT_UDP_PORT);
+	loc_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if((Sim_Udp_Fd < 0) || (0 != bind(Sim_Udp_Fd , (struct sockaddr *)&loc_addr , sizeof(loc_addr)))){
+		perror("udp bind");
+		exit(EXIT_FAILURE);
+	}
+	printf("host link : udp:127.0.0.1:%u\n" , (unsigned int)BL_TRANSPORT_UDP_PORT);
+	fflush(stdout);
+	Sim_Udp_Rx_Ring.Head = 0U;
+	Sim_Udp_Rx_Ring.Tail = 0U;
+	Sim_Udp_Tx_Len = 0U;
+	Sim_Udp_Peer_Valid = 0U;
+	Sim_Udp_Last_Rx_Tick = HAL_GetTick();
+	return BL_TRANSPORT_LINK_OK;
+}
+
+/*****Sim_UDP_uint8Receive
+**@param[in] frame_buf destination buffer
+**@param[in] buf_len destination buffer size
+**@return BL_TRANSPORT_FRAME_xx
+**/
+static uint8 Sim_UDP_uint8Receive(uint8 *frame_buf , uint16 buf_len)
+{
+	uint8 loc_line_silent = 0U;
+
+	Sim_UDP_VidRxFill();
+	if((HAL_GetTick() - Sim_Udp_Last_Rx_Tick) >= BL_TRANSPORT_INTER_BYTE_TIMEOUT_MS){
+		loc_line_silent = 1U;
+	}
+	return BL_Transport_uint8FetchFrame(&Sim_Udp_Rx_Ring , frame_buf , buf_len , loc_line_silent);
+}
+
+/*****Sim_UDP_VidTransmit
+**@param[in] data pointer to data
+**@param[in] len data length
+**/
+static void Sim_UDP_VidTransmit(const uint8 *data , uint16 len)
+{
+	uint16 loc_chunk = 0U;
+
+	while(len > 0U)
+	{
+		if(BL_TRANSPORT_UDP_MAX_PAYLOAD == Sim_Udp_Tx_Len){
+			Sim_UDP_VidFlush(BL_TRANSPORT_FLUSH_NO_WAIT);
+		}
+		loc_chunk = BL_TRANSPORT_UDP_MAX_PAYLOAD - Sim_Udp_Tx_Len;
+		if(loc_chunk > len){
+			loc_chunk = len;
+		}
+		memcpy(&Sim_Udp_Tx_Buf[Sim_Udp_Tx_Len] , data , loc_chunk);
+		Sim_Udp_Tx_Len = (uint16)(Sim_Udp_Tx_Len + loc_chunk);
+		data = &data[loc_chunk];
+		len = (uint16)(len - loc_chunk);
+	}
+}
+
+/*****Sim_UDP_VidFlush
+**@param[in] flush_mode BL_TRANSPORT_FLUSH_NO_WAIT or BL_TRANSPORT_FLUSH_WAIT
+**/
+static void Sim_UDP_VidFlush(uint8 flush_mode)
+{
+	/****** sendto returns after the datagram is queued , both modes are the same ****/
+	(void)flush_mode;
+	if((Sim_Udp_Tx_Len > 0U) && (0U != Sim_Udp_Peer_Valid)){
+		(void)sendto(Sim_Udp_Fd , Sim_Udp_Tx_Buf , Sim_Udp_Tx_Len , 0 , (struct sockaddr *)&Sim_Udp_Peer , sizeof(Sim_Udp_Peer));
+	}
+	Sim_Udp_Tx_Len = 0U;
+}
+
+/*****Sim_UDP_VidPoll
+**@description waits up to 1 ms for a datagram
+**/
+static void Sim_UDP_VidPoll(void)
+{
+	struct pollfd loc_pfd = {Sim_Udp_Fd , POLLIN , 0};
+	(void)poll(&loc_pfd , 1U , SIM_UDP_POLL_TIMEOUT_MS);
+}
+
+/*****Sim_UDP_uint16MaxFrameSize
+**@return biggest frame (without marker) that fits one datagram
+**/
+static uint16 Sim_UDP_uint16MaxFrameSize(void)
+{
+	return (uint16)(BL_TRANSPORT_UDP_MAX_PAYLOAD - BL_TRANSPORT_FRAME_SOF_LEN);
+}
+
+/*****Sim_UDP_VidDeInit
+**@description sends the last reply , socket stays open for the jump report
+**/
+static void Sim_UDP_VidDeInit(void)
+{
+	Sim_UDP_VidFlush(BL_TRANSPORT_FLUSH_WAIT);
+}
+
+/*****Sim_UDP_VidRxFill
+**@description moves pending datagrams into the ring while a whole datagram fits (never blocks)
+**/
+static void Sim_UDP_VidRxFill(void)
+{
+	uint8 loc_datagram[BL_TRANSPORT_UDP_MAX_PAYLOAD];
+	struct sockaddr_in loc_from;
+	socklen_t loc_from_len = sizeof(loc_from);
+	uint16 loc_free = (uint16)(SIM_UDP_RX_RING_LENGTH - 1U - BL_Transport_uint16RxAvailable(&Sim_Udp_Rx_Ring));
+	uint16 loc_first_part = 0U;
+	ssize_t loc_read = 0;
+
+	/****** a datagram that does not fit stays in the socket , like a descriptor on target ****/
+	while(loc_free >= BL_TRANSPORT_UDP_MAX_PAYLOAD)
+	{
+		loc_read = recvfrom(Sim_Udp_Fd , loc_datagram , sizeof(loc_datagram) , 0 , (struct sockaddr *)&loc_from , &loc_from_len);
+		if(loc_read <= 0){
+			break;
+		}
+		Sim_Udp_Peer = loc_from;
+		Sim_Udp_Peer_Valid = 1U;
+		loc_first_part = (uint16)(SIM_UDP_RX_RING_LENGTH - Sim_Udp_Rx_Ring.Head);
+		if((uint16)loc_read <= loc_first_part){
+			memcpy(&Sim_Udp_Rx_Buf[Sim_Udp_Rx_Ring.Head] , loc_datagram , (size_t)loc_read);
+		}else{
+			memcpy(&Sim_Udp_Rx_Buf[Sim_Udp_Rx_Ring.Head] , loc_datagram , loc_first_part);
+			memcpy(&Sim_Udp_Rx_Buf[0U] , &loc_datagram[loc_first_part] , (size_t)loc_read - loc_first_part);
+		}
+		Sim_Udp_Rx_Ring.Head = (uint16)((Sim_Udp_Rx_Ring.Head + (uint16)loc_read) % SIM_UDP_RX_RING_LENGTH);
+		loc_free = (uint16)(loc_free - (uint16)loc_read);
+		Sim_Udp_Last_Rx_Tick = HAL_GetTick();
+		loc_from_len = sizeof(loc_from);
+	}
+}
@@ -0,0 +1,21 @@
+/// \file usart.h
+/// \author mahmoud Ramadan(Owner)
+/// \date 2026-10-17
+/// \brief Host build : stands in for Core/Inc/usart.h , debug UART output goes to stderr
+
+#ifndef __USART_H__
+#define __USART_H__
+/************** Global Includes**************/
+#include "main.h"
+
+/*********** Data Type Declerations*****/
+typedef struct{
+	int Fd;						// host file descriptor
+}UART_HandleTypeDef;
+
+extern UART_HandleTypeDef huart2;
+
+/********* Software Function Prototype*******/
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart , const uint8_t *pData , uint16_t Size , uint32_t Timeout);
+
+#endif /* __USART_H__ */
@@ -0,0 +1,54 @@
+''' Frame CRC of Host.py against the bit by bit reference: same results, time per MB '''
+import os
+import sys
+import types
+from time import time
+
+# Host.py opens the serial port at import, only its definitions are loaded here
+Host_Source = open(os.path.join(os.path.dirname(os.path.abspath(__file__)), 'Host.py')).read()
+Host_Source = Host_Source[:Host_Source.index('SerialPortName = input')]
+sys.modules.setdefault('serial', types.ModuleType('serial'))
+exec(Host_Source)
+
+BENCHMARK_SIZES   = [1, 3, 4, 17, 255, 1024, 4096]   # bytes, results compared for every size
+REFERENCE_SIZE    = 8 * 1024                          # the bit loop never masks its value, it slows down as the buffer grows
+TABLE_SIZE        = 1024 * 1024
+
+def Time_Per_MB(Function, Buffer):
+    Start = time()
+    Function(Buffer, len(Buffer))
+    return (time() - Start) * (1024 * 1024) / len(Buffer)
+
+def Check_Results():
+    Passed = 1
+    for Size in BENCHMARK_SIZES:
+        Buffer = bytearray(os.urandom(Size))
+        Expected = Calculate_CRC32_Reference(Buffer, Size)
+        Results = [Calculate_CRC32_Table(Buffer, Size)]
+        if(zlib is not None):
+            Results.append(Calculate_CRC32_Native(Buffer, Size))
+        if(any(Result != Expected for Result in Results)):
+            print("   Size {0} : reference 0x{1:08X} , got {2}".format(Size, Expected, ["0x%08X" % Result for Result in Results]))
+            Passed = 0
+    # Buffer_Length shorter than the buffer, as the frame builders call it
+    Buffer = bytearray(os.urandom(64))
+    if(Calculate_CRC32_Table(Buffer, 60) != Calculate_CRC32_Reference(Buffer, 60)):
+        Passed = 0
+    if(zlib is not None and Calculate_CRC32_Native(Buffer, 60) != Calculate_CRC32_Reference(Buffer, 60)):
+        Passed = 0
+    return Passed
+
+if(Check_Results()):
+    print("Results identical to the reference bit loop")
+else:
+    print("Results differ from the reference bit loop !!")
+    sys.exit(1)
+
+Reference_Time = Time_Per_MB(Calculate_CRC32_Reference, bytearray(os.urandom(REFERENCE_SIZE)))
+Buffer = bytearray(os.urandom(TABLE_SIZE))
+print("   Reference bit loop : {0:9.3f} s/MB".format(Reference_Time))
+Table_Time = Time_Per_MB(Calculate_CRC32_Table, Buffer)
+print("   Table (slicing 4)  : {0:9.3f} s/MB , {1:7.1f} times faster".format(Table_Time, Reference_Time / Table_Time))
+if(zlib is not None):
+    Native_Time = Time_Per_MB(Calculate_CRC32_Native, Buffer)
+    print("   zlib               : {0:9.3f} s/MB , {1:7.1f} times faster".format(Native_Time, Reference_Time / Native_Time))
@@ -1,8 +1,16 @@
 import serial
+import socket
 import struct
 import os
 import sys
-from time import sleep
+import re
+try:
+    import zlib
+except ImportError:
+    zlib = None            # minimal Python builds, table driven CRC only
+import hashlib
+import hmac
+from time import sleep, time
 
 ''' Bootloader Commands '''
 CBL_GET_HELP_CMD				= 0x00
@@ -11,6 +19,15 @@ CBL_GET_ID_CMD       			= 0x02
 CBL_READ_MEMORY_CMD 			= 0x11
 CBL_GO_TO_ADDR_CMD  			= 0x21
 CBL_WRITE_MEMORY_CMD   			= 0x31
+CBL_WINDOW_WRITE_MEMORY_CMD		= 0x32
+CBL_CHANGE_BAUD_RATE_CMD		= 0x33
+CBL_SET_FRAME_MODE_CMD			= 0x34
+CBL_BATCH_CMD       			= 0x35
+CBL_SET_CRC_MODE_CMD			= 0x36
+CBL_SESSION_DIGEST_CMD			= 0x37
+CBL_IMAGE_VERIFY_CMD			= 0x38
+CBL_SET_WRITE_MODE_CMD			= 0x39
+CBL_IMAGE_MANIFEST_CMD			= 0x3A
 CBL_ERASE_CMD  				    = 0x43
 CBL_EXTENDED_ERASE_CMD		    = 0x44
 CBL_SPECIAL_CMD     			= 0x50
@@ -20,6 +37,9 @@ CBL_WRITE_UNPROTECT_CMD 		= 0x73
 CBL_READOUT_PROTECT_CMD	    	= 0x82
 CBL_READOUT_UNPROTECT_CMD		= 0x92
 CBL_CHECK_SUM_CMD			    = 0xA1
+
+''' Start of frame marker, the bootloader resynchronizes on it after a broken frame '''
+CBL_FRAME_SOF                   = 0xA5
   
 INVALID_SECTOR_NUMBER   = 0x00
 VALID_SECTOR_NUMBER     = 0x01
@@ -29,8 +49,90 @@ SUCCESSFUL_ERASE        = 0x03
 FLASH_PAYLOAD_WRITE_FAILED  = 0x00
 FLASH_PAYLOAD_WRITE_PASSED  = 0x01
 
+''' Windowed (pipelined) memory write '''
+WINDOW_WRITE_STATUS_FAIL    = 0x00
+WINDOW_WRITE_STATUS_ACK     = 0x01
+WINDOW_WRITE_STATUS_RESEND  = 0x02
+WINDOW_WRITE_FRAMES         = 4      # frames in flight, bootloader RX ring holds max 6 (BL_WINDOW_WRITE_MAX_FRAMES)
+WINDOW_WRITE_PAYLOAD        = 128    # payload bytes per legacy frame
+WINDOW_WRITE_FRAMES_EXT     = 3      # extended frames in flight (16 KB bootloader RX ring)
+WINDOW_WRITE_PAYLOAD_EXT    = 4096   # payload bytes per extended frame (BL_HOST_MAX_PAYLOAD_LENGTH)
+
+''' Frame modes '''
+FRAME_MODE_LEGACY           = 0x00   # len(1) | packet
+FRAME_MODE_EXTENDED         = 0x01   # 0x00 | len(2, LE) | packet
+WINDOW_WRITE_TIMEOUT        = 3.0    # seconds without any reply before going back to oldest frame (first write erases a 256 KB sector)
+
+''' Batch frames: several sub commands per round trip, one status byte per sub command '''
+BATCH_OP_ERASE              = 0x01   # sector | number of sectors
+BATCH_OP_WRITE              = 0x02   # address (LE) | len (2, LE) | data
+BATCH_OP_CHECK_SUM          = 0x03   # address (LE) | len (4, LE) | crc32 (LE)
+BATCH_OP_GO                 = 0x04   # address (LE), last op of a frame
+BATCH_STATUS_NAMES          = {0x00: "failed", 0x01: "passed", 0x02: "invalid", 0x03: "skipped"}
+BATCH_MAX_OPS               = 64     # BL_BATCH_MAX_OPS
+BATCH_FRAME_OVERHEAD        = 9      # extended header | cmd | op count | crc32
+BATCH_REPLY_TIMEOUT         = 10.0   # a batch may erase several 256 KB sectors
+FLASH_SECTORS               = [(0x08000000, 0x8000), (0x08008000, 0x8000), (0x08010000, 0x8000), (0x08018000, 0x8000),
+                               (0x08020000, 0x20000), (0x08040000, 0x40000), (0x08080000, 0x40000), (0x080C0000, 0x40000)]
+
+''' Frame CRC convention, same poly 0x04C11DB7 and init 0xFFFFFFFF '''
+CRC_MODE_LEGACY             = 0x00   # every byte fed as a 32 bit word (zlib on reordered bits, or tables)
+CRC_MODE_STANDARD           = 0x01   # CRC-32 of zlib, word wide on the bootloader CRC unit
+CRC_MODE_TIMEOUT            = 0.5    # older bootloaders don't answer the request
+
+''' Device side check sum: one CRC per (address, length) range, same convention as the frame CRC '''
+CHECK_SUM_MAX_RANGES        = 31     # BL_CHECK_SUM_MAX_RANGES, ranges of one frame
+CHECK_SUM_TIMEOUT           = 2.0    # 1 MB takes a few ms on the bootloader
+
+''' Application image header, verified with SHA-256 by the bootloader before it starts the application '''
+APPLICATION_BASE_ADDRESS    = 0x08008000   # FLASH_SECTOR1_BASE_ADDRESS
+IMAGE_HEADER_ADDRESS        = 0x080C0000   # BL_IMAGE_HEADER_ADDRESS, sector 7
+IMAGE_HEADER_SECTOR         = 7
+IMAGE_MAGIC                 = 0x474D4942   # "BIMG"
+IMAGE_VALID                 = 0x01
+IMAGE_VERIFY_TIMEOUT        = 2.0
+HCLK_FREQUENCY              = 216000000    # cycles reported by the bootloader
+
+''' Chunked image: Merkle root over SHA-256 of every chunk, header authenticated with HMAC-SHA256 '''
+IMAGE_MAGIC_MERKLE          = 0x474D494D   # "MIMG"
+MAC_KEY_LEN                 = 32     # BL_HASH_HMAC_KEY_LEN
+MANIFEST_PART_HEADER        = 0x00
+MANIFEST_PART_LEAVES        = 0x01
+MANIFEST_STATUS_NAMES       = {0x00: "rejected", 0x01: "pending", 0x02: "active"}
+MANIFEST_ACTIVE             = 0x02
+MERKLE_MAX_LEAVES           = 1024   # BL_MERKLE_MAX_LEAVES
+MERKLE_MIN_CHUNK            = 64     # BL_MERKLE_MIN_CHUNK
+
+''' Encrypted write session: AES-128 CTR, the block at flash address A uses counter A / 16 after the nonce '''
+WRITE_MODE_PLAIN            = 0x00
+WRITE_MODE_AES_CTR          = 0x01
+WRITE_MODE_TIMEOUT          = 0.5    # older bootloaders don't answer the request
+AES_KEY_LEN                 = 16     # BL_AES_KEY_LEN
+AES_NONCE_LEN               = 12     # BL_AES_NONCE_LEN
+AES_SBOX                    = bytes.fromhex(
+    '637c777bf26b6fc53001672bfed7ab76ca82c97dfa5947f0add4a2af9ca472c0b7fd9326363ff7cc34a5e5f171d8311504c723c31896059a071280e2eb27b275'
+    '09832c1a1b6e5aa0523bd6b329e32f8453d100ed20fcb15b6acbbe394a4c58cfd0efaafb434d338545f9027f503c9fa851a3408f929d38f5bcb6da2110fff3d2'
+    'cd0c13ec5f974417c4a77e3d645d197360814fdc222a908846eeb814de5e0bdbe0323a0a4906245cc2d3ac629195e479e7c8376d8dd54ea96c56f4ea657aae08'
+    'ba78252e1ca6b4c6e8dd741f4bbd8b8a703eb5664803f60e613557b986c11d9ee1f8981169d98e949b1e87e9ce5528df8ca1890dbfe6426841992d0fb054bb16')
+
+''' Baud rate negotiation '''
+BAUD_CHANGE_REJECTED        = 0x00
+BAUD_CHANGE_ACCEPTED        = 0x01
+BAUD_CHANGE_CONFIRMED       = 0x02
+BAUD_CONFIRM_TIMEOUT        = 0.5    # bootloader falls back to the old rate after this time (BL_BAUD_CONFIRM_TIMEOUT_MS)
+AUTO_BAUD_SYNC_BYTE         = 0x7F   # measured by the USART auto baud hardware on bootloader entry
+AUTO_BAUD_SYNC_ACK          = 0x79
+BAUD_RATE_CANDIDATES        = [6000000, 4000000, 3000000, 2000000, 1000000, 921600, 460800, 230400]
+
+''' Ethernet link (port name "udp:<ip>[:port]") '''
+UDP_DEFAULT_PORT            = 6000   # BL_TRANSPORT_UDP_PORT
+UDP_MAX_PAYLOAD             = 1472   # one datagram, no IP fragments (BL_TRANSPORT_UDP_MAX_PAYLOAD)
+
 verbose_mode = 1
+Host_Baud_Rate = 115200    # any rate the USB/serial adapter supports, the bootloader detects it
 Memory_Write_Active = 0
+Crc_Mode = CRC_MODE_LEGACY
+Write_Nonce = None         # nonce of the encrypted write session, None for plain payloads
 
 def Check_Serial_Ports():
     Serial_Ports = []
@@ -50,10 +152,66 @@ def Check_Serial_Ports():
     
     return Serial_Ports
 
+class Udp_Link:
+    ''' Bootloader Ethernet link with the subset of the serial.Serial interface this script uses '''
+    def __init__(self, Address, Port, timeout):
+        self.Socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.Peer = (Address, Port)
+        self.timeout = timeout
+        self.baudrate = 0            # no line rate, baud rate change is rejected by the bootloader
+        self.is_open = True
+        self.Tx_Pending = bytearray()
+        self.Rx_Pending = bytearray()
+
+    def write(self, Data):
+        ''' single bytes of a command are gathered, a whole frame leaves as one datagram '''
+        self.Tx_Pending += Data
+        if(len(Data) > 1):
+            self.flush()
+
+    def flush(self):
+        while(len(self.Tx_Pending) > 0):
+            self.Socket.sendto(bytes(self.Tx_Pending[:UDP_MAX_PAYLOAD]), self.Peer)
+            del self.Tx_Pending[:UDP_MAX_PAYLOAD]
+
+    def read(self, Data_Len):
+        self.flush()
+        End_Time = time() + self.timeout
+        while(len(self.Rx_Pending) < Data_Len):
+            Time_Left = End_Time - time()
+            if(Time_Left <= 0):
+                break
+            self.Socket.settimeout(Time_Left)
+            try:
+                self.Rx_Pending += self.Socket.recv(65535)
+            except socket.timeout:
+                break
+        Data = bytes(self.Rx_Pending[:Data_Len])
+        del self.Rx_Pending[:Data_Len]
+        return Data
+
+    def reset_input_buffer(self):
+        self.Rx_Pending = bytearray()
+        self.Socket.setblocking(False)
+        try:
+            while True:
+                self.Socket.recv(65535)
+        except (BlockingIOError, socket.error):
+            pass
+        self.Socket.setblocking(True)
+
+def Udp_Link_Configuration(Port_Name):
+    ''' "udp:192.168.0.10" or "udp:192.168.0.10:6000" '''
+    global Serial_Port_Obj
+    Fields = Port_Name.split(':')
+    Port = int(Fields[2]) if (len(Fields) > 2) else UDP_DEFAULT_PORT
+    Serial_Port_Obj = Udp_Link(Fields[1], Port, 2)
+    print("Bootloader link : UDP", Fields[1], "port", Port, "\n")
+
 def Serial_Port_Configuration(Port_Number):
     global Serial_Port_Obj
     try:
-        Serial_Port_Obj = serial.Serial(Port_Number, 115200, timeout = 2)
+        Serial_Port_Obj = serial.Serial(Port_Number, Host_Baud_Rate, timeout = 2)
     except:
         print("\nError !! That was not a valid port")
     
@@ -70,6 +228,19 @@ def Serial_Port_Configuration(Port_Number):
     else:
         print("Port Open Failed \n")
 
+def Auto_Baud_Sync():
+    ''' First byte of a session lets the bootloader detect our baud rate '''
+    Default_Timeout = Serial_Port_Obj.timeout
+    Serial_Port_Obj.timeout = 0.2
+    Serial_Port_Obj.reset_input_buffer()
+    Serial_Port_Obj.write(bytes([AUTO_BAUD_SYNC_BYTE]))
+    Sync_Reply = Serial_Port_Obj.read(1)
+    Serial_Port_Obj.timeout = Default_Timeout
+    if(len(Sync_Reply) and (Sync_Reply[0] == AUTO_BAUD_SYNC_ACK)):
+        print("Bootloader synchronized at", Serial_Port_Obj.baudrate, "baud \n")
+    else:
+        print("No sync reply, bootloader already synchronized or running at its default rate \n")
+
 def Write_Data_To_Serial_Port(Value, Length):
     # Validate the input value
     _data = struct.pack('>B', Value)
@@ -224,16 +395,79 @@ def Process_CBL_CHANGE_ROP_Level_CMD(Data_Len):
         else:
             print("\n   ROP Level -> Unknown Error")
 
-def Calculate_CRC32(Buffer, Buffer_Length): 
-  CRC_Value = 0xFFFFFFFF
-  for DataElem in Buffer[0:Buffer_Length]:
+def Crc32_Word_Clock(Value):
+    ''' 32 shifts of the bootloader CRC unit (poly 0x04C11DB7, MSB first), one word fed '''
+    for Bit in range(32):
+        if (Value & 0x80000000):
+            Value = ((Value << 1) ^ 0x04C11DB7) & 0xFFFFFFFF
+        else:
+            Value = (Value << 1) & 0xFFFFFFFF
+    return Value
+
+def Crc32_Tables():
+    ''' Slicing by 4 of one word: the 32 shifts are linear, each byte lane of the word gets its own table '''
+    T0 = [Crc32_Word_Clock(Value) for Value in range(256)]
+    T1 = [Crc32_Word_Clock(Value << 8) for Value in range(256)]
+    T2 = [Crc32_Word_Clock(Value << 16) for Value in range(256)]
+    T3 = [Crc32_Word_Clock(Value << 24) for Value in range(256)]
+    Reflected = []
+    for Value in range(256):
+        for Bit in range(8):
+            Value = (Value >> 1) ^ (0xEDB88320 if Value & 1 else 0)
+        Reflected.append(Value)
+    return (T0, T1, T2, T3, Reflected)
+
+CRC32_TABLES = Crc32_Tables()
+CRC32_BIT_REVERSE = bytes(int('{:08b}'.format(Value)[::-1], 2) for Value in range(256))
+
+def Calculate_CRC32_Reference(Buffer, Buffer_Length):
+    ''' Bit by bit legacy CRC, kept as reference for Crc_Benchmark.py '''
+    CRC_Value = 0xFFFFFFFF
+    for DataElem in Buffer[0:Buffer_Length]:
+          CRC_Value = CRC_Value ^ DataElem
+          for DataElemBitLen in range(32):
+              if (CRC_Value & 0x80000000):
+                  CRC_Value = (CRC_Value << 1) ^ 0x04C11DB7
+              else:
+                  CRC_Value = (CRC_Value << 1)
+    return CRC_Value & 0xFFFFFFFF
+
+def Calculate_CRC32_Table(Buffer, Buffer_Length):
+    ''' Legacy CRC, four table lookups per byte instead of 32 shifts '''
+    T0, T1, T2, T3 = CRC32_TABLES[0:4]
+    CRC_Value = 0xFFFFFFFF
+    for DataElem in Buffer[0:Buffer_Length]:
         CRC_Value = CRC_Value ^ DataElem
-        for DataElemBitLen in range(32):
-            if (CRC_Value & 0x80000000):
-                CRC_Value = (CRC_Value << 1) ^ 0x04C11DB7
-            else:
-                CRC_Value = (CRC_Value << 1)
-  return CRC_Value
+        CRC_Value = T3[CRC_Value >> 24] ^ T2[(CRC_Value >> 16) & 0xFF] ^ T1[(CRC_Value >> 8) & 0xFF] ^ T0[CRC_Value & 0xFF]
+    return CRC_Value
+
+def Calculate_CRC32_Native(Buffer, Buffer_Length):
+    ''' Legacy CRC through zlib: the bytes become words 00 00 00 b, a reflected CRC of the bit reversed
+        stream is the bit reversed MSB first CRC (same init, zlib adds a final xor) '''
+    Data = bytes(Buffer[0:Buffer_Length])
+    Words = bytearray(4 * len(Data))
+    Words[3::4] = Data.translate(CRC32_BIT_REVERSE)
+    CRC_Value = zlib.crc32(Words) ^ 0xFFFFFFFF
+    return int('{:032b}'.format(CRC_Value)[::-1], 2)
+
+def Calculate_CRC32_Standard_Table(Buffer, Buffer_Length):
+    ''' CRC-32 of zlib for Python builds without it '''
+    Reflected = CRC32_TABLES[4]
+    CRC_Value = 0xFFFFFFFF
+    for DataElem in Buffer[0:Buffer_Length]:
+        CRC_Value = (CRC_Value >> 8) ^ Reflected[(CRC_Value ^ DataElem) & 0xFF]
+    return CRC_Value ^ 0xFFFFFFFF
+
+def Calculate_CRC32(Buffer, Buffer_Length, Mode=None): 
+  if(Mode is None):
+      Mode = Crc_Mode
+  if(Mode == CRC_MODE_STANDARD):
+      if(zlib is None):
+          return Calculate_CRC32_Standard_Table(Buffer, Buffer_Length)
+      return zlib.crc32(bytes(Buffer[0:Buffer_Length]))
+  if(zlib is None):
+      return Calculate_CRC32_Table(Buffer, Buffer_Length)
+  return Calculate_CRC32_Native(Buffer, Buffer_Length)
 
 def Word_Value_To_Byte_Value(Word_Value, Byte_Index, Byte_Lower_First):
     Byte_Value = (Word_Value >> (8 * (Byte_Index - 1)) & 0x000000FF)
@@ -247,6 +481,512 @@ def OpenBinFile():
     global BinFile
     BinFile = open('Application.bin', 'rb')
 
+def Aes_Tables():
+    ''' Encryption T-tables of AES (SubBytes, ShiftRows and MixColumns of one byte as a column) '''
+    Te0 = []
+    for Value in AES_SBOX:
+        Double = ((Value << 1) ^ (0x1B if Value & 0x80 else 0)) & 0xFF
+        Te0.append((Double << 24) | (Value << 16) | (Value << 8) | (Double ^ Value))
+    Te1 = [((Word >> 8) | (Word << 24)) & 0xFFFFFFFF for Word in Te0]
+    Te2 = [((Word >> 16) | (Word << 16)) & 0xFFFFFFFF for Word in Te0]
+    Te3 = [((Word >> 24) | (Word << 8)) & 0xFFFFFFFF for Word in Te0]
+    return (Te0, Te1, Te2, Te3)
+
+def Aes_Expand_Key(Key):
+    ''' 44 round key words of AES-128 '''
+    Words = list(struct.unpack('>IIII', Key))
+    Rcon = 1
+    for Index in range(4, 44):
+        Temp = Words[Index - 1]
+        if(Index % 4 == 0):
+            Temp = ((AES_SBOX[(Temp >> 16) & 0xFF] << 24) | (AES_SBOX[(Temp >> 8) & 0xFF] << 16) |
+                    (AES_SBOX[Temp & 0xFF] << 8) | AES_SBOX[Temp >> 24]) ^ (Rcon << 24)
+            Rcon = ((Rcon << 1) ^ (0x1B if Rcon & 0x80 else 0)) & 0xFF
+        Words.append(Words[Index - 4] ^ Temp)
+    return Words
+
+def Read_Key_File(Key_Name, Key_Length):
+    ''' Bytes of "#define Key_Name {0x..U , ...}" in the product key file of the bootloader build,
+        "--keys <file>" on the command line selects another file than bootloader/bl_keys.h '''
+    Key_File = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'bootloader-STM32F756ZG', 'bootloader', 'bl_keys.h')
+    if('--keys' in sys.argv[1:-1]):
+        Key_File = sys.argv[sys.argv.index('--keys') + 1]
+    try:
+        with open(Key_File) as Key_Text:
+            Key_Match = re.search(r'#define\s+' + Key_Name + r'\s+\{([^}]*)\}', Key_Text.read())
+    except OSError:
+        sys.exit("Key file {0} not found, see bootloader/bl_keys_template.h".format(Key_File))
+    Key = bytes(int(Key_Byte, 16) for Key_Byte in re.findall(r'0x([0-9A-Fa-f]{1,2})', Key_Match.group(1))) if Key_Match else b''
+    if(len(Key) != Key_Length):
+        sys.exit("Key file {0} holds no {1} of {2} bytes".format(Key_File, Key_Name, Key_Length))
+    return Key
+
+IMAGE_AES_KEY = Read_Key_File('BL_AES_KEY', AES_KEY_LEN)
+IMAGE_MAC_KEY = Read_Key_File('BL_MERKLE_MAC_KEY', MAC_KEY_LEN)
+AES_TABLES = Aes_Tables()
+AES_ROUND_KEYS = Aes_Expand_Key(IMAGE_AES_KEY)
+
+def Aes_Encrypt_Block(Block):
+    ''' AES-128 of one 16 byte block with IMAGE_AES_KEY '''
+    Te0, Te1, Te2, Te3 = AES_TABLES
+    Rk = AES_ROUND_KEYS
+    S0, S1, S2, S3 = struct.unpack('>IIII', Block)
+    S0, S1, S2, S3 = S0 ^ Rk[0], S1 ^ Rk[1], S2 ^ Rk[2], S3 ^ Rk[3]
+    for Round in range(1, 10):
+        K = 4 * Round
+        S0, S1, S2, S3 = (Te0[S0 >> 24] ^ Te1[(S1 >> 16) & 0xFF] ^ Te2[(S2 >> 8) & 0xFF] ^ Te3[S3 & 0xFF] ^ Rk[K],
+                          Te0[S1 >> 24] ^ Te1[(S2 >> 16) & 0xFF] ^ Te2[(S3 >> 8) & 0xFF] ^ Te3[S0 & 0xFF] ^ Rk[K + 1],
+                          Te0[S2 >> 24] ^ Te1[(S3 >> 16) & 0xFF] ^ Te2[(S0 >> 8) & 0xFF] ^ Te3[S1 & 0xFF] ^ Rk[K + 2],
+                          Te0[S3 >> 24] ^ Te1[(S0 >> 16) & 0xFF] ^ Te2[(S1 >> 8) & 0xFF] ^ Te3[S2 & 0xFF] ^ Rk[K + 3])
+    State = (S0, S1, S2, S3)
+    Output = bytearray(16)
+    for Column in range(4):
+        Output[4 * Column + 0] = AES_SBOX[State[Column] >> 24]
+        Output[4 * Column + 1] = AES_SBOX[(State[(Column + 1) % 4] >> 16) & 0xFF]
+        Output[4 * Column + 2] = AES_SBOX[(State[(Column + 2) % 4] >> 8) & 0xFF]
+        Output[4 * Column + 3] = AES_SBOX[State[(Column + 3) % 4] & 0xFF]
+    return bytes(Output[Index] ^ ((Rk[40 + Index // 4] >> (24 - 8 * (Index % 4))) & 0xFF) for Index in range(16))
+
+def Write_Payload(Address, Payload):
+    ''' Payload as sent on the link, AES-CTR encrypted in an encrypted write session '''
+    if(Write_Nonce is None):
+        return Payload
+    Offset = Address % 16
+    Key_Stream = b''.join(Aes_Encrypt_Block(Write_Nonce + struct.pack('>I', Counter))
+                          for Counter in range(Address // 16, (Address + len(Payload) + 15) // 16))
+    return bytes(Data ^ Key for Data, Key in zip(Payload, Key_Stream[Offset:]))
+
+def Set_Write_Mode(Mode):
+    ''' Start (new random nonce) or end an encrypted write session, returns the accepted mode '''
+    global Write_Nonce
+    Nonce = os.urandom(AES_NONCE_LEN)
+    Frame = bytearray([7 + AES_NONCE_LEN - 1, CBL_SET_WRITE_MODE_CMD, Mode]) + Nonce
+    CRC32_Value = Calculate_CRC32(Frame, len(Frame)) & 0xFFFFFFFF
+    Default_Timeout = Serial_Port_Obj.timeout
+    Serial_Port_Obj.timeout = WRITE_MODE_TIMEOUT
+    Serial_Port_Obj.write(bytes([CBL_FRAME_SOF]) + bytes(Frame + struct.pack('<I', CRC32_Value)))
+    BL_ACK = Serial_Port_Obj.read(2)
+    Serial_Data = Serial_Port_Obj.read(BL_ACK[1]) if ((len(BL_ACK) == 2) and (BL_ACK[0] == 0x79)) else b''
+    Serial_Port_Obj.timeout = Default_Timeout
+    if(len(Serial_Data) != 1):
+        Serial_Port_Obj.reset_input_buffer()
+        Write_Nonce = None
+        return WRITE_MODE_PLAIN
+    Write_Nonce = Nonce if (Serial_Data[0] == WRITE_MODE_AES_CTR) else None
+    return Serial_Data[0]
+
+def Ask_Encrypted_Write():
+    ''' Encrypt the payloads on the link if the user wants it and the bootloader supports it '''
+    if(input("\n   Encrypt the payloads on the link (y/n) : ").strip().lower() == 'y'):
+        if(Set_Write_Mode(WRITE_MODE_AES_CTR) == WRITE_MODE_AES_CTR):
+            print("   Payloads are sent AES-128 CTR encrypted")
+        else:
+            print("   Encrypted write not supported by the bootloader, sending plain payloads")
+
+def Build_Window_Write_Frame(Seq, Address, Payload, Extended = 0):
+    ''' header | cmd | seq (LE) | address (LE) | payload len | payload | crc32 (LE) '''
+    Payload = Write_Payload(Address, Payload)
+    if(Extended):
+        ''' 0x00 | len (2, LE) header and 2 bytes payload length '''
+        Frame = bytearray(3) + bytearray([CBL_WINDOW_WRITE_MEMORY_CMD]) + struct.pack('<HIH', Seq, Address, len(Payload)) + Payload
+        Frame[1:3] = struct.pack('<H', len(Frame) + 4 - 3)
+    else:
+        Frame = bytearray([len(Payload) + 12, CBL_WINDOW_WRITE_MEMORY_CMD]) + struct.pack('<HIB', Seq, Address, len(Payload)) + Payload
+    CRC32_Value = Calculate_CRC32(Frame, len(Frame)) & 0xFFFFFFFF
+    return bytes([CBL_FRAME_SOF]) + bytes(Frame + struct.pack('<I', CRC32_Value))
+
+def Set_Frame_Mode(Frame_Mode):
+    ''' returns (accepted mode, max frame size) or None '''
+    Frame = bytearray([7 - 1, CBL_SET_FRAME_MODE_CMD, Frame_Mode])
+    CRC32_Value = Calculate_CRC32(Frame, len(Frame)) & 0xFFFFFFFF
+    Serial_Port_Obj.write(bytes([CBL_FRAME_SOF]) + bytes(Frame + struct.pack('<I', CRC32_Value)))
+    BL_ACK = Serial_Port_Obj.read(2)
+    if((len(BL_ACK) < 2) or (BL_ACK[0] != 0x79)):
+        return None
+    Serial_Data = Serial_Port_Obj.read(BL_ACK[1])
+    if(len(Serial_Data) < 3):
+        return None
+    return (Serial_Data[0], Serial_Data[1] | (Serial_Data[2] << 8))
+
+def Set_Crc_Mode(Mode):
+    ''' Switch the frame CRC convention of both sides, returns the accepted mode.
+        A bootloader an earlier session left in the other convention rejects the frame,
+        it is sent once more with the other CRC '''
+    global Crc_Mode
+    Frame = bytearray([7 - 1, CBL_SET_CRC_MODE_CMD, Mode])
+    Other_Mode = CRC_MODE_LEGACY if (Crc_Mode == CRC_MODE_STANDARD) else CRC_MODE_STANDARD
+    Default_Timeout = Serial_Port_Obj.timeout
+    Serial_Port_Obj.timeout = CRC_MODE_TIMEOUT
+    for Frame_Crc_Mode in (Crc_Mode, Other_Mode):
+        CRC32_Value = Calculate_CRC32(Frame, len(Frame), Frame_Crc_Mode) & 0xFFFFFFFF
+        Serial_Port_Obj.write(bytes([CBL_FRAME_SOF]) + bytes(Frame + struct.pack('<I', CRC32_Value)))
+        BL_ACK = Serial_Port_Obj.read(2)
+        Serial_Data = Serial_Port_Obj.read(BL_ACK[1]) if ((len(BL_ACK) == 2) and (BL_ACK[0] == 0x79)) else b''
+        if(len(Serial_Data) == 1):
+            Crc_Mode = Serial_Data[0]
+            break
+        Serial_Port_Obj.reset_input_buffer()
+    Serial_Port_Obj.timeout = Default_Timeout
+    return Crc_Mode
+
+def Read_Window_Write_Reply():
+    ''' returns (status, expected sequence), 'NACK' for a dropped frame or None on timeout '''
+    BL_ACK = Serial_Port_Obj.read(1)
+    if(len(BL_ACK) < 1):
+        return None
+    if(BL_ACK[0] != 0x79):
+        return 'NACK'
+    BL_ACK = BL_ACK + Serial_Port_Obj.read(1)
+    if(len(BL_ACK) < 2):
+        return None
+    Serial_Data = Serial_Port_Obj.read(BL_ACK[1])
+    if(len(Serial_Data) < 3):
+        return None
+    return (Serial_Data[0], Serial_Data[1] | (Serial_Data[2] << 8))
+
+def Window_Write_Bin_File(BaseMemoryAddress, File_Total_Len):
+    ''' Go back N sender, keeps WINDOW_WRITE_FRAMES frames in flight and slides on cumulative ACKs '''
+    Frames = []
+    ''' Large frames cut the per frame overhead, older bootloaders don't answer the request '''
+    Frame_Mode = Set_Frame_Mode(FRAME_MODE_EXTENDED)
+    if((Frame_Mode is not None) and (Frame_Mode[0] == FRAME_MODE_EXTENDED)):
+        Extended = 1
+        Window_Frames = WINDOW_WRITE_FRAMES_EXT
+        Payload_Size = min(WINDOW_WRITE_PAYLOAD_EXT, Frame_Mode[1] - 16)
+    else:
+        Serial_Port_Obj.reset_input_buffer()
+        Extended = 0
+        Window_Frames = WINDOW_WRITE_FRAMES
+        Payload_Size = WINDOW_WRITE_PAYLOAD
+    print("   Writing with", Payload_Size, "bytes per frame,", Window_Frames, "frames in flight")
+    OpenBinFile()
+    for Offset in range(0, File_Total_Len, Payload_Size):
+        Payload = BinFile.read(Payload_Size)
+        Frames.append(Build_Window_Write_Frame(len(Frames), BaseMemoryAddress + Offset, Payload, Extended))
+    BinFile.close()
+    if(len(Frames) > 0xFFFF):
+        print("\n   Error !! Binary file is too large for windowed write")
+        return 0
+    Default_Timeout = Serial_Port_Obj.timeout
+    Serial_Port_Obj.timeout = WINDOW_WRITE_TIMEOUT
+    Window_Base = 0
+    Next_Seq = 0
+    Write_Status = 1
+    while(Window_Base < len(Frames)):
+        ''' Fill the window '''
+        while((Next_Seq < len(Frames)) and ((Next_Seq - Window_Base) < Window_Frames)):
+            Serial_Port_Obj.write(Frames[Next_Seq])
+            Next_Seq = Next_Seq + 1
+        ''' Slide on the next reply '''
+        Reply = Read_Window_Write_Reply()
+        if(Reply is None):
+            print("\n   Timeout !!, resending from frame", Window_Base)
+            Serial_Port_Obj.reset_input_buffer()
+            Next_Seq = Window_Base
+            continue
+        if(Reply == 'NACK'):
+            ''' broken frame dropped by the bootloader, go back without waiting for the timeout '''
+            Next_Seq = Window_Base
+            continue
+        Status, Expected_Seq = Reply
+        if(Status == WINDOW_WRITE_STATUS_ACK):
+            if(Expected_Seq > Window_Base):
+                Window_Base = Expected_Seq
+                print("\r   Bytes written by the bootloader :{0}".format(min(Window_Base * Payload_Size, File_Total_Len)), end = ' ')
+        elif(Status == WINDOW_WRITE_STATUS_RESEND):
+            if(Expected_Seq >= Window_Base):
+                Window_Base = Expected_Seq
+                Next_Seq = Expected_Seq
+        else:
+            print("\n   Write Status -> Write Failed or Invalid Address at frame", Expected_Seq)
+            Write_Status = 0
+            break
+    Serial_Port_Obj.timeout = Default_Timeout
+    return Write_Status
+
+def Check_Sum_Ranges(Ranges):
+    ''' [(address, length)] -> list of bootloader CRCs, None if refused (invalid range or NACK) '''
+    Packet = bytearray([CBL_CHECK_SUM_CMD, len(Ranges)]) + b''.join(struct.pack('<II', Address, Length) for Address, Length in Ranges)
+    Frame = bytearray([len(Packet) + 4]) + Packet
+    CRC32_Value = Calculate_CRC32(Frame, len(Frame)) & 0xFFFFFFFF
+    Default_Timeout = Serial_Port_Obj.timeout
+    Serial_Port_Obj.timeout = CHECK_SUM_TIMEOUT
+    Serial_Port_Obj.write(bytes([CBL_FRAME_SOF]) + bytes(Frame + struct.pack('<I', CRC32_Value)))
+    BL_ACK = Serial_Port_Obj.read(2)
+    Serial_Data = Serial_Port_Obj.read(BL_ACK[1]) if ((len(BL_ACK) == 2) and (BL_ACK[0] == 0x79)) else b''
+    Serial_Port_Obj.timeout = Default_Timeout
+    if(len(Serial_Data) != 4 * len(Ranges)):
+        return None
+    return list(struct.unpack('<' + 'I' * len(Ranges), Serial_Data))
+
+def Session_Digest():
+    ''' (bytes written, digest, bytes programmed) of the write session, the bootloader starts a new one. None on NACK
+        Bytes programmed leaves out what flash already held , older bootloaders do not send it (None) '''
+    Frame = bytearray([6 - 1, CBL_SESSION_DIGEST_CMD])
+    CRC32_Value = Calculate_CRC32(Frame, len(Frame)) & 0xFFFFFFFF
+    Serial_Port_Obj.write(bytes([CBL_FRAME_SOF]) + bytes(Frame + struct.pack('<I', CRC32_Value)))
+    BL_ACK = Serial_Port_Obj.read(2)
+    Serial_Data = Serial_Port_Obj.read(BL_ACK[1]) if ((len(BL_ACK) == 2) and (BL_ACK[0] == 0x79)) else b''
+    if(len(Serial_Data) == 8):
+        return struct.unpack('<II', Serial_Data) + (None,)
+    if(len(Serial_Data) != 12):
+        Serial_Port_Obj.reset_input_buffer()
+        return None
+    return struct.unpack('<III', Serial_Data)
+
+def Image_Ranges(Address, Length):
+    ''' Split an image at flash sector boundaries, a mismatch then names the sector '''
+    Ranges = []
+    for Base, Size in FLASH_SECTORS:
+        Start = max(Address, Base)
+        End = min(Address + Length, Base + Size)
+        if(Start < End):
+            Ranges.append((Start, End - Start))
+    return Ranges if Ranges else [(Address, Length)]
+
+def Verify_Bin_File(BaseMemoryAddress, File_Total_Len):
+    ''' Post write verification with one check sum round trip instead of reading the image back '''
+    OpenBinFile()
+    Image = BinFile.read(File_Total_Len)
+    BinFile.close()
+    Ranges = Image_Ranges(BaseMemoryAddress, File_Total_Len)[:CHECK_SUM_MAX_RANGES]
+    Device_Crcs = Check_Sum_Ranges(Ranges)
+    if(Device_Crcs is None):
+        print("\n   Check sum refused by the bootloader")
+        return 0
+    Verify_Status = 1
+    for (Address, Length), Device_Crc in zip(Ranges, Device_Crcs):
+        Offset = Address - BaseMemoryAddress
+        if(Device_Crc != (Calculate_CRC32(Image[Offset : Offset + Length], Length) & 0xFFFFFFFF)):
+            print("\n   Verification failed in range", hex(Address), "length", Length)
+            Verify_Status = 0
+    return Verify_Status
+
+def Build_Image_Header(BaseMemoryAddress, Image):
+    ''' magic | address | length | sha256, all words LE (Bl_Image_Header) '''
+    return struct.pack('<III', IMAGE_MAGIC, BaseMemoryAddress, len(Image)) + hashlib.sha256(Image).digest()
+
+def Merkle_Root(Leaves):
+    ''' Pairs hashed level by level, an odd last node moves up unchanged '''
+    Level = list(Leaves)
+    while(len(Level) > 1):
+        Level = [hashlib.sha256(Level[Index] + Level[Index + 1]).digest() if (Index + 1 < len(Level)) else Level[Index]
+                 for Index in range(0, len(Level), 2)]
+    return Level[0]
+
+def Build_Merkle_Header(BaseMemoryAddress, Image, Chunk_Size):
+    ''' (header, leaves): magic | address | length | root | chunk size | hmac-sha256, all words LE (Bl_Image_Header) '''
+    Leaves = [hashlib.sha256(Image[Offset : Offset + Chunk_Size]).digest() for Offset in range(0, len(Image), Chunk_Size)]
+    Fields = struct.pack('<III', IMAGE_MAGIC_MERKLE, BaseMemoryAddress, len(Image)) + Merkle_Root(Leaves) + struct.pack('<I', Chunk_Size)
+    return (Fields + hmac.new(IMAGE_MAC_KEY, Fields, hashlib.sha256).digest(), Leaves)
+
+def Send_Manifest_Part(Part, Data, Extended):
+    ''' header | cmd | part | data | crc32 (LE), returns the manifest status or None '''
+    Packet = bytearray([CBL_IMAGE_MANIFEST_CMD, Part]) + Data
+    if(Extended):
+        Frame = bytearray([0x00]) + struct.pack('<H', len(Packet) + 4) + Packet
+    else:
+        Frame = bytearray([len(Packet) + 4]) + Packet
+    CRC32_Value = Calculate_CRC32(Frame, len(Frame)) & 0xFFFFFFFF
+    Serial_Port_Obj.write(bytes([CBL_FRAME_SOF]) + bytes(Frame + struct.pack('<I', CRC32_Value)))
+    BL_ACK = Serial_Port_Obj.read(2)
+    Serial_Data = Serial_Port_Obj.read(BL_ACK[1]) if ((len(BL_ACK) == 2) and (BL_ACK[0] == 0x79)) else b''
+    if(len(Serial_Data) != 1):
+        Serial_Port_Obj.reset_input_buffer()
+        return None
+    return Serial_Data[0]
+
+def Send_Image_Manifest(Header, Leaves, Extended, Max_Packet):
+    ''' Header then the leaf hashes in as few frames as possible, returns the last status '''
+    Status = Send_Manifest_Part(MANIFEST_PART_HEADER, Header, 0)
+    Leaves_Per_Frame = (Max_Packet - 4) // 32
+    for First in range(0, len(Leaves), Leaves_Per_Frame):
+        if(Status is None) or (Status == 0x00):
+            break
+        Status = Send_Manifest_Part(MANIFEST_PART_LEAVES, struct.pack('<H', First) + b''.join(Leaves[First : First + Leaves_Per_Frame]), Extended)
+    return Status
+
+def Verify_Image():
+    ''' (status, cycles) of the bootloader image verification, None on NACK '''
+    Frame = bytearray([6 - 1, CBL_IMAGE_VERIFY_CMD])
+    CRC32_Value = Calculate_CRC32(Frame, len(Frame)) & 0xFFFFFFFF
+    Default_Timeout = Serial_Port_Obj.timeout
+    Serial_Port_Obj.timeout = IMAGE_VERIFY_TIMEOUT
+    Serial_Port_Obj.write(bytes([CBL_FRAME_SOF]) + bytes(Frame + struct.pack('<I', CRC32_Value)))
+    BL_ACK = Serial_Port_Obj.read(2)
+    Serial_Data = Serial_Port_Obj.read(BL_ACK[1]) if ((len(BL_ACK) == 2) and (BL_ACK[0] == 0x79)) else b''
+    Serial_Port_Obj.timeout = Default_Timeout
+    if(len(Serial_Data) != 5):
+        Serial_Port_Obj.reset_input_buffer()
+        return None
+    return (Serial_Data[0], struct.unpack('<I', Serial_Data[1:5])[0])
+
+def Build_Batch_Frame(Ops, Extended):
+    ''' header | cmd | op count | ops | crc32 (LE) '''
+    Packet = bytearray([CBL_BATCH_CMD, len(Ops)]) + b''.join(Ops)
+    if(Extended):
+        Frame = bytearray([0x00]) + struct.pack('<H', len(Packet) + 4) + Packet
+    else:
+        Frame = bytearray([len(Packet) + 4]) + Packet
+    CRC32_Value = Calculate_CRC32(Frame, len(Frame)) & 0xFFFFFFFF
+    return bytes([CBL_FRAME_SOF]) + bytes(Frame + struct.pack('<I', CRC32_Value))
+
+def Flash_Sectors_Of_Range(Address, Length):
+    ''' (first sector, number of sectors) covering the range, None outside of flash '''
+    Sectors = [Index for Index, (Base, Size) in enumerate(FLASH_SECTORS) if (Base < Address + Length) and (Address < Base + Size)]
+    if(not Sectors):
+        return None
+    return (Sectors[0], len(Sectors))
+
+def Batch_Flash_Bin_File(BaseMemoryAddress, File_Total_Len, Jump, Merkle = 0, Erase = 0):
+    ''' Erase, write, verify and optionally jump with as few round trips as frames allow.
+        Merkle: one chunk per write op, each checked by the bootloader against the manifest before it is programmed
+        Erase: erase ops for the image sectors, used when a write could not be programmed over the flash content '''
+    Frame_Mode = Set_Frame_Mode(FRAME_MODE_EXTENDED)
+    if((Frame_Mode is not None) and (Frame_Mode[0] == FRAME_MODE_EXTENDED)):
+        Extended = 1
+        Max_Packet = Frame_Mode[1] - BATCH_FRAME_OVERHEAD
+    else:
+        Serial_Port_Obj.reset_input_buffer()
+        Extended = 0
+        Max_Packet = 255 - 6
+    OpenBinFile()
+    Image = BinFile.read(File_Total_Len)
+    BinFile.close()
+    Sectors = Flash_Sectors_Of_Range(BaseMemoryAddress, File_Total_Len)
+    if(Sectors is None):
+        print("\n   Error !! Image is outside of the flash")
+        return 0
+    ''' The bootloader erases a sector before the first write of the session to it only when the data can't be
+        programmed over the flash content , a write that would need a second erase of a sector fails instead '''
+    Session_Digest()
+    Head_Ops = [bytes([BATCH_OP_ERASE, Sectors[0], Sectors[1]])] if Erase else []
+    Tail_Ops = [bytes([BATCH_OP_CHECK_SUM]) + struct.pack('<III', BaseMemoryAddress, File_Total_Len, Calculate_CRC32(Image, File_Total_Len) & 0xFFFFFFFF)]
+    Chunk_Size = 0
+    Is_Application = (BaseMemoryAddress == APPLICATION_BASE_ADDRESS) and (BaseMemoryAddress + File_Total_Len <= IMAGE_HEADER_ADDRESS)
+    if(Merkle and Is_Application):
+        ''' Chunk matches the frame, the bootloader writes the header itself after the last chunk '''
+        Chunk_Size = min(WINDOW_WRITE_PAYLOAD_EXT, Max_Packet - 7) & ~3
+        if((Chunk_Size < MERKLE_MIN_CHUNK) or ((File_Total_Len + Chunk_Size - 1) // Chunk_Size > MERKLE_MAX_LEAVES)):
+            print("\n   Error !! Frames too small for a chunked image of this size")
+            return 0
+        Header, Leaves = Build_Merkle_Header(BaseMemoryAddress, Image, Chunk_Size)
+        Head_Ops.append(bytes([BATCH_OP_ERASE, IMAGE_HEADER_SECTOR, 1]))
+        Status = Send_Image_Manifest(Header, Leaves, Extended, Max_Packet)
+        if(Status != MANIFEST_ACTIVE):
+            print("\n   Manifest", MANIFEST_STATUS_NAMES.get(Status, "not answered"), "by the bootloader")
+            return 0
+        print("   Manifest of", len(Leaves), "chunks of", Chunk_Size, "bytes accepted")
+    elif(Is_Application):
+        ''' An application gets its header once it is written and checked, the bootloader boots it after reset '''
+        Header = Build_Image_Header(BaseMemoryAddress, Image)
+        Tail_Ops.append(bytes([BATCH_OP_WRITE]) + struct.pack('<IH', IMAGE_HEADER_ADDRESS, len(Header)) + Write_Payload(IMAGE_HEADER_ADDRESS, Header))
+    if(Jump):
+        Tail_Ops.append(bytes([BATCH_OP_GO]) + struct.pack('<I', BaseMemoryAddress))
+    ''' Fill every frame up to its limit, writes are split at the frame boundary '''
+    Frames = []
+    Ops = list(Head_Ops)
+    Offset = 0
+    while(Offset < File_Total_Len):
+        Room = Max_Packet - sum(len(Op) for Op in Ops) - 7
+        if((Room <= 0) or (len(Ops) >= BATCH_MAX_OPS)):
+            Frames.append(Ops)
+            Ops = []
+            continue
+        Chunk = Image[Offset : Offset + (Chunk_Size if Chunk_Size else min(Room, WINDOW_WRITE_PAYLOAD_EXT))]
+        if(len(Chunk) > Room):
+            ''' chunks are never split '''
+            Frames.append(Ops)
+            Ops = []
+            continue
+        Ops.append(bytes([BATCH_OP_WRITE]) + struct.pack('<IH', BaseMemoryAddress + Offset, len(Chunk)) + Write_Payload(BaseMemoryAddress + Offset, Chunk))
+        Offset = Offset + len(Chunk)
+    for Op in Tail_Ops:
+        if((sum(len(Item) for Item in Ops) + len(Op) > Max_Packet) or (len(Ops) >= BATCH_MAX_OPS)):
+            Frames.append(Ops)
+            Ops = []
+        Ops.append(Op)
+    Frames.append(Ops)
+    print("   Flashing in", len(Frames), "batch frames")
+    Default_Timeout = Serial_Port_Obj.timeout
+    Serial_Port_Obj.timeout = BATCH_REPLY_TIMEOUT
+    Batch_Status = 1
+    Write_Failed = 0
+    for Frame_Index, Ops in enumerate(Frames):
+        Serial_Port_Obj.write(Build_Batch_Frame(Ops, Extended))
+        BL_ACK = Serial_Port_Obj.read(2)
+        if((len(BL_ACK) < 2) or (BL_ACK[0] != 0x79)):
+            print("\n   Batch frame", Frame_Index, "not acknowledged")
+            Batch_Status = 0
+            break
+        Status_Vector = Serial_Port_Obj.read(BL_ACK[1])
+        if((len(Status_Vector) != len(Ops)) or any(Status != 0x01 for Status in Status_Vector)):
+            print("\n   Batch frame", Frame_Index, "status :", [BATCH_STATUS_NAMES.get(Status, hex(Status)) for Status in Status_Vector])
+            Write_Failed = any((Status == 0x00) and (Op[0] == BATCH_OP_WRITE) for Op, Status in zip(Ops, Status_Vector))
+            Batch_Status = 0
+            break
+        print("\r   Batch frames done :{0}/{1}".format(Frame_Index + 1, len(Frames)), end = ' ')
+    Serial_Port_Obj.timeout = Default_Timeout
+    if(Write_Failed and (not Erase)):
+        print("\n   Erasing the image sectors and flashing again")
+        Batch_Status = Batch_Flash_Bin_File(BaseMemoryAddress, File_Total_Len, Jump, Merkle, 1)
+    return Batch_Status
+
+def Build_Change_Baud_Rate_Frame(Baud_Rate):
+    ''' len | cmd | baud rate (LE) | crc32 (LE) '''
+    Frame = bytearray(6)
+    Frame[0] = 10 - 1
+    Frame[1] = CBL_CHANGE_BAUD_RATE_CMD
+    Frame[2:6] = struct.pack('<I', Baud_Rate)
+    CRC32_Value = Calculate_CRC32(Frame, len(Frame)) & 0xFFFFFFFF
+    return bytes([CBL_FRAME_SOF]) + bytes(Frame + struct.pack('<I', CRC32_Value))
+
+def Read_Baud_Rate_Reply():
+    ''' returns the status byte or None on timeout / NACK '''
+    BL_ACK = Serial_Port_Obj.read(2)
+    if((len(BL_ACK) < 2) or (BL_ACK[0] != 0x79)):
+        return None
+    Serial_Data = Serial_Port_Obj.read(BL_ACK[1])
+    if(len(Serial_Data) < 1):
+        return None
+    return Serial_Data[0]
+
+def Change_Baud_Rate(Baud_Rate):
+    ''' Propose a rate, switch both sides and confirm it at the new rate '''
+    Old_Baud_Rate = Serial_Port_Obj.baudrate
+    Default_Timeout = Serial_Port_Obj.timeout
+    Serial_Port_Obj.timeout = BAUD_CONFIRM_TIMEOUT
+    Serial_Port_Obj.reset_input_buffer()
+    Serial_Port_Obj.write(Build_Change_Baud_Rate_Frame(Baud_Rate))
+    Status = Read_Baud_Rate_Reply()
+    if(Status == BAUD_CHANGE_ACCEPTED):
+        try:
+            Serial_Port_Obj.baudrate = Baud_Rate
+        except (ValueError, serial.SerialException):
+            ''' host adapter can't do it, let the bootloader time out and fall back '''
+            Status = None
+        if(Status is not None):
+            Serial_Port_Obj.write(Build_Change_Baud_Rate_Frame(Baud_Rate))
+            Status = Read_Baud_Rate_Reply()
+        if(Status != BAUD_CHANGE_CONFIRMED):
+            sleep(BAUD_CONFIRM_TIMEOUT)
+            Serial_Port_Obj.baudrate = Old_Baud_Rate
+            Serial_Port_Obj.reset_input_buffer()
+    Serial_Port_Obj.timeout = Default_Timeout
+    return (Status == BAUD_CHANGE_CONFIRMED)
+
+def Probe_Fastest_Baud_Rate():
+    ''' Try the candidates from the fastest one, keep the first rate confirmed by the bootloader '''
+    for Baud_Rate in BAUD_RATE_CANDIDATES:
+        if(Baud_Rate <= Serial_Port_Obj.baudrate):
+            break
+        print("   Trying ", Baud_Rate, " baud ...", end = ' ')
+        if(Change_Baud_Rate(Baud_Rate)):
+            print("stable")
+            break
+        print("failed")
+    print("\n   Link baud rate : ", Serial_Port_Obj.baudrate)
+
 def Decode_CBL_Command(Command):
     BL_Host_Buffer = []
     BL_Return_Value = 0
@@ -266,6 +1006,7 @@ def Decode_CBL_Command(Command):
         BL_Host_Buffer[3] = Word_Value_To_Byte_Value(CRC32_Value, 2, 1)
         BL_Host_Buffer[4] = Word_Value_To_Byte_Value(CRC32_Value, 3, 1)
         BL_Host_Buffer[5] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
+        Write_Data_To_Serial_Port(CBL_FRAME_SOF, 1)
         Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
         for Data in BL_Host_Buffer[1: CBL_GET_HELP_CMD_Len]:
             Write_Data_To_Serial_Port(Data, CBL_GET_HELP_CMD_Len - 1)
@@ -283,6 +1024,7 @@ def Decode_CBL_Command(Command):
         BL_Host_Buffer[3] = Word_Value_To_Byte_Value(CRC32_Value, 2, 1)
         BL_Host_Buffer[4] = Word_Value_To_Byte_Value(CRC32_Value, 3, 1)
         BL_Host_Buffer[5] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
+        Write_Data_To_Serial_Port(CBL_FRAME_SOF, 1)
         Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
         for Data in BL_Host_Buffer[1 : CBL_GET_VER_CMD_Len]:
             Write_Data_To_Serial_Port(Data, CBL_GET_VER_CMD_Len - 1)
@@ -298,6 +1040,7 @@ def Decode_CBL_Command(Command):
         BL_Host_Buffer[3] = Word_Value_To_Byte_Value(CRC32_Value, 2, 1)
         BL_Host_Buffer[4] = Word_Value_To_Byte_Value(CRC32_Value, 3, 1)
         BL_Host_Buffer[5] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
+        Write_Data_To_Serial_Port(CBL_FRAME_SOF, 1)
         Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
         for Data in BL_Host_Buffer[1 : CBL_GET_CID_CMD_Len]:
             Write_Data_To_Serial_Port(Data, CBL_GET_CID_CMD_Len - 1)
@@ -327,6 +1070,7 @@ def Decode_CBL_Command(Command):
             BL_Host_Buffer[9] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
             BL_Host_Buffer[10] = CBL_NO_OF_BYTES_TO_READ - 1
             BL_Host_Buffer[11] = 0xff ^ BL_Host_Buffer[10]
+            Write_Data_To_Serial_Port(CBL_FRAME_SOF, 1)
             Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
             for Data in BL_Host_Buffer[1 : CBL_READ_MEMORY_CMD_LEN]:
                 Write_Data_To_Serial_Port(Data, CBL_READ_MEMORY_CMD_LEN - 1)
@@ -348,6 +1092,7 @@ def Decode_CBL_Command(Command):
         BL_Host_Buffer[7] = Word_Value_To_Byte_Value(CRC32_Value, 2, 1)
         BL_Host_Buffer[8] = Word_Value_To_Byte_Value(CRC32_Value, 3, 1)
         BL_Host_Buffer[9] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
+        Write_Data_To_Serial_Port(CBL_FRAME_SOF, 1)
         Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
         for Data in BL_Host_Buffer[1 : CBL_GO_TO_ADDR_CMD_Len]:
             Write_Data_To_Serial_Port(Data, CBL_GO_TO_ADDR_CMD_Len - 1)
@@ -357,86 +1102,41 @@ def Decode_CBL_Command(Command):
         global Memory_Write_Is_Active
         global Memory_Write_All
         File_Total_Len = 0
-        BinFileRemainingBytes = 0
-        BinFileSentBytes = 0
         BaseMemoryAddress = 0
-        BinFileReadLength = 0
         Memory_Write_All = 1
         
         ''' Get the total length of the binary file '''
         File_Total_Len = CalulateBinFileLength()
         print("   Preparing writing a binary file with length (", File_Total_Len, ") Bytes")
-        ''' Open the binary file '''
-        OpenBinFile()
-        ''' Calculate the remaining payload '''
-        BinFileRemainingBytes = File_Total_Len - BinFileSentBytes
         ''' Get the start address to write the payload '''
         BaseMemoryAddress = input("\n   Enter the start address : ")
         BaseMemoryAddress = int(BaseMemoryAddress, 16)
-        ''' Keep sending the write packet till the last payload byte '''
-        while(BinFileRemainingBytes):
-            ''' Memory write is active '''
-            Memory_Write_Is_Active = 1
-            
-            ''' Read 128 bytes from the binary file each time '''
-            if(BinFileRemainingBytes >= 128):
-                BinFileReadLength = 128
-            else:
-                BinFileReadLength = BinFileRemainingBytes
-            
-            for BinFileByte in range(BinFileReadLength):
-                BinFileByteValue = BinFile.read(1)
-                BinFileByteValue = bytearray(BinFileByteValue)
-                BL_Host_Buffer[7 + BinFileByte] = int(BinFileByteValue[0])
-            
-            ''' Update the Host packet with the command code ID '''
-            BL_Host_Buffer[1] = CBL_WRITE_MEMORY_CMD
-        
-            ''' Update the Host packet with the base address '''
-            BL_Host_Buffer[2] = Word_Value_To_Byte_Value(BaseMemoryAddress, 1, 1)
-            BL_Host_Buffer[3] = Word_Value_To_Byte_Value(BaseMemoryAddress, 2, 1)
-            BL_Host_Buffer[4] = Word_Value_To_Byte_Value(BaseMemoryAddress, 3, 1)
-            BL_Host_Buffer[5] = Word_Value_To_Byte_Value(BaseMemoryAddress, 4, 1)
-            
-            ''' Update the Host packet with the payload length '''
-            BL_Host_Buffer[6] = BinFileReadLength
-            
-            ''' Update the Host packet with the packet length '''
-            CBL_MEM_WRITE_CMD_Len = (BinFileReadLength + 11)
-            BL_Host_Buffer[0] = CBL_MEM_WRITE_CMD_Len - 1
-            
-            ''' Update the Host packet with the calculated CRC32 '''
-            CRC32_Value = Calculate_CRC32(BL_Host_Buffer, CBL_MEM_WRITE_CMD_Len - 4) 
-            CRC32_Value = CRC32_Value & 0xFFFFFFFF
-            BL_Host_Buffer[7 + BinFileReadLength] = Word_Value_To_Byte_Value(CRC32_Value, 1, 1)
-            BL_Host_Buffer[8 + BinFileReadLength] = Word_Value_To_Byte_Value(CRC32_Value, 2, 1)
-            BL_Host_Buffer[9 + BinFileReadLength] = Word_Value_To_Byte_Value(CRC32_Value, 3, 1)
-            BL_Host_Buffer[10+ BinFileReadLength] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
-            
-            ''' Calculate the next Base memory address '''
-            BaseMemoryAddress = BaseMemoryAddress + BinFileReadLength
-            
-            ''' Send the packet length to the bootloader '''
-            Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
-            
-            ''' Send the complete packet to the bootloader '''
-            for Data in BL_Host_Buffer[1 : CBL_MEM_WRITE_CMD_Len]:
-                Write_Data_To_Serial_Port(Data, CBL_MEM_WRITE_CMD_Len - 1)
-            
-            ''' Update the total number of bytes sent to the bootloader '''
-            BinFileSentBytes = BinFileSentBytes + BinFileReadLength
-            
-            ''' Calculate the remaining payload '''
-            BinFileRemainingBytes = File_Total_Len - BinFileSentBytes
-            print("\n   Bytes sent to the bootloader :{0}".format(BinFileSentBytes))
-            
-            ''' Read the response from the bootloader '''
-            BL_Return_Value = Read_Data_From_Serial_Port(CBL_WRITE_MEMORY_CMD)
-            sleep(0.1)
+        Ask_Encrypted_Write()
+        ''' Memory write is active, a new write session digests every programmed payload '''
+        Memory_Write_Is_Active = 1
+        Session_Digest()
+        ''' Stream the file in sequence numbered frames without waiting for each reply '''
+        Memory_Write_All = Window_Write_Bin_File(BaseMemoryAddress, File_Total_Len)
+        if(Write_Nonce is not None):
+            Set_Write_Mode(WRITE_MODE_PLAIN)
         ''' Memory write is inactive '''
         Memory_Write_Is_Active = 0
         if(Memory_Write_All == 1):
             print("\n\n Payload Written Successfully")
+            OpenBinFile()
+            Image = BinFile.read(File_Total_Len)
+            BinFile.close()
+            Digest = Session_Digest()
+            if((Digest is not None) and (Digest[0] == File_Total_Len) and (Digest[1] == (Calculate_CRC32(Image, File_Total_Len) & 0xFFFFFFFF))):
+                print(" Payload Verified by the session digest")
+                if(Digest[2] is not None):
+                    print(" ", Digest[2], "of", Digest[0], "bytes programmed , the rest was already in flash")
+            elif(Verify_Bin_File(BaseMemoryAddress, File_Total_Len) == 1):
+                ''' digest covers the whole session (e.g. older writes), the image itself is intact '''
+                print(" Payload Verified by the bootloader check sum")
+        else:
+            ''' the bootloader erases a sector at most once per session , data it can't program over needs command 7 '''
+            print("\n   Write failed , erase the sectors of the range (command 7) and write again")
     elif (Command == 7):
         print("Mass erase or sector erase of the user flash command")              
         CBL_FLASH_ERASE_CMD_Len = 8
@@ -456,6 +1156,7 @@ def Decode_CBL_Command(Command):
         BL_Host_Buffer[5] = Word_Value_To_Byte_Value(CRC32_Value, 2, 1)
         BL_Host_Buffer[6] = Word_Value_To_Byte_Value(CRC32_Value, 3, 1)
         BL_Host_Buffer[7] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
+        Write_Data_To_Serial_Port(CBL_FRAME_SOF, 1)
         Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
         for Data in BL_Host_Buffer[1 : CBL_FLASH_ERASE_CMD_Len]:
             Write_Data_To_Serial_Port(Data, CBL_FLASH_ERASE_CMD_Len - 1)
@@ -491,6 +1192,7 @@ def Decode_CBL_Command(Command):
         BL_Host_Buffer[4+NumberOfSectors] = Word_Value_To_Byte_Value(CRC32_Value, 2, 1)
         BL_Host_Buffer[5+NumberOfSectors] = Word_Value_To_Byte_Value(CRC32_Value, 3, 1)
         BL_Host_Buffer[6+NumberOfSectors] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
+        Write_Data_To_Serial_Port(CBL_FRAME_SOF, 1)
         Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
         for Data in BL_Host_Buffer[1 : CBL_WRITE_PROTECT_CMD_Len]:
             Write_Data_To_Serial_Port(Data, CBL_WRITE_PROTECT_CMD_Len - 1)
@@ -510,6 +1212,7 @@ def Decode_CBL_Command(Command):
         BL_Host_Buffer[4+NumberOfSectors] = Word_Value_To_Byte_Value(CRC32_Value, 2, 1)
         BL_Host_Buffer[5+NumberOfSectors] = Word_Value_To_Byte_Value(CRC32_Value, 3, 1)
         BL_Host_Buffer[6+NumberOfSectors] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
+        Write_Data_To_Serial_Port(CBL_FRAME_SOF, 1)
         Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
         for Data in BL_Host_Buffer[1 : CBL_WRITE_PROTECT_CMD_Len]:
             Write_Data_To_Serial_Port(Data, CBL_WRITE_PROTECT_CMD_Len - 1)
@@ -525,6 +1228,7 @@ def Decode_CBL_Command(Command):
         BL_Host_Buffer[3] = Word_Value_To_Byte_Value(CRC32_Value, 2, 1)
         BL_Host_Buffer[4] = Word_Value_To_Byte_Value(CRC32_Value, 3, 1)
         BL_Host_Buffer[5] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
+        Write_Data_To_Serial_Port(CBL_FRAME_SOF, 1)
         Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
         for Data in BL_Host_Buffer[1 : CBL_GET_WRP_STATUS_CMD_Len]:
             Write_Data_To_Serial_Port(Data, CBL_GET_WRP_STATUS_CMD_Len - 1)
@@ -547,6 +1251,7 @@ def Decode_CBL_Command(Command):
             BL_Host_Buffer[4] = Word_Value_To_Byte_Value(CRC32_Value, 2, 1)
             BL_Host_Buffer[5] = Word_Value_To_Byte_Value(CRC32_Value, 3, 1)
             BL_Host_Buffer[6] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
+            Write_Data_To_Serial_Port(CBL_FRAME_SOF, 1)
             Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
             for Data in BL_Host_Buffer[1 : CBL_CHANGE_ROP_Level_CMD_Len]:
                 Write_Data_To_Serial_Port(Data, CBL_CHANGE_ROP_Level_CMD_Len - 1)
@@ -564,14 +1269,58 @@ def Decode_CBL_Command(Command):
         BL_Host_Buffer[3] = Word_Value_To_Byte_Value(CRC32_Value, 2, 1)
         BL_Host_Buffer[4] = Word_Value_To_Byte_Value(CRC32_Value, 3, 1)
         BL_Host_Buffer[5] = Word_Value_To_Byte_Value(CRC32_Value, 4, 1)
+        Write_Data_To_Serial_Port(CBL_FRAME_SOF, 1)
         Write_Data_To_Serial_Port(BL_Host_Buffer[0], 1)
         for Data in BL_Host_Buffer[1 : CBL_GET_RDP_STATUS_CMD_Len]:
             Write_Data_To_Serial_Port(Data, CBL_GET_RDP_STATUS_CMD_Len - 1)
         Read_Data_From_Serial_Port(CBL_READOUT_UNPROTECT_CMD)        
-        
+    elif (Command == 15):
+        print("Calculate the CRC of memory ranges on the bootloader")
+        Ranges = []
+        while(len(Ranges) < CHECK_SUM_MAX_RANGES):
+            Range = input("\n   Enter start address and length in hex (empty line to send) : ").split()
+            if(len(Range) != 2):
+                break
+            Ranges.append((int(Range[0], 16), int(Range[1], 16)))
+        if(Ranges):
+            Device_Crcs = Check_Sum_Ranges(Ranges)
+            if(Device_Crcs is None):
+                print("\n   Check sum refused, invalid range or CRC error")
+            else:
+                for (Address, Length), Device_Crc in zip(Ranges, Device_Crcs):
+                    print("   CRC of", hex(Address), "+", hex(Length), ":", hex(Device_Crc))
+    elif (Command == 16):
+        print("Probe the fastest stable baud rate of the bootloader link")
+        Probe_Fastest_Baud_Rate()
+    elif (Command == 17):
+        print("Flash the binary file with batch frames (erase, write, check sum, go)")
+        File_Total_Len = CalulateBinFileLength()
+        BaseMemoryAddress = int(input("\n   Enter the start address : "), 16)
+        Jump = input("\n   Jump to the application after flashing (y/n) : ").strip().lower() == 'y'
+        Ask_Encrypted_Write()
+        Merkle = (BaseMemoryAddress == APPLICATION_BASE_ADDRESS) and \
+                 (input("\n   Authenticate every chunk while flashing (Y/n , n only boots with BL_IMAGE_AUTH disabled) : ").strip().lower() != 'n')
+        Batch_Status = Batch_Flash_Bin_File(BaseMemoryAddress, File_Total_Len, Jump, Merkle)
+        if((Write_Nonce is not None) and (not Jump)):
+            Set_Write_Mode(WRITE_MODE_PLAIN)
+        if(Batch_Status == 1):
+            print("\n\n Image Flashed and Verified Successfully")
+            if((not Jump) and (BaseMemoryAddress == APPLICATION_BASE_ADDRESS)):
+                Image_Status = Verify_Image()
+                if((Image_Status is not None) and (Image_Status[0] == IMAGE_VALID)):
+                    print(" Boot verification (SHA-256) passes in {0} cycles ({1:.2f} ms)".format(Image_Status[1], Image_Status[1] * 1000.0 / HCLK_FREQUENCY))
+                else:
+                    print(" Boot verification failed, the bootloader will not start the image")
+
 
-SerialPortName = input("Enter the Port Name of your device( Ex: COM3 ):")
-Serial_Port_Configuration(SerialPortName)
+SerialPortName = input("Enter the Port Name of your device( Ex: COM3 or udp:192.168.0.10 ):")
+if SerialPortName.startswith('udp:'):
+    Udp_Link_Configuration(SerialPortName)
+else:
+    Serial_Port_Configuration(SerialPortName)
+    Auto_Baud_Sync()
+if(Set_Crc_Mode(CRC_MODE_STANDARD) == CRC_MODE_STANDARD):
+    print("Frame CRC : CRC-32 (word wide on the bootloader) \n")
         
 while True:
     print("\nSTM32F756ZG Custome BootLoader")
@@ -592,6 +1341,8 @@ while True:
     print("   CBL_READOUT_PROTECT_CMD           --> 13")
     print("   CBL_READOUT_UNPROTECT_CMD         --> 14")
     print("   CBL_CHECK_SUM_CMD                 --> 15")
+    print("   CBL_CHANGE_BAUD_RATE_CMD          --> 16")
+    print("   CBL_BATCH_CMD (flash image)       --> 17")
 
     
     CBL_Command = input("\nEnter the command code : ")